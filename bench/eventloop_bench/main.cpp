@@ -0,0 +1,158 @@
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+
+#include <time.h>
+
+#include <librnp/default_packets/simplecommandpacket.h>
+#include <librnp/rnp_eventloop.h>
+#include <librnp/rnp_networkmanager.h>
+#include <librnp/rnp_routingtable.h>
+#include <librnp/udpinterface.h>
+
+// Event loop benchmark: node A sends bursts of packets over 127.0.0.1 to a
+// service on node B, which runs on its own thread either by calling update()
+// continuously or with an RnpEventLoop. A keeps at most a window of packets
+// in flight so neither runner drops datagrams. The CPU time used by B's
+// thread is then measured while the link is idle.
+
+static constexpr size_t iterations = 200000;
+static constexpr size_t burst = 32;
+static constexpr size_t window = 256;
+static constexpr auto idleTime = std::chrono::milliseconds(500);
+
+static constexpr uint8_t nodeA = 1;
+static constexpr uint8_t nodeB = 2;
+static constexpr uint8_t udpID = 2;
+static constexpr uint8_t benchService = 10;
+
+// CPU time used by the calling thread in seconds
+static double threadCpuTime()
+{
+    timespec time;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time);
+    return time.tv_sec + time.tv_nsec / 1e9;
+}
+
+static bool run(const char *name, const bool eventLoop)
+{
+    RnpNetworkManager netmanA(nodeA, NODETYPE::LEAF, false, 256, 64);
+    RnpNetworkManager netmanB(nodeB, NODETYPE::LEAF, false, 256, 64);
+    UdpInterface udpA(udpID, "127.0.0.1:0", "udpA");
+    UdpInterface udpB(udpID, "127.0.0.1:0", "udpB");
+    udpA.setup();
+    udpB.setup();
+    netmanA.addInterface(&udpA);
+    netmanB.addInterface(&udpB);
+    netmanA.setRoutingBudget(0);
+    netmanB.setRoutingBudget(0);
+
+    RoutingTable table;
+    table.setRoute(nodeB, Route{udpID, 1,
+                                "127.0.0.1:" + std::to_string(udpB.getPort())});
+    netmanA.setRoutingTable(table);
+
+    std::atomic<size_t> received{0};
+    netmanB.registerService(benchService, [&received](packetptr_t)
+    {
+        received.fetch_add(1, std::memory_order_release);
+    });
+
+    // Run B, measuring its CPU time while idle once A has finished
+    RnpEventLoop loop(netmanB);
+    std::atomic<bool> idle{false};
+    std::atomic<bool> stop{false};
+    double idleCpu = 0;
+    std::thread runner([&]
+    {
+        double idleStart = 0;
+        bool measuring = false;
+        while (!stop.load(std::memory_order_acquire))
+        {
+            if (!measuring && idle.load(std::memory_order_acquire))
+            {
+                measuring = true;
+                idleStart = threadCpuTime();
+            }
+            if (eventLoop)
+            {
+                loop.runOnce();
+            }
+            else
+            {
+                netmanB.update();
+            }
+        }
+        idleCpu = threadCpuTime() - idleStart;
+    });
+
+    SimpleCommandPacket packet(1, 1234);
+    packet.header.source = nodeA;
+    packet.header.destination = nodeB;
+    packet.header.destination_service = benchService;
+
+    const auto t0 = std::chrono::steady_clock::now();
+
+    for (size_t sent = 0; sent < iterations;)
+    {
+        // Wait for B to catch up
+        while (sent - received.load(std::memory_order_acquire) > window)
+        {
+            std::this_thread::yield();
+        }
+
+        for (size_t j = 0; j < burst; j++)
+        {
+            // Reset the hop count, which sendPacket() increments
+            packet.header.hops = 0;
+            netmanA.sendPacket(packet);
+        }
+        netmanA.update();
+        sent += burst;
+    }
+
+    // Wait for the last packets, giving up if any were lost
+    const auto deadline = std::chrono::steady_clock::now() +
+                          std::chrono::seconds(1);
+    while (received.load(std::memory_order_acquire) < iterations &&
+           std::chrono::steady_clock::now() < deadline)
+    {
+        std::this_thread::yield();
+    }
+
+    const auto t1 = std::chrono::steady_clock::now();
+    const double seconds = std::chrono::duration<double>(t1 - t0).count();
+    const size_t count = received.load();
+
+    // Measure B while the link is idle
+    idle.store(true, std::memory_order_release);
+    loop.wake();
+    std::this_thread::sleep_for(idleTime);
+    stop.store(true, std::memory_order_release);
+    loop.wake();
+    runner.join();
+
+    const double idleSeconds =
+        std::chrono::duration<double>(idleTime).count();
+    std::printf("%-10s %8.2f Mpackets/s %8.1f ns/packet %6.1f %% idle CPU\n",
+                name, count / seconds / 1e6, seconds * 1e9 / count,
+                100.0 * idleCpu / idleSeconds);
+
+    return count > iterations * 9 / 10;
+}
+
+int main()
+{
+    const bool spinOk = run("spin", false);
+    const bool loopOk = run("eventloop", true);
+
+    if (!spinOk || !loopOk)
+    {
+        std::printf("FAILED\n");
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,144 @@
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+#include <librnp/default_packets/simplecommandpacket.h>
+#include <librnp/rnp_interface.h>
+#include <librnp/rnp_networkmanager.h>
+#include <librnp/rnp_routingtable.h>
+
+// Forwarding throughput benchmark: a HUB node sits between two mock
+// interfaces, every packet received on the ingress interface is addressed to
+// a node behind the egress interface and is forwarded by update().
+
+static constexpr size_t iterations = 2000000;
+
+static constexpr uint8_t hubAddress = 1;
+static constexpr uint8_t remoteAddress = 5;
+
+static constexpr uint8_t ingressID = 2;
+static constexpr uint8_t egressID = 3;
+
+class IngressInterface : public RnpInterface
+{
+public:
+    IngressInterface() : RnpInterface(ingressID, "Ingress"){};
+
+    void setup() override{};
+
+    void update() override{};
+
+    void sendPacket(RnpPacket &data) override{};
+
+    const RnpInterfaceInfo *getInfo() override { return &info; };
+
+    // Receive serialized bytes as a driver would
+    void receive(const RnpBufferView bytes)
+    {
+        packetptr_t packet_ptr = createPacket(bytes);
+        packet_ptr->header.src_iface = getID();
+        _packetBuffer->push(std::move(packet_ptr));
+    };
+
+private:
+    RnpInterfaceInfo info;
+};
+
+class EgressInterface : public RnpInterface
+{
+public:
+    // If useWire is false, the serialized bytes are ignored, as for an
+    // interface which only implements sendPacket(RnpPacket &)
+    EgressInterface(bool useWire) : RnpInterface(egressID, "Egress"), _useWire(useWire){};
+
+    void setup() override{};
+
+    void update() override{};
+
+    void sendPacket(RnpPacket &data) override
+    {
+        _txBuffer.clear();
+        data.serialize(_txBuffer);
+        transmit(_txBuffer.data(), _txBuffer.size());
+    };
+
+    void sendPacket(RnpPacket &data, const RnpWireBuffer &wire) override
+    {
+        if (!_useWire)
+        {
+            sendPacket(data);
+            return;
+        }
+        transmit(wire.data(), wire.size());
+    };
+
+    const RnpInterfaceInfo *getInfo() override { return &info; };
+
+    size_t sent = 0;
+
+    size_t lastHops = 0;
+
+private:
+    void transmit(const uint8_t *data, size_t len)
+    {
+        lastHops = data[RnpHeader::hopsOffset()];
+        sent++;
+    };
+
+    const bool _useWire;
+
+    std::vector<uint8_t> _txBuffer;
+
+    RnpInterfaceInfo info;
+};
+
+static bool run(const char *name, bool useWire)
+{
+    RnpNetworkManager netman(hubAddress, NODETYPE::HUB, false, 200, 8);
+    IngressInterface ingress;
+    EgressInterface egress(useWire);
+    netman.addInterface(&ingress);
+    netman.addInterface(&egress);
+    netman.setRoutingBudget(0);
+
+    RoutingTable table;
+    table.setRoute(remoteAddress, Route{egressID, 1, "remote"});
+    netman.setRoutingTable(table);
+
+    // Packet from a node behind the ingress interface to the remote node
+    SimpleCommandPacket packet(1, 1234);
+    packet.header.source = 4;
+    packet.header.destination = remoteAddress;
+    std::vector<uint8_t> bytes;
+    packet.serialize(bytes);
+
+    const auto t0 = std::chrono::steady_clock::now();
+
+    for (size_t i = 0; i < iterations; i++)
+    {
+        ingress.receive(bytes);
+        netman.update();
+    }
+
+    const auto t1 = std::chrono::steady_clock::now();
+    const double seconds = std::chrono::duration<double>(t1 - t0).count();
+
+    std::printf("%-12s %10.2f Mpackets/s %8.1f ns/packet\n", name,
+                iterations / seconds / 1e6, seconds * 1e9 / iterations);
+
+    return (egress.sent == iterations) && (egress.lastHops == 1);
+}
+
+int main()
+{
+    const bool wireOk = run("wire", true);
+    const bool serializeOk = run("serialize", false);
+
+    if (!wireOk || !serializeOk)
+    {
+        std::printf("FAILED\n");
+        return 1;
+    }
+
+    return 0;
+}
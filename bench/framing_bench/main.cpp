@@ -0,0 +1,100 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include <librnp/rnp_framing.h>
+
+// Framing throughput benchmark: a stream of COBS frames holding random,
+// packet sized payloads is encoded once, then fed repeatedly through a
+// deframer in random sized chunks, as reads from a socket or serial port
+// would deliver it. Every frame must be recovered with its CRC intact.
+
+static constexpr size_t streamBytes = 16 * 1024 * 1024;
+static constexpr size_t passes = 16;
+static constexpr size_t maxPayload = 1024;
+static constexpr size_t maxChunk = 4096;
+
+int main()
+{
+    std::mt19937 rng(1);
+
+    // Generate a pool of payloads so the generator is not timed
+    std::vector<std::vector<uint8_t>> payloads(256);
+    for (auto &payload : payloads)
+    {
+        payload.resize(1 + rng() % maxPayload);
+        for (auto &byte : payload)
+        {
+            // Bias towards zero, as small integer fields in headers are
+            byte = (rng() % 4 == 0) ? 0 : static_cast<uint8_t>(rng());
+        }
+    }
+
+    // Encode the stream
+    std::vector<uint8_t> stream;
+    stream.reserve(streamBytes + RnpFraming::maxEncodedSize(maxPayload));
+    size_t payloadBytes = 0;
+    size_t frames = 0;
+
+    const auto e0 = std::chrono::steady_clock::now();
+    while (stream.size() < streamBytes)
+    {
+        const auto &payload = payloads[frames % payloads.size()];
+        RnpFraming::encode(payload, stream);
+        payloadBytes += payload.size();
+        frames++;
+    }
+    const auto e1 = std::chrono::steady_clock::now();
+    const double encodeSeconds = std::chrono::duration<double>(e1 - e0).count();
+
+    // Pick the chunk sizes up front so the generator is not timed
+    std::vector<size_t> chunks;
+    for (size_t offset = 0; offset < stream.size();)
+    {
+        const size_t chunk = 1 + rng() % maxChunk;
+        chunks.push_back(chunk);
+        offset += chunk;
+    }
+
+    RnpDeframer deframer(maxPayload);
+    size_t decoded = 0;
+    size_t decodedBytes = 0;
+
+    const auto d0 = std::chrono::steady_clock::now();
+    for (size_t pass = 0; pass < passes; pass++)
+    {
+        size_t offset = 0;
+        for (const size_t chunk : chunks)
+        {
+            const size_t length = std::min(chunk, stream.size() - offset);
+            deframer.feed(RnpBufferView(stream.data() + offset, length),
+                          [&](const RnpBufferView frame)
+                          {
+                              decoded++;
+                              decodedBytes += frame.size();
+                          });
+            offset += length;
+        }
+    }
+    const auto d1 = std::chrono::steady_clock::now();
+    const double decodeSeconds = std::chrono::duration<double>(d1 - d0).count();
+
+    const double streamMB = static_cast<double>(stream.size()) / 1e6;
+    std::printf("encode   %8.1f MB/s %8.2f Mframes/s\n",
+                streamMB / encodeSeconds, frames / encodeSeconds / 1e6);
+    std::printf("deframe  %8.1f MB/s %8.2f Mframes/s %8.1f MB total\n",
+                streamMB * passes / decodeSeconds,
+                frames * passes / decodeSeconds / 1e6, streamMB * passes);
+
+    if ((decoded != frames * passes) ||
+        (decodedBytes != payloadBytes * passes) || (deframer.errors() != 0))
+    {
+        std::printf("FAILED\n");
+        return 1;
+    }
+
+    return 0;
+}
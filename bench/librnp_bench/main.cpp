@@ -0,0 +1,411 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <librnp/default_packets/simplecommandpacket.h>
+#include <librnp/rnp_columnarlog.h>
+#include <librnp/rnp_header.h>
+#include <librnp/rnp_interface.h>
+#include <librnp/rnp_netman_packets.h>
+#include <librnp/rnp_networkmanager.h>
+#include <librnp/rnp_packet.h>
+#include <librnp/rnp_routingtable.h>
+#include <librnp/rnp_serializer.h>
+#include "allocationCounter.h"
+
+// Library benchmark suite: times serialization, stringify, routing and
+// broadcast fan-out, reporting ns/op, packets/s and heap allocations/op.
+//
+// Usage: librnp_bench [filter], only cases whose name contains filter run.
+
+// Keep a result alive so the compiler cannot drop the work producing it
+template <typename T>
+static void doNotOptimize(const T &value)
+{
+    asm volatile("" : : "r"(&value) : "memory");
+}
+
+static const char *filter = nullptr;
+
+/**
+ * @brief Time a benchmark case
+ *
+ * @param name Case name
+ * @param iterations Number of operations
+ * @param packetsPerOp Packets handled by each operation, for packets/s
+ * @param op Operation, called with the iteration index
+ */
+template <typename OP>
+static void run(const char *name, const size_t iterations, const size_t packetsPerOp, OP op)
+{
+    if (filter != nullptr && std::strstr(name, filter) == nullptr)
+    {
+        return;
+    }
+
+    // Warm up caches, pools and reserved buffers before timing
+    for (size_t i = 0; i < iterations / 10; i++)
+    {
+        op(i);
+    }
+
+    const size_t allocations = allocationCount;
+    const auto t0 = std::chrono::steady_clock::now();
+
+    for (size_t i = 0; i < iterations; i++)
+    {
+        op(i);
+    }
+
+    const auto t1 = std::chrono::steady_clock::now();
+    const double seconds = std::chrono::duration<double>(t1 - t0).count();
+
+    std::printf("%-28s %10.1f %12.2f %10.2f\n", name, seconds * 1e9 / iterations,
+                iterations * packetsPerOp / seconds / 1e6,
+                static_cast<double>(allocationCount - allocations) / iterations);
+}
+
+/**
+ * @brief Interface driven by the benchmark, receiving serialized bytes and
+ * discarding what is sent
+ */
+class BenchInterface : public RnpInterface
+{
+public:
+    BenchInterface(const uint8_t id) : RnpInterface(id, "BenchInterface"){};
+
+    void setup() override{};
+
+    void update() override{};
+
+    void sendPacket(RnpPacket &data) override
+    {
+        _txBuffer.clear();
+        data.serialize(_txBuffer);
+        sent++;
+    };
+
+    void sendPacket(RnpPacket &data, const RnpWireBuffer &wire) override
+    {
+        doNotOptimize(wire.data()[0]);
+        sent++;
+    };
+
+    const RnpInterfaceInfo *getInfo() override { return &info; };
+
+    // Receive serialized bytes as a driver would
+    void receive(const RnpBufferView bytes)
+    {
+        packetptr_t packet_ptr = createPacket(bytes);
+        packet_ptr->header.src_iface = getID();
+        _packetBuffer->push(std::move(packet_ptr));
+    };
+
+    size_t sent = 0;
+
+private:
+    std::vector<uint8_t> _txBuffer;
+
+    RnpInterfaceInfo info;
+};
+
+/**
+ * @brief Telemetry frame, as logged by the flight software
+ */
+class TelemetryFrame
+{
+public:
+    static constexpr auto getSerializer()
+    {
+        auto ret = RnpSerializer(
+            &TelemetryFrame::ch0, &TelemetryFrame::ch1, &TelemetryFrame::ch2,
+            &TelemetryFrame::ch3, &TelemetryFrame::ch4, &TelemetryFrame::ch5,
+            &TelemetryFrame::temp0, &TelemetryFrame::temp1,
+            &TelemetryFrame::state, &TelemetryFrame::timestamp);
+        return ret;
+    }
+
+    float ch0, ch1, ch2, ch3, ch4, ch5;
+
+    float temp0, temp1;
+
+    uint8_t state;
+
+    uint64_t timestamp;
+
+    std::string stringify() const { return getSerializer().stringify(*this); };
+
+    void stringify(std::string &out) const { getSerializer().stringify(*this, out); };
+
+    template <class IT>
+    static void stringify(IT first, IT last, std::string &out)
+    {
+        getSerializer().stringify_batch(first, last, out);
+    }
+};
+
+/**
+ * @brief Flight computer log frame with 17 fields
+ */
+class LogFrame
+{
+public:
+    static constexpr auto getSerializer()
+    {
+        auto ret = RnpSerializer(
+            &LogFrame::ch0, &LogFrame::ch1, &LogFrame::ch2, &LogFrame::ch3,
+            &LogFrame::ch4, &LogFrame::ch5, &LogFrame::ch6, &LogFrame::ch7,
+            &LogFrame::ch8, &LogFrame::ch9, &LogFrame::ch10, &LogFrame::ch11,
+            &LogFrame::temp0, &LogFrame::temp1, &LogFrame::temp2,
+            &LogFrame::temp3, &LogFrame::timestamp);
+        return ret;
+    }
+
+    float ch0, ch1, ch2, ch3, ch4, ch5, ch6, ch7, ch8, ch9, ch10, ch11;
+
+    float temp0, temp1, temp2, temp3;
+
+    uint64_t timestamp;
+};
+
+static constexpr uint8_t localAddress = 1;
+static constexpr uint8_t remoteAddress = 5;
+static constexpr uint8_t benchService = 10;
+
+static void benchSerialization()
+{
+    std::vector<uint8_t> buffer;
+    buffer.reserve(256);
+    alignas(64) uint8_t bytes[256];
+
+    // Header
+    RnpHeader header(benchService, 1, 8);
+    header.source = localAddress;
+    header.destination = remoteAddress;
+
+    run("header/serialize", 10000000, 1, [&](size_t i) {
+        header.uid = static_cast<uint16_t>(i);
+        doNotOptimize(header.serialize(bytes));
+    });
+
+    run("header/deserialize", 10000000, 1, [&](size_t) {
+        RnpHeader decoded(RnpBufferView(bytes, RnpHeader::size()));
+        doNotOptimize(decoded);
+    });
+
+    // Frame made of fields of the same size, serialized without a packet
+    LogFrame frame{};
+    LogFrame decodedFrame{};
+
+    run("frame17/serialize", 10000000, 1, [&](size_t i) {
+        frame.timestamp = i;
+        doNotOptimize(LogFrame::getSerializer().serializeInto(frame, bytes));
+    });
+
+    run("frame17/deserialize", 10000000, 1, [&](size_t) {
+        LogFrame::getSerializer().deserialize(decodedFrame, bytes,
+                                              LogFrame::getSerializer().member_size());
+        doNotOptimize(decodedFrame);
+    });
+
+    // Packets serialized and deserialized again
+    using BenchDataPacket = BasicDataPacket<uint64_t, benchService, 1>;
+    BenchDataPacket data(0);
+
+    run("packet/basicdata", 2000000, 1, [&](size_t i) {
+        data.data = i;
+        buffer.clear();
+        data.serialize(buffer);
+        RnpPacketSerialized serialized(buffer);
+        BenchDataPacket decoded(serialized);
+        doNotOptimize(decoded.data);
+    });
+
+    using BenchMessagePacket = MessagePacket_Base<benchService, 2>;
+    BenchMessagePacket message("Telemetry link nominal, all systems go");
+
+    run("packet/message", 2000000, 1, [&](size_t) {
+        buffer.clear();
+        message.serialize(buffer);
+        RnpPacketSerialized serialized(buffer);
+        BenchMessagePacket decoded(serialized);
+        doNotOptimize(decoded._msg);
+    });
+
+    SetRoutePacket route(remoteAddress, Route{2, 1, "192.168.1.5"});
+
+    run("packet/setroute", 2000000, 1, [&](size_t) {
+        buffer.clear();
+        route.serialize(buffer);
+        RnpPacketSerialized serialized(buffer);
+        SetRoutePacket decoded(serialized);
+        doNotOptimize(decoded.destination);
+    });
+}
+
+static void benchStringify()
+{
+    TelemetryFrame frame{1.5f, -2.25f, 3.0f, 400.125f, 5e-3f, 6e7f,
+                         21.5f, 22.75f, 3, 1234567890123};
+
+    run("stringify/stringstream", 500000, 1, [&](size_t i) {
+        frame.timestamp = i;
+        const std::string line = frame.stringify();
+        doNotOptimize(line);
+    });
+
+    std::string out;
+
+    run("stringify/to_chars", 2000000, 1, [&](size_t i) {
+        frame.timestamp = i;
+        out.clear();
+        frame.stringify(out);
+        doNotOptimize(out);
+    });
+
+    // A block of frames per operation, packets/s counts frames
+    static constexpr size_t batchSize = 64;
+    std::vector<TelemetryFrame> frames(batchSize, frame);
+
+    run("stringify/batch64", 50000, batchSize, [&](size_t i) {
+        frames[i % batchSize].timestamp = i;
+        out.clear();
+        TelemetryFrame::stringify(frames.begin(), frames.end(), out);
+        doNotOptimize(out);
+    });
+}
+
+static void benchLogging()
+{
+    TelemetryFrame frame{1.5f, -2.25f, 3.0f, 400.125f, 5e-3f, 6e7f,
+                         21.5f, 22.75f, 3, 1234567890123};
+
+    // Write to the null device, so only the formatting and buffering count
+    std::FILE *file = std::fopen("/dev/null", "wb");
+    if (file == nullptr)
+    {
+        return;
+    }
+
+    std::string line;
+
+    run("log/csv", 2000000, 1, [&](size_t i) {
+        frame.timestamp = i;
+        line.clear();
+        frame.stringify(line);
+        line.push_back('\n');
+        std::fwrite(line.data(), 1, line.size(), file);
+    });
+
+    {
+        RnpColumnarLogWriter writer(file, TelemetryFrame::getSerializer());
+
+        run("log/columnar", 10000000, 1, [&](size_t i) {
+            frame.timestamp = i;
+            writer.append(frame);
+        });
+        writer.flush();
+    }
+
+    std::fclose(file);
+}
+
+static void benchRouting()
+{
+    // LEAF node delivering received packets to a local service
+    {
+        RnpNetworkManager netman(localAddress, NODETYPE::LEAF, false, 200, 8);
+        BenchInterface iface(2);
+        netman.addInterface(&iface);
+        netman.setRoutingBudget(0);
+
+        size_t delivered = 0;
+        netman.registerService(benchService, [&delivered](packetptr_t packet_ptr) { delivered++; });
+
+        SimpleCommandPacket packet(1, 1234);
+        packet.header.source = remoteAddress;
+        packet.header.destination = localAddress;
+        packet.header.destination_service = benchService;
+        std::vector<uint8_t> bytes;
+        packet.serialize(bytes);
+
+        run("route/leaf", 2000000, 1, [&](size_t) {
+            iface.receive(bytes);
+            netman.update();
+        });
+    }
+
+    // HUB node forwarding received packets out of another interface
+    {
+        RnpNetworkManager netman(localAddress, NODETYPE::HUB, false, 200, 8);
+        BenchInterface ingress(2);
+        BenchInterface egress(3);
+        netman.addInterface(&ingress);
+        netman.addInterface(&egress);
+        netman.setRoutingBudget(0);
+
+        RoutingTable table;
+        table.setRoute(remoteAddress, Route{3, 1, "remote"});
+        netman.setRoutingTable(table);
+
+        SimpleCommandPacket packet(1, 1234);
+        packet.header.source = 4;
+        packet.header.destination = remoteAddress;
+        std::vector<uint8_t> bytes;
+        packet.serialize(bytes);
+
+        run("route/hub", 2000000, 1, [&](size_t) {
+            ingress.receive(bytes);
+            netman.update();
+        });
+    }
+
+    // Broadcast fan-out of locally originated packets over several interfaces
+    {
+        static constexpr uint8_t fanout = 4;
+
+        RnpNetworkManager netman(localAddress, NODETYPE::LEAF, false, 200, 8);
+        std::vector<BenchInterface> ifaces;
+        ifaces.reserve(fanout);
+        std::vector<uint8_t> ifaceIDs;
+        for (uint8_t i = 0; i < fanout; i++)
+        {
+            ifaces.emplace_back(static_cast<uint8_t>(2 + i));
+            ifaceIDs.push_back(static_cast<uint8_t>(2 + i));
+        }
+        for (auto &iface : ifaces)
+        {
+            netman.addInterface(&iface);
+        }
+        netman.setNoRouteAction(NOROUTE_ACTION::BROADCAST, ifaceIDs);
+
+        SimpleCommandPacket packet(1, 1234);
+        packet.header.source = localAddress;
+        packet.header.destination = remoteAddress;
+
+        run("broadcast/fanout4", 2000000, fanout, [&](size_t) {
+            packet.header.hops = 0;
+            netman.sendPacket(packet);
+        });
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc > 1)
+    {
+        filter = argv[1];
+    }
+
+    std::printf("%-28s %10s %12s %10s\n", "case", "ns/op", "Mpackets/s", "allocs/op");
+
+    benchSerialization();
+    benchStringify();
+    benchLogging();
+    benchRouting();
+
+    return 0;
+}
@@ -0,0 +1,130 @@
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <librnp/rnp_networkmanager.h>
+
+// Packet buffer contention benchmark: N producer threads push packets into the
+// network manager's packet buffer while a single consumer drains it, comparing
+// the lock-free MPSC ring against a mutex protected queue.
+
+static constexpr size_t totalPackets = 4000000;
+static constexpr size_t bufferSize = 1024;
+
+struct BenchResult
+{
+    double seconds;
+    size_t rejected;
+};
+
+template <typename PUSH, typename POP>
+BenchResult runContention(const size_t producers, PUSH push, POP pop)
+{
+    std::atomic<bool> start{false};
+    std::atomic<size_t> rejected{0};
+    std::vector<std::thread> threads;
+
+    const size_t perProducer = totalPackets / producers;
+
+    for (size_t p = 0; p < producers; p++)
+    {
+        threads.emplace_back([&]() {
+            while (!start.load(std::memory_order_acquire))
+            {
+                std::this_thread::yield();
+            }
+            size_t localRejected = 0;
+            for (size_t i = 0; i < perProducer; i++)
+            {
+                // retry until the consumer makes space, as an interface would
+                // have to if it did not want to drop the packet
+                while (!push())
+                {
+                    localRejected++;
+                    std::this_thread::yield();
+                }
+            }
+            rejected.fetch_add(localRejected, std::memory_order_relaxed);
+        });
+    }
+
+    const size_t expected = perProducer * producers;
+    size_t consumed = 0;
+
+    const auto t0 = std::chrono::steady_clock::now();
+    start.store(true, std::memory_order_release);
+
+    while (consumed < expected)
+    {
+        if (pop())
+        {
+            consumed++;
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    const auto t1 = std::chrono::steady_clock::now();
+
+    for (auto &t : threads)
+    {
+        t.join();
+    }
+
+    return {std::chrono::duration<double>(t1 - t0).count(), rejected.load()};
+}
+
+static void report(const char *name, const size_t producers, const BenchResult &result)
+{
+    const double packets = static_cast<double>(totalPackets / producers * producers);
+    std::printf("%-12s %9zu %12.2f %10.1f %12zu\n", name, producers,
+                packets / result.seconds / 1e6, result.seconds * 1e9 / packets, result.rejected);
+}
+
+int main()
+{
+    std::printf("%-12s %9s %12s %10s %12s\n", "buffer", "producers", "Mpackets/s", "ns/packet", "full-retries");
+
+    for (size_t producers : {1, 2, 4, 8})
+    {
+        // lock-free ring
+        {
+            Rnp_MPSCRingBuffer<packetptr_t> ring(bufferSize);
+            packetBufferInterface_t buffer(ring, bufferSize);
+            packetptr_t out;
+
+            auto result = runContention(
+                producers,
+                [&]() { return buffer.push(packetptr_t()); },
+                [&]() { return buffer.pop(out); });
+            report("mpsc_ring", producers, result);
+        }
+
+        // mutex protected queue
+        {
+            packetBuffer_t queue{Rnp_CircularBuffer<packetptr_t>(bufferSize)};
+            packetBufferInterface_t buffer(queue, bufferSize);
+            std::mutex mutex;
+            packetptr_t out;
+
+            auto result = runContention(
+                producers,
+                [&]() {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    return buffer.push(packetptr_t());
+                },
+                [&]() {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    return buffer.pop(out);
+                });
+            report("mutex_queue", producers, result);
+        }
+    }
+
+    return 0;
+}
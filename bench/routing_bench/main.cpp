@@ -0,0 +1,104 @@
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+#include <librnp/default_packets/simplecommandpacket.h>
+#include <librnp/rnp_interface.h>
+#include <librnp/rnp_networkmanager.h>
+#include <librnp/rnp_routingtable.h>
+
+// Route resolution benchmark: sendPacket() is called for destinations spread
+// over a full routing table, each route carrying a link layer address, with
+// an interface which only records the address it was handed.
+
+static constexpr size_t iterations = 10000000;
+static constexpr uint8_t ifaceID = 2;
+
+class NullInterface : public RnpInterface
+{
+public:
+    NullInterface() : RnpInterface(ifaceID, "NullInterface"){};
+
+    void setup() override{};
+
+    void update() override{};
+
+    void sendPacket(RnpPacket &data) override
+    {
+        // Touch the link layer address as a real interface would
+        lastAddress = data.header.lladdress.get();
+        sent++;
+    };
+
+    const RnpInterfaceInfo *getInfo() override { return &info; };
+
+    const std::string *volatile lastAddress = nullptr;
+
+    size_t sent = 0;
+
+private:
+    RnpInterfaceInfo info;
+};
+
+template <typename FUNC>
+static void run(const char *name, FUNC func)
+{
+    const auto t0 = std::chrono::steady_clock::now();
+
+    for (size_t i = 0; i < iterations; i++)
+    {
+        func(static_cast<uint8_t>(2 + (i % 252)));
+    }
+
+    const auto t1 = std::chrono::steady_clock::now();
+    const double seconds = std::chrono::duration<double>(t1 - t0).count();
+
+    std::printf("%-24s %10.1f ns/op\n", name, seconds * 1e9 / iterations);
+}
+
+int main()
+{
+    RnpNetworkManager netman(1, NODETYPE::HUB);
+    NullInterface iface;
+    netman.addInterface(&iface);
+
+    // Route every remote destination over the null interface with its own
+    // link layer address
+    RoutingTable table;
+    for (size_t dest = 2; dest < 254; dest++)
+    {
+        table.setRoute(static_cast<uint8_t>(dest),
+                       Route{ifaceID, 1, "peer-" + std::to_string(dest)});
+    }
+    netman.setRoutingTable(table);
+
+    SimpleCommandPacket packet(0, 0);
+    packet.header.source = 1;
+    packet.header.src_iface = 0;
+
+    size_t found = 0;
+
+    run("findRoute", [&](uint8_t dest) {
+        const Route *route = table.findRoute(dest);
+        found += (route != nullptr) && !route->address.empty();
+    });
+
+    run("getRoute (copy)", [&](uint8_t dest) {
+        const auto route = table.getRoute(dest);
+        found += route && !route->address.empty();
+    });
+
+    run("sendPacket", [&](uint8_t dest) {
+        packet.header.destination = dest;
+        packet.header.hops = 0;
+        netman.sendPacket(packet);
+    });
+
+    if (found != 2 * iterations || iface.sent != iterations)
+    {
+        std::printf("FAILED: %zu routes found, %zu packets sent\n", found, iface.sent);
+        return 1;
+    }
+
+    return 0;
+}
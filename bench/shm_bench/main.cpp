@@ -0,0 +1,204 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#include <librnp/default_packets/simplecommandpacket.h>
+#include <librnp/rnp_eventloop.h>
+#include <librnp/rnp_networkmanager.h>
+#include <librnp/rnp_routingtable.h>
+#include <librnp/shminterface.h>
+#include <librnp/udpinterface.h>
+
+// Shared memory against UDP loopback benchmark, between two nodes in one
+// process standing in for two processes.
+//
+// Throughput: node A sends bursts of packets to a service on node B, and both
+// are updated on one thread, as in udp_bench.
+//
+// Latency: node B runs an event loop on its own thread and echoes every
+// packet. Node A sends one packet at a time and runs its own event loop until
+// the echo arrives, so each round trip includes both wake ups.
+
+static constexpr size_t iterations = 200000;
+static constexpr size_t burst = 32;
+static constexpr size_t pings = 20000;
+
+static constexpr uint8_t nodeA = 10;
+static constexpr uint8_t nodeB = 11;
+static constexpr uint8_t linkID = 2;
+static constexpr uint8_t benchService = 10;
+
+// A pair of linked interfaces, and the link layer address of B
+struct Link
+{
+    RnpInterface *a;
+    RnpInterface *b;
+    std::string addressB;
+};
+
+static SimpleCommandPacket makePacket()
+{
+    SimpleCommandPacket packet(1, 1234);
+    packet.header.source = nodeA;
+    packet.header.destination = nodeB;
+    packet.header.source_service = benchService;
+    packet.header.destination_service = benchService;
+    return packet;
+}
+
+static void connect(RnpNetworkManager &netmanA, RnpNetworkManager &netmanB,
+                    const Link &link)
+{
+    netmanA.addInterface(link.a);
+    netmanB.addInterface(link.b);
+    netmanA.setRoutingBudget(0);
+    netmanB.setRoutingBudget(0);
+
+    RoutingTable table;
+    table.setRoute(nodeB, Route{linkID, 1, link.addressB});
+    netmanA.setRoutingTable(table);
+    netmanB.enableAutoRouteGen(true);
+}
+
+static bool throughput(const char *name, const Link &link)
+{
+    RnpNetworkManager netmanA(nodeA, NODETYPE::LEAF, false, 256, 64);
+    RnpNetworkManager netmanB(nodeB, NODETYPE::LEAF, false, 256, 64);
+    connect(netmanA, netmanB, link);
+
+    size_t received = 0;
+    netmanB.registerService(benchService,
+                            [&received](packetptr_t) { received++; });
+
+    SimpleCommandPacket packet = makePacket();
+
+    const auto t0 = std::chrono::steady_clock::now();
+
+    for (size_t i = 0; i < iterations; i += burst)
+    {
+        for (size_t j = 0; j < burst; j++)
+        {
+            // Reset the hop count, which sendPacket() increments
+            packet.header.hops = 0;
+            netmanA.sendPacket(packet);
+        }
+        netmanA.update();
+        netmanB.update();
+    }
+
+    const auto t1 = std::chrono::steady_clock::now();
+    const double seconds = std::chrono::duration<double>(t1 - t0).count();
+
+    std::printf("%-4s throughput %8.2f Mpackets/s %8.1f ns/packet\n", name,
+                received / seconds / 1e6, seconds * 1e9 / received);
+
+    netmanA.removeInterface(link.a);
+    netmanB.removeInterface(link.b);
+    return received > iterations * 9 / 10;
+}
+
+static bool latency(const char *name, const Link &link)
+{
+    RnpNetworkManager netmanA(nodeA, NODETYPE::LEAF, false, 256, 64);
+    RnpNetworkManager netmanB(nodeB, NODETYPE::LEAF, false, 256, 64);
+    connect(netmanA, netmanB, link);
+
+    netmanB.registerService(benchService, [&netmanB](packetptr_t packet_ptr)
+    {
+        SimpleCommandPacket reply(*packet_ptr);
+        RnpHeader::generateResponseHeader(packet_ptr->header, reply.header);
+        netmanB.sendPacket(reply);
+    });
+    RnpEventLoop loopB(netmanB);
+    std::thread echo([&loopB] { loopB.run(); });
+
+    size_t replies = 0;
+    netmanA.registerService(benchService,
+                            [&replies](packetptr_t) { replies++; });
+    RnpEventLoop loopA(netmanA);
+
+    SimpleCommandPacket packet = makePacket();
+    std::vector<double> rtts;
+    rtts.reserve(pings);
+    const auto deadline =
+        std::chrono::steady_clock::now() + std::chrono::seconds(10);
+
+    for (size_t i = 0; i < pings; i++)
+    {
+        const auto t0 = std::chrono::steady_clock::now();
+        packet.header.hops = 0;
+        netmanA.sendPacket(packet);
+        loopA.wake();
+
+        // Wait for the echo, giving up on a lost packet
+        const size_t expected = replies + 1;
+        while (replies < expected)
+        {
+            loopA.runOnce(100);
+            if (std::chrono::steady_clock::now() > deadline)
+            {
+                break;
+            }
+        }
+        if (replies < expected)
+        {
+            break;
+        }
+
+        const auto t1 = std::chrono::steady_clock::now();
+        rtts.push_back(std::chrono::duration<double, std::micro>(t1 - t0)
+                           .count());
+    }
+
+    loopB.stop();
+    echo.join();
+    netmanA.removeInterface(link.a);
+    netmanB.removeInterface(link.b);
+
+    if (rtts.size() < pings)
+    {
+        std::printf("%-4s latency    lost after %zu pings\n", name,
+                    rtts.size());
+        return false;
+    }
+
+    std::sort(rtts.begin(), rtts.end());
+    std::printf("%-4s latency    %8.1f us median %8.1f us p99\n", name,
+                rtts[rtts.size() / 2], rtts[rtts.size() * 99 / 100]);
+    return true;
+}
+
+int main()
+{
+    UdpInterface udpA(linkID, "127.0.0.1:0", "udpA");
+    UdpInterface udpB(linkID, "127.0.0.1:0", "udpB");
+    udpA.setup();
+    udpB.setup();
+    const Link udp{&udpA, &udpB,
+                   "127.0.0.1:" + std::to_string(udpB.getPort())};
+
+    const std::string suffix = std::to_string(getpid());
+    ShmInterface shmA(linkID, "benchA." + suffix, "shmA");
+    ShmInterface shmB(linkID, "benchB." + suffix, "shmB");
+    shmA.setup();
+    shmB.setup();
+    const Link shm{&shmA, &shmB, "benchB." + suffix};
+
+    bool ok = throughput("udp", udp);
+    ok &= throughput("shm", shm);
+    ok &= latency("udp", udp);
+    ok &= latency("shm", shm);
+
+    if (!ok)
+    {
+        std::printf("FAILED\n");
+        return 1;
+    }
+
+    return 0;
+}
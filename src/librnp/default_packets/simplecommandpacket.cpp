@@ -12,22 +12,50 @@ SimpleCommandPacket::SimpleCommandPacket(const uint8_t _command,
 SimpleCommandPacket::SimpleCommandPacket(const RnpPacketSerialized &packet)
     : RnpPacket(packet, size()) {
     // Deserialize packet and store
-    getSerializer().deserialize(*this, packet.getBody());
+    getSerializer().deserialize(*this, packet.getBodyView());
 };
 
-void SimpleCommandPacket::serialize(std::vector<uint8_t> &buf) {
-    // Serialize packet into buffer
-    RnpPacket::serialize(buf);
+SimpleCommandPacket::SimpleCommandPacket(const RnpPacketSerialized &packet,
+                                         RnpPrevalidated)
+    : RnpPacket(packet.header) {
+    // Deserialize packet and store
+    getSerializer().deserialize(*this, packet.getBodyView());
+};
+
+RnpDecodeResult<SimpleCommandPacket>
+SimpleCommandPacket::tryDecode(const RnpPacketSerialized &packet) {
+    // Validate the sizes once up front
+    const RnpDecodeError error = checkSize(packet, size());
+    if (error != RnpDecodeError::NONE) {
+        return error;
+    }
 
+    return RnpDecodeResult<SimpleCommandPacket>(std::in_place, packet,
+                                                rnpPrevalidated);
+}
+
+void SimpleCommandPacket::serialize(std::vector<uint8_t> &buf) {
     // Extract buffer size
     size_t bufsize = buf.size();
 
-    // Resize buffer to include the packet
-    buf.resize(bufsize + size());
+    // Resize buffer to include the header and packet
+    buf.resize(bufsize + header.size() + size());
 
-    // Copy packet onto end of buffer
-    std::memcpy(buf.data() + bufsize, getSerializer().serialize(*this).data(),
-                size());
+    // Serialize packet onto end of buffer
+    serialize(buf.data() + bufsize, header.size() + size());
+};
+
+size_t SimpleCommandPacket::serialize(uint8_t *buf, size_t capacity) {
+    // Check the packet fits
+    if (capacity < header.size() + size()) {
+        return 0;
+    }
+
+    // Serialize header
+    const size_t headersize = header.serialize(buf);
+
+    // Serialize packet after the header
+    return headersize + getSerializer().serializeInto(*this, buf + headersize);
 };
 
 command_t CommandPacket::getCommand(const RnpPacketSerialized &packet) {
@@ -44,3 +72,15 @@ command_t CommandPacket::getCommand(const RnpPacketSerialized &packet) {
     // Return command identifier
     return commandID;
 }
+
+RnpDecodeError CommandPacket::tryGetCommand(const RnpPacketSerialized &packet,
+                                            command_t &command) {
+    // Check the body holds a command identifier
+    if (packet.getBodySize() < sizeof(command_t)) {
+        return RnpDecodeError::BODY_SIZE_MISMATCH;
+    }
+
+    // Extract command identifier from packet
+    command = getCommand(packet);
+    return RnpDecodeError::NONE;
+}
@@ -20,6 +20,17 @@ namespace CommandPacket {
      */
     command_t getCommand(const RnpPacketSerialized &packet);
 
+    /**
+     * @brief Get command identifier from a command service packet without
+     * reading past the end of a packet with an empty body
+     *
+     * @param[in] packet Packet
+     * @param[out] command Command identifier
+     * @return RnpDecodeError NONE if the packet holds a command identifier
+     */
+    RnpDecodeError tryGetCommand(const RnpPacketSerialized &packet,
+                                 command_t &command);
+
 }; // namespace CommandPacket
 
 /**
@@ -69,6 +80,22 @@ public:
      */
     SimpleCommandPacket(const RnpPacketSerialized &packet);
 
+    /**
+     * @brief Deserialize a packet already validated by checkSize()
+     *
+     * @param[in] packet Serialized packet
+     */
+    SimpleCommandPacket(const RnpPacketSerialized &packet, RnpPrevalidated);
+
+    /**
+     * @brief Deserialize a packet without throwing
+     *
+     * @param[in] packet Serialized packet
+     * @return RnpDecodeResult<SimpleCommandPacket> Packet, or the size mismatch
+     */
+    static RnpDecodeResult<SimpleCommandPacket>
+    tryDecode(const RnpPacketSerialized &packet);
+
     /**
      * @brief Serialize into provided buffer
      *
@@ -78,6 +105,15 @@ public:
      */
     void serialize(std::vector<uint8_t> &buf) override;
 
+    /**
+     * @brief Serialize in place into a caller owned buffer
+     *
+     * @param[out] buf Output buffer
+     * @param[in] capacity Size of the output buffer
+     * @return size_t Number of bytes written, 0 if the packet does not fit
+     */
+    size_t serialize(uint8_t *buf, size_t capacity) override;
+
     /// @brief Command
     command_t command;
 
@@ -19,14 +19,36 @@ void Loopback::sendPacket(RnpPacket &data) {
         return;
     }
 
-    // Declare buffer
-    std::vector<uint8_t> serializedData;
+    // Clear buffer, keeping its capacity
+    _serializedData.clear();
 
     // Serialize packet into buffer
-    data.serialize(serializedData);
+    data.serialize(_serializedData);
 
+    // Place the serialized packet on the packet buffer
+    receive(_serializedData);
+};
+
+void Loopback::sendPacket(RnpPacket &data, const RnpWireBuffer &wire) {
+    (void)data;
+
+    // Return if no buffer is present
+    if (_packetBuffer == nullptr) {
+        return;
+    }
+
+    // Place the serialized packet on the packet buffer
+    receive(wire.view());
+};
+
+void Loopback::receive(const RnpBufferView bytes) {
     // Get pointer to packet buffer
-    auto packet_ptr = std::make_unique<RnpPacketSerialized>(serializedData);
+    packetptr_t packet_ptr = createPacket(bytes);
+
+    // Dump the packet if it could not be created
+    if (!packet_ptr) {
+        return;
+    }
 
     // Update packet source interface
     packet_ptr->header.src_iface = getID();
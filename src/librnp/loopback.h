@@ -54,6 +54,22 @@ public:
      */
     void sendPacket(RnpPacket &data) override;
 
+    /**
+     * @brief Send an already serialized packet
+     *
+     * @param[in] data Packet
+     * @param[in] wire Serialized packet
+     */
+    void sendPacket(RnpPacket &data, const RnpWireBuffer &wire) override;
+
+    /**
+     * @brief Loopback packets are placed on the packet buffer as they are
+     * sent, so there is nothing to poll for
+     *
+     * @return false Never needs updating
+     */
+    bool requiresPolling() override { return false; };
+
     /**
      * @brief Get Loopback information
      *
@@ -76,4 +92,14 @@ public:
 private:
     /// @brief Loopback information
     LoopbackInfo info;
+
+    /**
+     * @brief Place serialized bytes on the packet buffer
+     *
+     * @param[in] bytes Serialized packet
+     */
+    void receive(const RnpBufferView bytes);
+
+    /// @brief Serialization buffer, reused between packets
+    std::vector<uint8_t> _serializedData;
 };
\ No newline at end of file
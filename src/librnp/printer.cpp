@@ -25,6 +25,16 @@ void Printer::sendPacket(RnpPacket &data) {
     // Serialize packet
     data.serialize(serializedData);
 
+    // Print the serialized packet
+    print(data, serializedData);
+};
+
+void Printer::sendPacket(RnpPacket &data, const RnpWireBuffer &wire) {
+    // Print the serialized packet
+    print(data, wire.view());
+};
+
+void Printer::print(const RnpPacket &data, const RnpBufferView bytes) {
     // Declare string stream
     std::stringstream aout;
 
@@ -36,7 +46,7 @@ void Printer::sendPacket(RnpPacket &data) {
     aout << RnpHeader::print(data.header).str() << "\n";
 
     // Shift packet elements into stream
-    for (auto &elem : serializedData) {
+    for (auto &elem : bytes) {
         aout << std::hex << std::to_string((int)elem) << ",";
     }
 
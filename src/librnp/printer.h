@@ -49,6 +49,14 @@ public:
      */
     void sendPacket(RnpPacket &data) override;
 
+    /**
+     * @brief Send an already serialized packet
+     *
+     * @param[in] data Packet
+     * @param[in] wire Serialized packet
+     */
+    void sendPacket(RnpPacket &data, const RnpWireBuffer &wire) override;
+
     /**
      * @brief Get Printer info
      *
@@ -69,6 +77,14 @@ public:
     ~Printer(){};
 
 private:
+    /**
+     * @brief Print a serialized packet
+     *
+     * @param[in] data Packet
+     * @param[in] bytes Serialized packet
+     */
+    void print(const RnpPacket &data, const RnpBufferView bytes);
+
     /// @brief Printer info
     RnpInterfaceInfo info;
 };
\ No newline at end of file
@@ -0,0 +1,135 @@
+#include "ptyinterface.h"
+
+#if defined(__linux__)
+
+#include <cerrno>
+#include <cstdlib>
+
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+
+/**
+ * @brief Convert a baud rate to a termios speed
+ *
+ * @param[in] baudRate Baud rate
+ * @param[out] speed termios speed
+ * @return true Supported baud rate
+ * @return false Unsupported baud rate
+ */
+static bool toSpeed(const uint32_t baudRate, speed_t &speed) {
+    switch (baudRate) {
+    case 9600:
+        speed = B9600;
+        return true;
+    case 19200:
+        speed = B19200;
+        return true;
+    case 38400:
+        speed = B38400;
+        return true;
+    case 57600:
+        speed = B57600;
+        return true;
+    case 115200:
+        speed = B115200;
+        return true;
+    case 230400:
+        speed = B230400;
+        return true;
+    case 460800:
+        speed = B460800;
+        return true;
+    case 921600:
+        speed = B921600;
+        return true;
+    default:
+        return false;
+    }
+}
+
+PtyInterface::PtyInterface(const uint8_t id, const std::string devicePath,
+                           const uint32_t baudRate, const std::string name,
+                           const size_t mtu)
+    : StreamInterface(id, name, mtu), _devicePath(devicePath),
+      _create(devicePath.empty()), _baudRate(baudRate), _hungUp(false){};
+
+void PtyInterface::setup() {
+    // Do nothing if already open
+    if (connected()) {
+        return;
+    }
+
+    int fd = -1;
+    if (_create) {
+        // Create a pseudo terminal, keeping the master end
+        fd = ::posix_openpt(O_RDWR | O_NOCTTY | O_CLOEXEC);
+        if ((fd >= 0) && ((::grantpt(fd) != 0) || (::unlockpt(fd) != 0))) {
+            ::close(fd);
+            fd = -1;
+        }
+        if (fd >= 0) {
+            _devicePath = ::ptsname(fd);
+        }
+    } else {
+        // Open the tty without it becoming the controlling terminal
+        fd = ::open(_devicePath.c_str(), O_RDWR | O_NOCTTY | O_CLOEXEC);
+    }
+
+    // Configure the line
+    if ((fd < 0) || !configure(fd)) {
+        if (fd >= 0) {
+            ::close(fd);
+        }
+        info.error = true;
+        return;
+    }
+
+    info.error = false;
+    attach(fd);
+};
+
+bool PtyInterface::configure(const int fd) {
+    termios options;
+    if (::tcgetattr(fd, &options) != 0) {
+        return false;
+    }
+
+    // Raw mode, so no bytes are translated, echoed or buffered by line
+    ::cfmakeraw(&options);
+
+    // Set the line speed
+    if (_baudRate != 0) {
+        speed_t speed;
+        if (!toSpeed(_baudRate, speed) ||
+            (::cfsetspeed(&options, speed) != 0)) {
+            return false;
+        }
+    }
+
+    return ::tcsetattr(fd, TCSANOW, &options) == 0;
+};
+
+int PtyInterface::getPollFd() {
+    // Poll while hung up
+    if (_hungUp) {
+        return -1;
+    }
+
+    return StreamInterface::getPollFd();
+};
+
+void PtyInterface::poll() { _hungUp = false; };
+
+void PtyInterface::streamClosed(const int error) {
+    // The master end of a pseudo terminal reads EIO while the other end is
+    // closed, wait for it to be opened again
+    if (_create && (error == EIO)) {
+        _hungUp = true;
+        return;
+    }
+
+    StreamInterface::streamClosed(error);
+};
+
+#endif
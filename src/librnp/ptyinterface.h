@@ -0,0 +1,96 @@
+#pragma once
+
+#if defined(__linux__)
+
+#include <cstdint>
+#include <string>
+
+#include "streaminterface.h"
+
+/**
+ * @brief Serial stream interface over a pseudo terminal or tty (Linux only)
+ *
+ * Carries framed packets over a serial line, see StreamInterface. With no
+ * device path a new pseudo terminal is created, and the other end (i.e a
+ * simulator, socat or another PtyInterface) opens getDevicePath(). With a
+ * device path, an existing tty such as a USB serial adapter or the other end
+ * of a pseudo terminal is opened. The line is always put in raw mode.
+ */
+class PtyInterface : public StreamInterface {
+public:
+    /**
+     * @brief Construct a new PTY Interface object
+     *
+     * @param[in] id Interface identifier
+     * @param[in] devicePath tty to open, empty to create a pseudo terminal
+     * @param[in] baudRate Line speed of a tty, 0 to leave it unchanged
+     * @param[in] name Interface name
+     * @param[in] mtu Largest packet sent or received, in bytes
+     */
+    PtyInterface(const uint8_t id, const std::string devicePath = "",
+                 const uint32_t baudRate = 0, const std::string name = "PTY",
+                 const size_t mtu = 1024);
+
+    /**
+     * @brief Open the tty, or create the pseudo terminal
+     *
+     * Sets info.error if the device cannot be opened or configured.
+     */
+    void setup() override;
+
+    /**
+     * @brief Get the path of the tty, i.e the other end of a created pseudo
+     * terminal
+     *
+     * @return const std::string& Device path, empty before setup
+     */
+    const std::string &getDevicePath() const { return _devicePath; };
+
+    /**
+     * @brief Get the tty, or -1 while nothing is attached to the other end of
+     * a created pseudo terminal, which would otherwise always report a hang
+     * up and is polled instead
+     *
+     * @return int File descriptor, -1 if not open or hung up
+     */
+    int getPollFd() override;
+
+protected:
+    /**
+     * @brief Clear the hang up at the start of every update, it is set again
+     * if reads still fail
+     */
+    void poll() override;
+
+    /**
+     * @brief Keep a created pseudo terminal open while nothing is attached to
+     * the other end, which reads report as EIO
+     *
+     * @param[in] error errno, 0 for end of file
+     */
+    void streamClosed(const int error) override;
+
+private:
+    /**
+     * @brief Put a tty in raw mode at the configured speed
+     *
+     * @param[in] fd tty
+     * @return true Configured
+     * @return false Not a tty, or the speed is not supported
+     */
+    bool configure(const int fd);
+
+    /// @brief Device path
+    std::string _devicePath;
+
+    /// @brief A pseudo terminal was created
+    const bool _create;
+
+    /// @brief Line speed, 0 to leave it unchanged
+    const uint32_t _baudRate;
+
+    /// @brief Nothing is attached to the other end of the pseudo terminal
+    bool _hungUp;
+};
+
+#endif
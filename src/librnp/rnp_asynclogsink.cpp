@@ -0,0 +1,103 @@
+#include "rnp_asynclogsink.h"
+
+#include <chrono>
+
+namespace {
+/// @brief Longest the drain waits before checking the queue, bounding the
+/// delay of a record whose wakeup raced the drain going to sleep
+constexpr uint32_t drainPeriod_ms = 50;
+
+#if defined(ESP_PLATFORM)
+/// @brief Drain task stack size
+constexpr uint32_t drainStackSize = 4096;
+#endif
+} // namespace
+
+RnpAsyncLogSink::RnpAsyncLogSink(LogCb_t callback, const size_t capacity)
+    : _callback(callback), _queue(capacity) {
+    // Allocate the callback string up front
+    _output.reserve(RnpLogRecord::maxLength);
+
+#if defined(ESP_PLATFORM)
+    // Drain from a task just above idle, so logging never preempts routing
+    xTaskCreate(
+        [](void *context) {
+            RnpAsyncLogSink *sink = static_cast<RnpAsyncLogSink *>(context);
+            sink->run();
+            sink->_stopped.store(true, std::memory_order_release);
+            vTaskDelete(nullptr);
+        },
+        "rnp_log", drainStackSize, this, tskIDLE_PRIORITY + 1, &_task);
+#elif defined(RNP_ASYNC_LOG_THREAD)
+    _thread = std::thread(&RnpAsyncLogSink::run, this);
+#endif
+}
+
+RnpAsyncLogSink::~RnpAsyncLogSink() {
+    // Stop and wake the drain, which writes out the remaining records
+    _running.store(false, std::memory_order_release);
+
+#if defined(ESP_PLATFORM)
+    if (_task != nullptr) {
+        xTaskNotifyGive(_task);
+        while (!_stopped.load(std::memory_order_acquire)) {
+            vTaskDelay(1);
+        }
+    }
+#elif defined(RNP_ASYNC_LOG_THREAD)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _wake.notify_one();
+    }
+    if (_thread.joinable()) {
+        _thread.join();
+    }
+#endif
+}
+
+bool RnpAsyncLogSink::push(const RnpLogRecord &record) {
+    // Drop the record rather than wait for space
+    if (!_queue.push(record)) {
+        _dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    // Only wake the drain if it is asleep, avoiding a system call per record
+    if (_waiting.exchange(false, std::memory_order_acq_rel)) {
+#if defined(ESP_PLATFORM)
+        xTaskNotifyGive(_task);
+#elif defined(RNP_ASYNC_LOG_THREAD)
+        _wake.notify_one();
+#endif
+    }
+    return true;
+}
+
+void RnpAsyncLogSink::run() {
+    while (_running.load(std::memory_order_acquire)) {
+        drain();
+
+        // Sleep until woken by a producer, or the drain period elapses
+        _waiting.store(true, std::memory_order_release);
+#if defined(ESP_PLATFORM)
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(drainPeriod_ms));
+#elif defined(RNP_ASYNC_LOG_THREAD)
+        std::unique_lock<std::mutex> lock(_mutex);
+        _wake.wait_for(lock, std::chrono::milliseconds(drainPeriod_ms), [this]() {
+            return !_queue.empty() ||
+                   !_running.load(std::memory_order_acquire);
+        });
+#endif
+        _waiting.store(false, std::memory_order_release);
+    }
+
+    // Write out what was queued before stopping
+    drain();
+}
+
+void RnpAsyncLogSink::drain() {
+    RnpLogRecord record;
+    while (_queue.pop(record)) {
+        RnpLogger::write(_callback, _output, record);
+    }
+}
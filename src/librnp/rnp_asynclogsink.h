@@ -0,0 +1,124 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "rnp_logger.h"
+#include "rnp_mpscringbuffer.h"
+
+#if defined(ESP_PLATFORM)
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#elif !defined(ARDUINO)
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#define RNP_ASYNC_LOG_THREAD
+#endif
+
+/// @brief Asynchronous logging is available, either as a FreeRTOS task on the
+/// ESP-IDF or a thread on hosted platforms
+#if defined(ESP_PLATFORM) || defined(RNP_ASYNC_LOG_THREAD)
+#define RNP_ASYNC_LOG_SUPPORTED 1
+#else
+#define RNP_ASYNC_LOG_SUPPORTED 0
+#endif
+
+/**
+ * @brief Log sink outputting records from a background thread
+ *
+ * Records are pushed into a bounded lock-free ring and written out by a
+ * background thread (a low priority task on the ESP-IDF), so a slow terminal
+ * or UART does not stall the caller. Records are dropped and counted when
+ * the ring is full rather than blocking.
+ *
+ * Records still queued when the sink is destroyed are written out first.
+ */
+class RnpAsyncLogSink {
+public:
+    /// @brief Default number of queued records
+    static constexpr size_t defaultCapacity = 32;
+
+    /**
+     * @brief Construct a new sink and start the background drain
+     *
+     * @param[in] callback Logging callback, called from the background
+     * thread. Empty for the default output
+     * @param[in] capacity Maximum number of queued records
+     */
+    RnpAsyncLogSink(LogCb_t callback, const size_t capacity = defaultCapacity);
+
+    RnpAsyncLogSink(const RnpAsyncLogSink &) = delete;
+    RnpAsyncLogSink &operator=(const RnpAsyncLogSink &) = delete;
+
+    /**
+     * @brief Stop the background drain, writing out queued records
+     */
+    ~RnpAsyncLogSink();
+
+    /**
+     * @brief Queue a record for output, never blocks
+     *
+     * @param[in] record Record
+     * @return true Record queued
+     * @return false Queue full, record dropped
+     */
+    bool push(const RnpLogRecord &record);
+
+    /**
+     * @brief Get the number of records dropped as the queue was full
+     *
+     * @return uint32_t Dropped records, wraps around
+     */
+    uint32_t dropped() const {
+        return _dropped.load(std::memory_order_relaxed);
+    };
+
+private:
+    /**
+     * @brief Background drain loop
+     */
+    void run();
+
+    /**
+     * @brief Output every queued record
+     */
+    void drain();
+
+    /// @brief Logging callback
+    const LogCb_t _callback;
+
+    /// @brief Queued records
+    Rnp_MPSCRingBuffer<RnpLogRecord> _queue;
+
+    /// @brief Records dropped as the queue was full
+    std::atomic<uint32_t> _dropped{0};
+
+    /// @brief Cleared to stop the background drain
+    std::atomic<bool> _running{true};
+
+    /// @brief Set while the background drain waits for records
+    std::atomic<bool> _waiting{false};
+
+    /// @brief String passed to the callback, reused between records
+    std::string _output;
+
+#if defined(ESP_PLATFORM)
+    /// @brief Drain task
+    TaskHandle_t _task = nullptr;
+
+    /// @brief Set by the drain task once it has stopped
+    std::atomic<bool> _stopped{false};
+#elif defined(RNP_ASYNC_LOG_THREAD)
+    /// @brief Guards waiting for records
+    std::mutex _mutex;
+
+    /// @brief Signalled when records are queued
+    std::condition_variable _wake;
+
+    /// @brief Drain thread
+    std::thread _thread;
+#endif
+};
@@ -0,0 +1,184 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <type_traits>
+
+#include "rnp_bufferview.h"
+#include "rnp_endian.h"
+
+/**
+ * @brief Fixed capacity buffer holding up to N bytes, for variable length
+ * packet fields
+ *
+ * Serialized as a little endian length followed by the bytes. Unless PADDED,
+ * only the used bytes are sent, otherwise the unused capacity is zero filled
+ * so the field always has the same size on the wire.
+ *
+ * @tparam N Capacity in bytes
+ * @tparam PADDED Always serialize the full capacity
+ */
+template <size_t N, bool PADDED = false>
+class RnpBoundedBuffer {
+public:
+    static_assert(N <= UINT16_MAX, "Bounded buffer capacity too large");
+
+    /// @brief Length prefix type, the smallest holding the capacity
+    using length_t = std::conditional_t<(N <= UINT8_MAX), uint8_t, uint16_t>;
+
+    /**
+     * @brief Construct an empty buffer
+     */
+    constexpr RnpBoundedBuffer() : _length(0), _data{} {};
+
+    /**
+     * @brief Construct a buffer holding a string, truncated to the capacity
+     *
+     * @param[in] str String
+     */
+    RnpBoundedBuffer(const std::string_view str) : RnpBoundedBuffer() {
+        assign(str);
+    };
+
+    /**
+     * @brief Replace the contents, truncating to the capacity
+     *
+     * @param[in] data Bytes
+     * @param[in] length Number of bytes
+     * @return size_t Number of bytes stored
+     */
+    size_t assign(const void *data, const size_t length) {
+        _length = static_cast<length_t>(std::min(length, N));
+        std::memcpy(_data.data(), data, _length);
+        return _length;
+    };
+
+    /**
+     * @brief Replace the contents with a string, truncating to the capacity
+     *
+     * @param[in] str String
+     * @return size_t Number of bytes stored
+     */
+    size_t assign(const std::string_view str) {
+        return assign(str.data(), str.size());
+    };
+
+    /**
+     * @brief Remove the contents
+     */
+    void clear() { _length = 0; };
+
+    /**
+     * @brief Get the number of bytes held
+     */
+    size_t size() const { return _length; };
+
+    /**
+     * @brief Check if no bytes are held
+     */
+    bool empty() const { return _length == 0; };
+
+    /**
+     * @brief Get the capacity
+     */
+    static constexpr size_t capacity() { return N; };
+
+    /**
+     * @brief Get the bytes held
+     */
+    const uint8_t *data() const { return _data.data(); };
+
+    /**
+     * @brief Get a view of the bytes held
+     */
+    RnpBufferView view() const { return {_data.data(), _length}; };
+
+    /**
+     * @brief Get the bytes held as a string
+     */
+    std::string_view str() const {
+        return {reinterpret_cast<const char *>(_data.data()), _length};
+    };
+
+    /**
+     * @brief Get the maximum serialized size
+     */
+    static constexpr size_t max_serialized_size() {
+        return sizeof(length_t) + N;
+    };
+
+    /**
+     * @brief Get the serialized size of the contents
+     */
+    size_t serialized_size() const {
+        return PADDED ? max_serialized_size() : sizeof(length_t) + _length;
+    };
+
+    /**
+     * @brief Serialize into a caller owned buffer
+     *
+     * The caller must ensure there is space for serialized_size() bytes.
+     *
+     * @param[out] dst Output location
+     * @return size_t Number of bytes written
+     */
+    size_t serializeInto(uint8_t *dst) const {
+        // Write the length, then the bytes
+        RnpEndian::store(dst, _length);
+        std::memcpy(dst + sizeof(length_t), _data.data(), _length);
+
+        // Zero fill the unused capacity
+        if constexpr (PADDED) {
+            std::memset(dst + sizeof(length_t) + _length, 0, N - _length);
+        }
+
+        return serialized_size();
+    };
+
+    /**
+     * @brief Deserialize from a buffer
+     *
+     * A padded length larger than the capacity is clamped, as the bytes read
+     * are bounded by the capacity anyway.
+     *
+     * @param[in] src Input bytes
+     * @param[in] available Number of input bytes
+     * @return size_t Number of bytes read, 0 if the input is too short
+     */
+    size_t deserializeFrom(const uint8_t *src, const size_t available) {
+        // Read the length
+        length_t length;
+        if (available < sizeof(length_t)) {
+            return 0;
+        }
+        RnpEndian::load(length, src);
+
+        if constexpr (PADDED) {
+            if (available < max_serialized_size()) {
+                return 0;
+            }
+            length = static_cast<length_t>(std::min<size_t>(length, N));
+        } else {
+            if (length > N || available < sizeof(length_t) + length) {
+                return 0;
+            }
+        }
+
+        // Copy the bytes
+        _length = length;
+        std::memcpy(_data.data(), src + sizeof(length_t), _length);
+
+        return serialized_size();
+    };
+
+private:
+    /// @brief Number of bytes held
+    length_t _length;
+
+    /// @brief Storage
+    std::array<uint8_t, N> _data;
+};
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Non-owning, read-only view over a contiguous byte buffer
+ *
+ * Lightweight stand-in for std::span<const uint8_t> (C++17 has no span). The
+ * view does not extend the lifetime of the underlying buffer, so it must not
+ * outlive the buffer it was created from.
+ */
+class RnpBufferView {
+public:
+    /**
+     * @brief Construct an empty view
+     */
+    constexpr RnpBufferView() : _data(nullptr), _size(0){};
+
+    /**
+     * @brief Construct a view over a raw buffer
+     *
+     * @param[in] data Pointer to the first byte
+     * @param[in] size Number of bytes
+     */
+    constexpr RnpBufferView(const uint8_t *data, const size_t size)
+        : _data(data), _size(size){};
+
+    /**
+     * @brief Construct a view over the contents of a vector
+     *
+     * @param[in] buf Vector to view
+     */
+    RnpBufferView(const std::vector<uint8_t> &buf)
+        : _data(buf.data()), _size(buf.size()){};
+
+    /**
+     * @brief Get a pointer to the first byte
+     *
+     * @return const uint8_t* First byte
+     */
+    constexpr const uint8_t *data() const { return _data; };
+
+    /**
+     * @brief Get the size of the view
+     *
+     * @return size_t Number of bytes
+     */
+    constexpr size_t size() const { return _size; };
+
+    /**
+     * @brief Check if the view is empty
+     *
+     * @return true View is empty
+     * @return false View is not empty
+     */
+    constexpr bool empty() const { return _size == 0; };
+
+    constexpr const uint8_t *begin() const { return _data; };
+
+    constexpr const uint8_t *end() const { return _data + _size; };
+
+    constexpr const uint8_t &operator[](const size_t idx) const {
+        return _data[idx];
+    };
+
+    /**
+     * @brief Get a view over part of this view
+     *
+     * The returned view is clamped to the bounds of this view, so an offset
+     * past the end returns an empty view.
+     *
+     * @param[in] offset Offset of the first byte
+     * @param[in] count Maximum number of bytes
+     * @return RnpBufferView Sub-view
+     */
+    constexpr RnpBufferView subview(const size_t offset,
+                                    const size_t count = SIZE_MAX) const {
+        if (offset >= _size) {
+            return {};
+        }
+        const size_t remaining = _size - offset;
+        return {_data + offset, (count < remaining) ? count : remaining};
+    };
+
+private:
+    /// @brief First byte
+    const uint8_t *_data;
+
+    /// @brief Number of bytes
+    size_t _size;
+};
@@ -0,0 +1,141 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+/**
+ * @brief Circular buffer container usable as the underlying container of a
+ * std::queue
+ *
+ * Unlike std::deque, which allocates and frees a block every few elements as
+ * the queue advances, storage is only allocated when the capacity needs to
+ * grow. Once the capacity covers the maximum queue depth, pushing and popping
+ * never allocates.
+ *
+ * Elements must be default constructible and move assignable. Popped slots
+ * are reset to a default constructed element so resources are released
+ * immediately.
+ *
+ * @tparam T Element type
+ */
+template <typename T>
+class Rnp_CircularBuffer {
+public:
+    using value_type = T;
+    using size_type = size_t;
+    using reference = T &;
+    using const_reference = const T &;
+
+    /**
+     * @brief Construct an empty circular buffer with no storage
+     */
+    Rnp_CircularBuffer() : _capacity(0), _head(0), _size(0){};
+
+    /**
+     * @brief Construct an empty circular buffer with preallocated storage
+     *
+     * @param capacity number of elements to preallocate
+     */
+    explicit Rnp_CircularBuffer(const size_t capacity) : Rnp_CircularBuffer() {
+        reserve(capacity);
+    };
+
+    Rnp_CircularBuffer(Rnp_CircularBuffer &&other) noexcept
+        : _storage(std::move(other._storage)), _capacity(other._capacity),
+          _head(other._head), _size(other._size) {
+        other._capacity = 0;
+        other._head = 0;
+        other._size = 0;
+    };
+
+    Rnp_CircularBuffer &operator=(Rnp_CircularBuffer &&other) noexcept {
+        _storage = std::move(other._storage);
+        _capacity = other._capacity;
+        _head = other._head;
+        _size = other._size;
+        other._capacity = 0;
+        other._head = 0;
+        other._size = 0;
+        return *this;
+    };
+
+    /**
+     * @brief Grow the storage to hold at least capacity elements. Never
+     * shrinks.
+     *
+     * @param capacity minimum number of elements
+     */
+    void reserve(const size_t capacity) {
+        if (capacity <= _capacity) {
+            return;
+        }
+
+        // Move existing elements in order to the start of the new storage
+        std::unique_ptr<T[]> storage(new T[capacity]);
+        for (size_t i = 0; i < _size; i++) {
+            storage[i] = std::move(_storage[index(i)]);
+        }
+
+        _storage = std::move(storage);
+        _capacity = capacity;
+        _head = 0;
+    };
+
+    bool empty() const { return _size == 0; };
+
+    size_t size() const { return _size; };
+
+    size_t capacity() const { return _capacity; };
+
+    T &front() { return _storage[_head]; };
+
+    const T &front() const { return _storage[_head]; };
+
+    T &back() { return _storage[index(_size - 1)]; };
+
+    const T &back() const { return _storage[index(_size - 1)]; };
+
+    void push_back(const T &elem) { emplace_back(elem); };
+
+    void push_back(T &&elem) { emplace_back(std::move(elem)); };
+
+    /**
+     * @brief Append an element, doubling the storage if full
+     *
+     * @return T& reference to the new element
+     */
+    template <typename... ARGS>
+    T &emplace_back(ARGS &&...args) {
+        if (_size == _capacity) {
+            reserve((_capacity == 0) ? 16 : (_capacity * 2));
+        }
+        T &slot = _storage[index(_size)];
+        slot = T(std::forward<ARGS>(args)...);
+        _size++;
+        return slot;
+    }
+
+    void pop_front() {
+        _storage[_head] = T();
+        _head = (_head + 1 == _capacity) ? 0 : (_head + 1);
+        _size--;
+    };
+
+private:
+    /**
+     * @brief Convert a position relative to the head into a storage index
+     */
+    size_t index(const size_t pos) const {
+        const size_t idx = _head + pos;
+        return (idx >= _capacity) ? (idx - _capacity) : idx;
+    };
+
+    std::unique_ptr<T[]> _storage;
+
+    size_t _capacity;
+
+    size_t _head;
+
+    size_t _size;
+};
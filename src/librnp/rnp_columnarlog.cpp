@@ -0,0 +1,140 @@
+#include "rnp_columnarlog.h"
+
+#include <cstring>
+#include <string>
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+RnpColumnarLogReader::~RnpColumnarLogReader() { close(); }
+
+bool RnpColumnarLogReader::open(const std::string &path) {
+    close();
+
+#if defined(__linux__)
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size == 0) {
+        ::close(fd);
+        return false;
+    }
+
+    // Map the whole file, pages are only read as they are accessed
+    void *base = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ,
+                      MAP_PRIVATE, fd, 0);
+
+    // The mapping keeps the file open
+    ::close(fd);
+
+    if (base == MAP_FAILED) {
+        return false;
+    }
+
+    _base = static_cast<const uint8_t *>(base);
+    _size = static_cast<size_t>(info.st_size);
+
+    if (!parse()) {
+        close();
+        return false;
+    }
+    return true;
+#else
+    (void)path;
+    return false;
+#endif
+}
+
+void RnpColumnarLogReader::close() {
+#if defined(__linux__)
+    if (_base != nullptr) {
+        munmap(const_cast<uint8_t *>(_base), _size);
+    }
+#endif
+    _base = nullptr;
+    _size = 0;
+    _columns.clear();
+    _sizes.clear();
+    _chunks.clear();
+    _rowCount = 0;
+}
+
+const uint8_t *RnpColumnarLogReader::columnData(const size_t chunk,
+                                                const size_t index) const {
+    const Chunk &entry = _chunks[chunk];
+
+    // Skip the chunk header and the preceding columns
+    size_t offset =
+        entry.offset + RnpColumnarLog::align(sizeof(RnpColumnarLog::ChunkHeader));
+    for (size_t i = 0; i < index; i++) {
+        offset += RnpColumnarLog::align(entry.rows * _sizes[i]);
+    }
+
+    return _base + offset;
+}
+
+bool RnpColumnarLogReader::parse() {
+    // Check the file header
+    RnpColumnarLog::FileHeader fileHeader;
+    if (_size < sizeof(fileHeader)) {
+        return false;
+    }
+    std::memcpy(&fileHeader, _base, sizeof(fileHeader));
+
+    if (fileHeader.magic != RnpColumnarLog::magic ||
+        fileHeader.version != RnpColumnarLog::version ||
+        fileHeader.byteOrder != RnpColumnarLog::byteOrderMark ||
+        fileHeader.chunkRows == 0) {
+        return false;
+    }
+
+    const size_t headerSize =
+        RnpColumnarLog::headerSize(fileHeader.columnCount);
+    if (_size < headerSize) {
+        return false;
+    }
+
+    // Read the column descriptions
+    _columns.reserve(fileHeader.columnCount);
+    _sizes.reserve(fileHeader.columnCount);
+    for (size_t i = 0; i < fileHeader.columnCount; i++) {
+        RnpColumnarLog::ColumnHeader columnHeader;
+        std::memcpy(&columnHeader,
+                    _base + sizeof(fileHeader) + i * sizeof(columnHeader),
+                    sizeof(columnHeader));
+
+        _columns.push_back({static_cast<ELEMENT_TYPE>(columnHeader.type),
+                            columnHeader.size});
+        _sizes.push_back(columnHeader.size);
+    }
+
+    // Index the chunks, stopping at a chunk which was cut short
+    size_t offset = headerSize;
+    while (offset + sizeof(RnpColumnarLog::ChunkHeader) <= _size) {
+        RnpColumnarLog::ChunkHeader chunkHeader;
+        std::memcpy(&chunkHeader, _base + offset, sizeof(chunkHeader));
+
+        if (chunkHeader.rows == 0 || chunkHeader.rows > fileHeader.chunkRows) {
+            break;
+        }
+
+        const size_t size = RnpColumnarLog::chunkSize(
+            chunkHeader.rows, _sizes.data(), _sizes.size());
+        if (size > _size - offset) {
+            break;
+        }
+
+        _chunks.push_back({offset, chunkHeader.rows});
+        _rowCount += chunkHeader.rows;
+        offset += size;
+    }
+
+    return true;
+}
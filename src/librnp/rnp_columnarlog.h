@@ -0,0 +1,536 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "rnp_serializer.h"
+
+/**
+ * @brief Columnar binary log format
+ *
+ * A log holds frames described by an RnpSerializer. The file starts with a
+ * header describing each column (element) of the frame, followed by chunks of
+ * up to chunkRows frames. Within a chunk the values of each column are stored
+ * contiguously, so a column can be read straight out of a memory mapped file.
+ *
+ * Layout, in host byte order, unlike the little endian wire format. Columns
+ * of arrays or nested types hold their serialized bytes:
+ * - FileHeader, then a ColumnHeader per column, padded to the alignment
+ * - Chunks of a ChunkHeader followed by each column's values, every column
+ *   padded to the alignment
+ *
+ * A chunk cut short, i.e by power loss while writing, is ignored on reading.
+ */
+namespace RnpColumnarLog {
+
+    /// @brief File identifier
+    constexpr std::array<char, 8> magic = {'R', 'N', 'P', 'C', 'L', 'O', 'G', 0};
+
+    /// @brief Format version
+    constexpr uint16_t version = 1;
+
+    /// @brief Written in host byte order, to detect logs from other hosts
+    constexpr uint16_t byteOrderMark = 0x0102;
+
+    /// @brief Alignment of column data within the file
+    constexpr size_t alignment = 8;
+
+    /// @brief Default number of frames per chunk
+    constexpr uint32_t defaultChunkRows = 4096;
+
+    /**
+     * @brief File header
+     */
+    struct FileHeader {
+        /// @brief File identifier
+        std::array<char, 8> magic;
+
+        /// @brief Format version
+        uint16_t version;
+
+        /// @brief Byte order mark
+        uint16_t byteOrder;
+
+        /// @brief Number of columns
+        uint16_t columnCount;
+
+        /// @brief Reserved, zero
+        uint16_t reserved;
+
+        /// @brief Maximum number of frames per chunk
+        uint32_t chunkRows;
+
+        /// @brief Size of a serialized frame
+        uint32_t recordSize;
+    };
+
+    /**
+     * @brief Column header
+     */
+    struct ColumnHeader {
+        /// @brief Kind of value, an ELEMENT_TYPE
+        uint8_t type;
+
+        /// @brief Reserved, zero
+        uint8_t reserved;
+
+        /// @brief Size of a value
+        uint16_t size;
+    };
+
+    /**
+     * @brief Chunk header
+     */
+    struct ChunkHeader {
+        /// @brief Number of frames in the chunk
+        uint32_t rows;
+
+        /// @brief Reserved, zero
+        uint32_t reserved;
+    };
+
+    /**
+     * @brief Round a size up to the alignment
+     *
+     * @param[in] size Size
+     * @return constexpr size_t Aligned size
+     */
+    constexpr size_t align(const size_t size) {
+        return (size + alignment - 1) & ~(alignment - 1);
+    }
+
+    /**
+     * @brief Get the size of the file header and column headers
+     *
+     * @param[in] columnCount Number of columns
+     * @return constexpr size_t Header size, aligned
+     */
+    constexpr size_t headerSize(const size_t columnCount) {
+        return align(sizeof(FileHeader) + columnCount * sizeof(ColumnHeader));
+    }
+
+    /**
+     * @brief Get the size of a chunk
+     *
+     * @param[in] rows Number of frames in the chunk
+     * @param[in] sizes Size of each column's values
+     * @param[in] columnCount Number of columns
+     * @return size_t Chunk size
+     */
+    inline size_t chunkSize(const size_t rows, const size_t *sizes,
+                            const size_t columnCount) {
+        size_t size = align(sizeof(ChunkHeader));
+        for (size_t i = 0; i < columnCount; i++) {
+            size += align(rows * sizes[i]);
+        }
+        return size;
+    }
+
+} // namespace RnpColumnarLog
+
+/**
+ * @brief Writer appending frames to a columnar log
+ *
+ * Frames are serialized column by column into an in-memory chunk, which is
+ * written with a single fwrite once full, so the file sees large sequential
+ * appends. The file is owned by the caller and must be opened in binary mode.
+ * Buffered frames are written out by flush() and when the writer is
+ * destroyed, so the writer must be destroyed before the file is closed.
+ *
+ * @tparam SERIALIZER Serializer describing the frame, i.e from the frame's
+ * getSerializer()
+ */
+template <class SERIALIZER>
+class RnpColumnarLogWriter {
+public:
+    /// @brief Frame type
+    using container_t = typename SERIALIZER::container_t;
+
+    /// @brief Number of columns
+    static constexpr size_t columnCount = SERIALIZER::element_count();
+
+    static_assert(SERIALIZER::fixed_size(),
+                  "Columnar logs need frames with fixed size elements");
+
+    /**
+     * @brief Construct a new writer, writing the log header
+     *
+     * @param[in] file Output file, positioned at the start of the log
+     * @param[in] serializer Serializer describing the frame
+     * @param[in] chunkRows Maximum number of frames per chunk
+     */
+    RnpColumnarLogWriter(
+        std::FILE *file, const SERIALIZER &serializer,
+        const uint32_t chunkRows = RnpColumnarLog::defaultChunkRows)
+        : _file(file), _serializer(serializer),
+          _chunkRows(chunkRows ? chunkRows : 1) {
+        // Lay the chunk out as it is written, so a full chunk is written as is
+        size_t offset = RnpColumnarLog::align(sizeof(RnpColumnarLog::ChunkHeader));
+        for (size_t i = 0; i < columnCount; i++) {
+            _columnOffsets[i] = offset;
+            offset += RnpColumnarLog::align(_sizes[i] * _chunkRows);
+        }
+        _chunk.resize(offset);
+
+        _good = writeHeader();
+    };
+
+    RnpColumnarLogWriter(const RnpColumnarLogWriter &) = delete;
+    RnpColumnarLogWriter &operator=(const RnpColumnarLogWriter &) = delete;
+
+    /**
+     * @brief Destroy the writer, writing out any buffered frames. Must happen
+     * before the file is closed.
+     */
+    ~RnpColumnarLogWriter() { flush(); };
+
+    /**
+     * @brief Append a frame
+     *
+     * @param[in] frame Frame
+     * @return true Frame buffered or written
+     * @return false Write error, the frame was not logged
+     */
+    bool append(const container_t &frame) {
+        if (!_good) {
+            return false;
+        }
+
+        // Serialize each element into the next row of its column
+        std::array<uint8_t *, columnCount> columns;
+        for (size_t i = 0; i < columnCount; i++) {
+            columns[i] = _chunk.data() + _columnOffsets[i] + _rows * _sizes[i];
+        }
+        _serializer.serializeColumns(frame, columns.data());
+
+        // Write the chunk once full
+        _rows++;
+        _written++;
+        if (_rows == _chunkRows) {
+            return writeChunk();
+        }
+        return true;
+    };
+
+    /**
+     * @brief Write out buffered frames as a partial chunk and flush the file
+     *
+     * @return true Frames written
+     * @return false Write error
+     */
+    bool flush() {
+        if (_good && _rows) {
+            writeChunk();
+        }
+        return _good && (std::fflush(_file) == 0);
+    };
+
+    /**
+     * @brief Get the number of frames appended
+     *
+     * @return uint64_t Number of frames
+     */
+    uint64_t rows() const { return _written; };
+
+    /**
+     * @brief Check if the log is being written without errors
+     *
+     * @return true No write errors
+     */
+    bool good() const { return _good; };
+
+private:
+    /**
+     * @brief Write the file and column headers
+     *
+     * @return true Header written
+     */
+    bool writeHeader() {
+        std::vector<uint8_t> header(RnpColumnarLog::headerSize(columnCount), 0);
+
+        RnpColumnarLog::FileHeader fileHeader{};
+        fileHeader.magic = RnpColumnarLog::magic;
+        fileHeader.version = RnpColumnarLog::version;
+        fileHeader.byteOrder = RnpColumnarLog::byteOrderMark;
+        fileHeader.columnCount = static_cast<uint16_t>(columnCount);
+        fileHeader.chunkRows = _chunkRows;
+        fileHeader.recordSize =
+            static_cast<uint32_t>(SERIALIZER::member_size());
+        std::memcpy(header.data(), &fileHeader, sizeof(fileHeader));
+
+        // Describe each column after the file header
+        constexpr auto types = SERIALIZER::element_types();
+        for (size_t i = 0; i < columnCount; i++) {
+            RnpColumnarLog::ColumnHeader columnHeader{};
+            columnHeader.type = static_cast<uint8_t>(types[i]);
+            columnHeader.size = static_cast<uint16_t>(_sizes[i]);
+            std::memcpy(header.data() + sizeof(fileHeader) +
+                            i * sizeof(columnHeader),
+                        &columnHeader, sizeof(columnHeader));
+        }
+
+        return std::fwrite(header.data(), 1, header.size(), _file) ==
+               header.size();
+    };
+
+    /**
+     * @brief Write the buffered frames as a chunk
+     *
+     * @return true Chunk written
+     */
+    bool writeChunk() {
+        RnpColumnarLog::ChunkHeader chunkHeader{};
+        chunkHeader.rows = _rows;
+        std::memcpy(_chunk.data(), &chunkHeader, sizeof(chunkHeader));
+
+        if (_rows == _chunkRows) {
+            // Full chunks are already laid out as in the file
+            _good = std::fwrite(_chunk.data(), 1, _chunk.size(), _file) ==
+                    _chunk.size();
+        } else {
+            // Partial chunks have shorter columns, so write them one by one
+            _good = writeBlock(_chunk.data(),
+                               RnpColumnarLog::align(sizeof(chunkHeader)));
+            for (size_t i = 0; i < columnCount && _good; i++) {
+                _good = writeBlock(_chunk.data() + _columnOffsets[i],
+                                   RnpColumnarLog::align(_rows * _sizes[i]));
+            }
+        }
+
+        _rows = 0;
+        return _good;
+    };
+
+    /**
+     * @brief Write a block, the end of which is padding
+     *
+     * @param[in] data Block
+     * @param[in] size Block size
+     * @return true Block written
+     */
+    bool writeBlock(const uint8_t *data, const size_t size) {
+        return std::fwrite(data, 1, size, _file) == size;
+    };
+
+    /// @brief Output file
+    std::FILE *const _file;
+
+    /// @brief Frame serializer
+    const SERIALIZER _serializer;
+
+    /// @brief Size of each column's values
+    static constexpr std::array<size_t, columnCount> _sizes =
+        SERIALIZER::element_sizes();
+
+    /// @brief Maximum number of frames per chunk
+    const uint32_t _chunkRows;
+
+    /// @brief Offset of each column within the chunk
+    std::array<size_t, columnCount> _columnOffsets;
+
+    /// @brief Chunk being filled, laid out as in the file
+    std::vector<uint8_t> _chunk;
+
+    /// @brief Number of frames in the chunk
+    uint32_t _rows = 0;
+
+    /// @brief Total number of frames appended
+    uint64_t _written = 0;
+
+    /// @brief No write errors
+    bool _good = false;
+};
+
+/**
+ * @brief Description of a column in a columnar log
+ */
+struct RnpColumnInfo {
+    /// @brief Kind of value
+    ELEMENT_TYPE type;
+
+    /// @brief Size of a value
+    size_t size;
+};
+
+/**
+ * @brief Typed view of a column within a chunk of a columnar log
+ *
+ * @tparam T Value type
+ */
+template <class T>
+class RnpColumnView {
+public:
+    constexpr RnpColumnView() : _data(nullptr), _rows(0){};
+
+    constexpr RnpColumnView(const T *data, const size_t rows)
+        : _data(data), _rows(rows){};
+
+    const T *data() const { return _data; };
+
+    size_t size() const { return _rows; };
+
+    bool empty() const { return _rows == 0; };
+
+    const T *begin() const { return _data; };
+
+    const T *end() const { return _data + _rows; };
+
+    const T &operator[](const size_t row) const { return _data[row]; };
+
+private:
+    const T *_data;
+
+    size_t _rows;
+};
+
+/**
+ * @brief Reader giving zero-copy access to the columns of a columnar log
+ *
+ * The file is memory mapped, so only the parts which are accessed are read
+ * from disk and logs larger than memory can be read. Opening only visits the
+ * chunk headers to index the chunks.
+ *
+ * @note Only available on Linux, open() fails elsewhere.
+ */
+class RnpColumnarLogReader {
+public:
+    RnpColumnarLogReader() = default;
+
+    RnpColumnarLogReader(const RnpColumnarLogReader &) = delete;
+    RnpColumnarLogReader &operator=(const RnpColumnarLogReader &) = delete;
+
+    /**
+     * @brief Destroy the reader, unmapping the file
+     */
+    ~RnpColumnarLogReader();
+
+    /**
+     * @brief Open and index a log
+     *
+     * @param[in] path Log file path
+     * @return true Log opened
+     * @return false File could not be mapped or is not a columnar log from a
+     * host with the same byte order
+     */
+    bool open(const std::string &path);
+
+    /**
+     * @brief Close the log
+     */
+    void close();
+
+    /**
+     * @brief Check if a log is open
+     */
+    bool isOpen() const { return _base != nullptr; };
+
+    /**
+     * @brief Get the number of columns
+     */
+    size_t columnCount() const { return _columns.size(); };
+
+    /**
+     * @brief Get the description of a column
+     *
+     * @param[in] index Column index, in serialization order
+     * @return const RnpColumnInfo& Column description
+     */
+    const RnpColumnInfo &columnInfo(const size_t index) const {
+        return _columns.at(index);
+    };
+
+    /**
+     * @brief Get the number of chunks
+     */
+    size_t chunkCount() const { return _chunks.size(); };
+
+    /**
+     * @brief Get the number of frames in a chunk
+     *
+     * @param[in] chunk Chunk index
+     * @return size_t Number of frames
+     */
+    size_t chunkRows(const size_t chunk) const {
+        return _chunks.at(chunk).rows;
+    };
+
+    /**
+     * @brief Get the total number of frames
+     */
+    uint64_t rowCount() const { return _rowCount; };
+
+    /**
+     * @brief Get a typed view of a column within a chunk
+     *
+     * The view points into the mapped file and is valid until the log is
+     * closed.
+     *
+     * @tparam T Value type, must match the type and size of the column
+     * @param[in] chunk Chunk index
+     * @param[in] index Column index, in serialization order
+     * @return RnpColumnView<T> Column view, empty if out of range or the type
+     * does not match
+     */
+    template <class T>
+    RnpColumnView<T> column(const size_t chunk, const size_t index) const {
+        if (chunk >= _chunks.size() || index >= _columns.size() ||
+            _columns[index].size != sizeof(T) ||
+            _columns[index].type != element_type_of<T>()) {
+            return {};
+        }
+
+        return {reinterpret_cast<const T *>(columnData(chunk, index)),
+                _chunks[chunk].rows};
+    }
+
+private:
+    /**
+     * @brief Chunk index entry
+     */
+    struct Chunk {
+        /// @brief Offset of the chunk in the file
+        size_t offset;
+
+        /// @brief Number of frames
+        size_t rows;
+    };
+
+    /**
+     * @brief Get the start of a column within a chunk
+     *
+     * @param[in] chunk Chunk index
+     * @param[in] index Column index
+     * @return const uint8_t* Column data
+     */
+    const uint8_t *columnData(const size_t chunk, const size_t index) const;
+
+    /**
+     * @brief Parse the header and index the chunks of the mapped file
+     *
+     * @return true Valid log
+     */
+    bool parse();
+
+    /// @brief Mapped file
+    const uint8_t *_base = nullptr;
+
+    /// @brief Mapped size
+    size_t _size = 0;
+
+    /// @brief Columns
+    std::vector<RnpColumnInfo> _columns;
+
+    /// @brief Size of each column's values, for chunk size calculations
+    std::vector<size_t> _sizes;
+
+    /// @brief Chunk index
+    std::vector<Chunk> _chunks;
+
+    /// @brief Total number of frames
+    uint64_t _rowCount = 0;
+};
@@ -0,0 +1,27 @@
+#include "rnp_decode.h"
+
+#include <cstdlib>
+
+const char *rnpDecodeErrorString(const RnpDecodeError error) {
+    switch (error) {
+    case RnpDecodeError::NONE:
+        return "No error";
+    case RnpDecodeError::HEADER_TOO_SHORT:
+        return "Buffer too small to deserialize header from";
+    case RnpDecodeError::LENGTH_MISMATCH:
+        return "Header size does not match expected size!";
+    case RnpDecodeError::BODY_SIZE_MISMATCH:
+        return "Buffer len does not match expected size!";
+    }
+    return "Unknown decode error";
+}
+
+void rnpDecodeFailed(const RnpDecodeError error) {
+#if defined(__cpp_exceptions)
+    throw RnpDecodeException(error);
+#else
+    // Nothing can be returned from a constructor, use tryDecode() instead
+    (void)error;
+    std::abort();
+#endif
+}
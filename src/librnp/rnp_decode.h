@@ -0,0 +1,147 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <utility>
+
+#if defined(__cpp_exceptions)
+#include <stdexcept>
+#endif
+
+/**
+ * @brief Enumerate for the reasons a packet could not be decoded
+ */
+enum class RnpDecodeError : uint8_t {
+    /// @brief Decoded successfully
+    NONE = 0,
+
+    /// @brief Buffer too small to contain a header
+    HEADER_TOO_SHORT = 1,
+
+    /// @brief Packet length in the header does not match the packet type
+    LENGTH_MISMATCH = 2,
+
+    /// @brief Size of the received body does not match the packet type
+    BODY_SIZE_MISMATCH = 3,
+};
+
+/**
+ * @brief Get a description of a decode error
+ *
+ * @param[in] error Decode error
+ * @return const char* Description
+ */
+const char *rnpDecodeErrorString(const RnpDecodeError error);
+
+/**
+ * @brief Report a decode error from a constructor which cannot return it
+ *
+ * Throws RnpDecodeException, or aborts if exceptions are disabled. Code which
+ * must handle malformed packets should use the tryDecode() factories instead.
+ *
+ * @param[in] error Decode error
+ */
+[[noreturn]] void rnpDecodeFailed(const RnpDecodeError error);
+
+#if defined(__cpp_exceptions)
+/**
+ * @brief Exception thrown by the decoding constructors
+ */
+class RnpDecodeException : public std::runtime_error {
+public:
+    /**
+     * @brief Construct a new Rnp Decode Exception object
+     *
+     * @param[in] error Decode error
+     */
+    explicit RnpDecodeException(const RnpDecodeError error)
+        : std::runtime_error(rnpDecodeErrorString(error)), _error(error){};
+
+    /**
+     * @brief Get the decode error
+     */
+    RnpDecodeError error() const { return _error; };
+
+private:
+    /// @brief Decode error
+    RnpDecodeError _error;
+};
+#endif
+
+/**
+ * @brief Tag selecting the decoding constructor of a packet which skips the
+ * size checks, used by tryDecode() once the packet has been validated
+ */
+struct RnpPrevalidated {};
+
+/// @brief Instance of the prevalidated tag
+constexpr RnpPrevalidated rnpPrevalidated{};
+
+/**
+ * @brief Result of a tryDecode(), holding either the decoded value or the
+ * reason it could not be decoded
+ *
+ * @tparam T Decoded type
+ */
+template <class T>
+class RnpDecodeResult {
+public:
+    /**
+     * @brief Construct a failed result
+     *
+     * @param[in] error Decode error
+     */
+    RnpDecodeResult(const RnpDecodeError error) : _error(error){};
+
+    /**
+     * @brief Construct a successful result, constructing the value in place
+     *
+     * @param[in] args Value constructor arguments
+     */
+    template <typename... ARGS>
+    explicit RnpDecodeResult(std::in_place_t, ARGS &&...args)
+        : _value(std::in_place, std::forward<ARGS>(args)...),
+          _error(RnpDecodeError::NONE) {}
+
+    /**
+     * @brief Check if the value was decoded
+     */
+    bool ok() const { return _error == RnpDecodeError::NONE; };
+
+    /**
+     * @brief Check if the value was decoded
+     */
+    explicit operator bool() const { return ok(); };
+
+    /**
+     * @brief Get the reason decoding failed
+     *
+     * @return RnpDecodeError Decode error, NONE if decoded
+     */
+    RnpDecodeError error() const { return _error; };
+
+    /**
+     * @brief Get the decoded value, which must exist
+     */
+    T &value() { return *_value; };
+
+    /**
+     * @brief Get the decoded value, which must exist
+     */
+    const T &value() const { return *_value; };
+
+    T &operator*() { return *_value; };
+
+    const T &operator*() const { return *_value; };
+
+    T *operator->() { return &*_value; };
+
+    const T *operator->() const { return &*_value; };
+
+private:
+    /// @brief Decoded value
+    std::optional<T> _value;
+
+    /// @brief Decode error
+    RnpDecodeError _error;
+};
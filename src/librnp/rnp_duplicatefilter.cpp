@@ -0,0 +1,105 @@
+#include "rnp_duplicatefilter.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+#include "rnp_header.h"
+
+void RnpDuplicateFilter::configure(const uint32_t window,
+                                   const size_t capacity) {
+    _window = window;
+
+    // Round the slots per bucket up to a power of two, keeping the load factor
+    // at or below a half
+    const size_t perBucket = std::max<size_t>(capacity / buckets, 1);
+    size_t slots = 2;
+    while (slots < (perBucket * 2)) {
+        slots <<= 1;
+    }
+
+    _bucketMask = slots - 1;
+    _bucketLimit = slots / 2;
+    _slots.assign(enabled() ? (slots * buckets) : 0, 0);
+
+    clear();
+}
+
+bool RnpDuplicateFilter::isDuplicate(const RnpHeader &header,
+                                     const uint32_t now) {
+    // Packets without an identifier cannot be matched
+    if (!enabled() || (header.uid == 0)) {
+        return false;
+    }
+
+    // Forget packets older than the window
+    advance(now);
+
+    // Pack the identifier, never 0 as the uid is not 0
+    const uint32_t key = (static_cast<uint32_t>(header.source) << 24) |
+                         (static_cast<uint32_t>(header.uid) << 8) |
+                         static_cast<uint32_t>(header.type);
+
+    // Multiplicative hash, taking the high bits
+    const size_t hash = static_cast<uint32_t>(key * 2654435761u) >> 16;
+
+    // Look for the identifier in every bucket
+    for (size_t i = 0; i < buckets; i++) {
+        const uint32_t *slots = bucket(i);
+        for (size_t pos = hash & _bucketMask; slots[pos] != 0;
+             pos = (pos + 1) & _bucketMask) {
+            if (slots[pos] == key) {
+                return true;
+            }
+        }
+    }
+
+    // Move on early if the current bucket is full
+    if (_bucketCount[_current] >= _bucketLimit) {
+        rotate();
+        _bucketStart = now;
+    }
+
+    // Record the identifier in the current bucket
+    uint32_t *slots = bucket(_current);
+    size_t pos = hash & _bucketMask;
+    while (slots[pos] != 0) {
+        pos = (pos + 1) & _bucketMask;
+    }
+    slots[pos] = key;
+    _bucketCount[_current]++;
+
+    return false;
+}
+
+void RnpDuplicateFilter::clear() {
+    std::fill(_slots.begin(), _slots.end(), 0);
+    std::fill(std::begin(_bucketCount), std::end(_bucketCount), 0);
+    _current = 0;
+    _bucketStart = 0;
+}
+
+void RnpDuplicateFilter::advance(const uint32_t now) {
+    // Time covered by each bucket
+    const uint32_t span = std::max<uint32_t>(_window / buckets, 1);
+
+    // Forget everything if the whole window has passed
+    if (static_cast<uint32_t>(now - _bucketStart) >= (span * buckets)) {
+        clear();
+        _bucketStart = now;
+        return;
+    }
+
+    // Clear each bucket whose slice has passed
+    while (static_cast<uint32_t>(now - _bucketStart) >= span) {
+        rotate();
+        _bucketStart += span;
+    }
+}
+
+void RnpDuplicateFilter::rotate() {
+    // Reuse the oldest bucket
+    _current = (_current + 1) % buckets;
+    std::fill(bucket(_current), bucket(_current) + _bucketMask + 1, 0);
+    _bucketCount[_current] = 0;
+}
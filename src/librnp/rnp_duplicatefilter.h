@@ -0,0 +1,120 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "rnp_header.h"
+
+/**
+ * @brief Fixed memory filter for recently seen packets
+ *
+ * Packets are identified by their (source, uid, type), which packs exactly
+ * into 32 bits, so there are no false positives. Identifiers are recorded in a
+ * ring of time buckets, each an open addressing hash set covering an equal
+ * slice of the window. When the clock moves on, the oldest bucket is cleared
+ * and reused, so an identifier is remembered for between (buckets - 1) and
+ * buckets slices of the window.
+ *
+ * Storage is only allocated by configure(). If a bucket fills up before its
+ * slice of the window ends, the ring is advanced early, which shortens the
+ * window rather than dropping identifiers from the current bucket.
+ *
+ * Packets with a uid of 0 have not been assigned an identifier and are never
+ * treated as duplicates.
+ */
+class RnpDuplicateFilter {
+public:
+    /// @brief Number of time buckets the window is divided into
+    static constexpr size_t buckets = 4;
+
+    /**
+     * @brief Construct a disabled duplicate filter
+     */
+    RnpDuplicateFilter() : _window(0), _bucketMask(0), _bucketLimit(0){};
+
+    /**
+     * @brief Construct a duplicate filter
+     *
+     * @param[in] window Time in milliseconds packets are remembered for, 0
+     * disables the filter
+     * @param[in] capacity Number of packets which can be remembered over the
+     * window
+     */
+    RnpDuplicateFilter(const uint32_t window, const size_t capacity)
+        : RnpDuplicateFilter() {
+        configure(window, capacity);
+    };
+
+    /**
+     * @brief Reconfigure the filter, forgetting all recorded packets
+     *
+     * @param[in] window Time in milliseconds packets are remembered for, 0
+     * disables the filter
+     * @param[in] capacity Number of packets which can be remembered over the
+     * window
+     */
+    void configure(const uint32_t window, const size_t capacity);
+
+    /**
+     * @brief Check if the filter is enabled
+     */
+    bool enabled() const { return _window != 0; };
+
+    /**
+     * @brief Check if a packet has been seen within the window, recording it
+     * if not
+     *
+     * @param[in] header Packet header
+     * @param[in] now Current time in milliseconds
+     * @return true if the packet is a duplicate
+     */
+    bool isDuplicate(const RnpHeader &header, const uint32_t now);
+
+    /**
+     * @brief Forget all recorded packets
+     */
+    void clear();
+
+private:
+    /**
+     * @brief Clear buckets whose slice of the window has passed
+     *
+     * @param[in] now Current time in milliseconds
+     */
+    void advance(const uint32_t now);
+
+    /**
+     * @brief Move on to the next bucket, clearing it
+     */
+    void rotate();
+
+    /**
+     * @brief Get the first slot of a bucket
+     */
+    uint32_t *bucket(const size_t index) {
+        return _slots.data() + (index * (_bucketMask + 1));
+    };
+
+    /// @brief Window in milliseconds
+    uint32_t _window;
+
+    /// @brief Hash set slots, buckets laid out one after another. 0 marks an
+    /// empty slot.
+    std::vector<uint32_t> _slots;
+
+    /// @brief Number of slots in a bucket minus one
+    size_t _bucketMask;
+
+    /// @brief Maximum number of identifiers in a bucket
+    size_t _bucketLimit;
+
+    /// @brief Number of identifiers in each bucket
+    size_t _bucketCount[buckets] = {};
+
+    /// @brief Bucket identifiers are being recorded in
+    size_t _current = 0;
+
+    /// @brief Time the current bucket started
+    uint32_t _bucketStart = 0;
+};
@@ -0,0 +1,191 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+/**
+ * @brief Byte order of the wire format
+ *
+ * Everything serialized by librnp is little endian, so nodes with different
+ * host byte orders can share a network. On little endian hosts, i.e x86, ARM
+ * and the ESP32, every function here is a plain copy chosen at compile time.
+ * On big endian hosts multi-byte arithmetic values are byte swapped.
+ */
+namespace RnpEndian {
+
+/// @brief Host is little endian, so values are already in wire order
+#if defined(__BYTE_ORDER__) && defined(__ORDER_BIG_ENDIAN__) &&                \
+    __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+constexpr bool little = false;
+#else
+constexpr bool little = true;
+#endif
+
+/**
+ * @brief Unsigned integer with the same size as a value, used to byte swap
+ * its representation
+ *
+ * @tparam SIZE Size in bytes
+ */
+template <size_t SIZE>
+struct bits {};
+
+template <>
+struct bits<2> {
+    using type = uint16_t;
+};
+
+template <>
+struct bits<4> {
+    using type = uint32_t;
+};
+
+template <>
+struct bits<8> {
+    using type = uint64_t;
+};
+
+/**
+ * @brief Check if a type has a byte order, i.e it is a multi-byte arithmetic
+ * or enum type
+ *
+ * Other trivially copyable types are copied as they are.
+ *
+ * @tparam T Type
+ */
+template <class T>
+constexpr bool ordered =
+    (std::is_arithmetic_v<T> || std::is_enum_v<T>) && sizeof(T) > 1;
+
+/**
+ * @brief Check if a type must be byte swapped between host and wire order
+ *
+ * @tparam T Type
+ */
+template <class T>
+constexpr bool swapped = !little && ordered<T>;
+
+/**
+ * @brief Reverse the bytes of an unsigned integer
+ *
+ * @tparam U Unsigned integer type
+ * @param[in] value Value
+ * @return constexpr U Byte swapped value
+ */
+template <class U>
+constexpr U byteswap(const U value) {
+    static_assert(std::is_unsigned_v<U>, "Byte swap an unsigned integer");
+
+#if defined(__GNUC__)
+    if constexpr (sizeof(U) == 2) {
+        return __builtin_bswap16(value);
+    } else if constexpr (sizeof(U) == 4) {
+        return __builtin_bswap32(value);
+    } else if constexpr (sizeof(U) == 8) {
+        return __builtin_bswap64(value);
+    }
+#endif
+
+    U result = 0;
+    for (size_t i = 0; i < sizeof(U); i++) {
+        result |= static_cast<U>((value >> (8 * i)) & 0xFF)
+                  << (8 * (sizeof(U) - 1 - i));
+    }
+    return result;
+}
+
+/**
+ * @brief Copy an array of values, reversing the bytes of each
+ *
+ * Written as a plain loop over the values so the compiler vectorizes it,
+ * swapping several values per instruction.
+ *
+ * @tparam T Value type, with a size of 2, 4 or 8 bytes
+ * @param[out] dst Output bytes
+ * @param[in] src Input bytes
+ * @param[in] count Number of values
+ */
+template <class T>
+void copySwapped(uint8_t *__restrict dst, const uint8_t *__restrict src,
+                 const size_t count) {
+    static_assert(sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8,
+                  "Only 2, 4 and 8 byte values can be byte swapped");
+    using U = typename bits<sizeof(T)>::type;
+
+    for (size_t i = 0; i < count; i++) {
+        U value;
+        std::memcpy(&value, src + i * sizeof(U), sizeof(U));
+        value = byteswap(value);
+        std::memcpy(dst + i * sizeof(U), &value, sizeof(U));
+    }
+}
+
+/**
+ * @brief Write a value in wire order
+ *
+ * @tparam T Trivially copyable type
+ * @param[out] dst Output location, sizeof(T) bytes
+ * @param[in] value Value
+ */
+template <class T>
+void store(uint8_t *dst, const T &value) {
+    if constexpr (swapped<T>) {
+        copySwapped<T>(dst, reinterpret_cast<const uint8_t *>(&value), 1);
+    } else {
+        std::memcpy(dst, &value, sizeof(T));
+    }
+}
+
+/**
+ * @brief Read a value from wire order
+ *
+ * @tparam T Trivially copyable type
+ * @param[out] value Value
+ * @param[in] src Input location, sizeof(T) bytes
+ */
+template <class T>
+void load(T &value, const uint8_t *src) {
+    if constexpr (swapped<T>) {
+        copySwapped<T>(reinterpret_cast<uint8_t *>(&value), src, 1);
+    } else {
+        std::memcpy(&value, src, sizeof(T));
+    }
+}
+
+/**
+ * @brief Write an array of values in wire order
+ *
+ * @tparam T Trivially copyable type
+ * @param[out] dst Output location, count * sizeof(T) bytes
+ * @param[in] values Values
+ * @param[in] count Number of values
+ */
+template <class T>
+void storeArray(uint8_t *dst, const T *values, const size_t count) {
+    if constexpr (swapped<T>) {
+        copySwapped<T>(dst, reinterpret_cast<const uint8_t *>(values), count);
+    } else {
+        std::memcpy(dst, values, count * sizeof(T));
+    }
+}
+
+/**
+ * @brief Read an array of values from wire order
+ *
+ * @tparam T Trivially copyable type
+ * @param[out] values Values
+ * @param[in] src Input location, count * sizeof(T) bytes
+ * @param[in] count Number of values
+ */
+template <class T>
+void loadArray(T *values, const uint8_t *src, const size_t count) {
+    if constexpr (swapped<T>) {
+        copySwapped<T>(reinterpret_cast<uint8_t *>(values), src, count);
+    } else {
+        std::memcpy(values, src, count * sizeof(T));
+    }
+}
+
+} // namespace RnpEndian
@@ -0,0 +1,231 @@
+#include "rnp_eventloop.h"
+
+#if defined(__linux__)
+
+#include <bitset>
+#include <cerrno>
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+/// @brief epoll data for the wake descriptor, interfaces use their identifier
+static constexpr uint64_t wakeTag = 1 << 8;
+
+/// @brief epoll data for timers, combined with the timer index
+static constexpr uint64_t timerTag = 1 << 9;
+
+/// @brief Maximum number of events handled per wait
+static constexpr int maxEvents = 64;
+
+RnpEventLoop::RnpEventLoop(RnpNetworkManager &netman,
+                           const uint32_t pollInterval_ms)
+    : _netman(netman), _pollInterval(static_cast<int>(pollInterval_ms)),
+      _epollFd(::epoll_create1(EPOLL_CLOEXEC)),
+      _wakeFd(::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)), _queued(false),
+      _stop(false), _updates(0) {
+    // Register the wake descriptor
+    if (valid()) {
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.u64 = wakeTag;
+        ::epoll_ctl(_epollFd, EPOLL_CTL_ADD, _wakeFd, &event);
+    }
+};
+
+RnpEventLoop::~RnpEventLoop() {
+    // Close the timers
+    for (const auto &timer : _timers) {
+        ::close(timer.fd);
+    }
+
+    // Close the wake descriptor and the epoll instance, which unregisters the
+    // interfaces
+    if (_wakeFd >= 0) {
+        ::close(_wakeFd);
+    }
+    if (_epollFd >= 0) {
+        ::close(_epollFd);
+    }
+};
+
+bool RnpEventLoop::addTimer(const uint32_t period_ms, TimerCb_t callback) {
+    // Reject a zero period, which would disarm the timer
+    if (!valid() || (period_ms == 0)) {
+        return false;
+    }
+
+    const int fd =
+        ::timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+
+    // Fire every period, starting one period from now
+    itimerspec spec{};
+    spec.it_interval.tv_sec = period_ms / 1000;
+    spec.it_interval.tv_nsec = static_cast<long>(period_ms % 1000) * 1000000;
+    spec.it_value = spec.it_interval;
+
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.u64 = timerTag | _timers.size();
+    if ((::timerfd_settime(fd, 0, &spec, nullptr) != 0) ||
+        (::epoll_ctl(_epollFd, EPOLL_CTL_ADD, fd, &event) != 0)) {
+        ::close(fd);
+        return false;
+    }
+
+    _timers.push_back({fd, std::move(callback)});
+    return true;
+};
+
+bool RnpEventLoop::syncInterfaces() {
+    const std::vector<RnpInterface *> &interfaces = _netman.getInterfaces();
+    if (_registered.size() < interfaces.size()) {
+        _registered.resize(interfaces.size(), -1);
+        _registeredIface.resize(interfaces.size(), nullptr);
+    }
+
+    // Unregister the descriptors which changed first, so a descriptor number
+    // reused by another interface is not unregistered after it is added
+    bool changed = false;
+    for (size_t id = 0; id < _registered.size(); id++) {
+        RnpInterface *iface =
+            (id < interfaces.size()) ? interfaces[id] : nullptr;
+        const int fd = (iface != nullptr) ? iface->getPollFd() : -1;
+        if ((iface == _registeredIface[id]) && (fd == _registered[id])) {
+            continue;
+        }
+
+        // The descriptor may already be closed, which unregistered it
+        if (_registered[id] >= 0) {
+            ::epoll_ctl(_epollFd, EPOLL_CTL_DEL, _registered[id], nullptr);
+        }
+        _registered[id] = -1;
+        _registeredIface[id] = iface;
+        changed = true;
+    }
+
+    // Register the new descriptors, and find interfaces to poll
+    bool polling = false;
+    for (size_t id = 0; id < interfaces.size(); id++) {
+        RnpInterface *iface = interfaces[id];
+        if (iface == nullptr) {
+            continue;
+        }
+        polling |= iface->requiresPolling();
+
+        if (!changed || (_registered[id] >= 0)) {
+            continue;
+        }
+        const int fd = iface->getPollFd();
+        if (fd < 0) {
+            continue;
+        }
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.u64 = id;
+        if (::epoll_ctl(_epollFd, EPOLL_CTL_ADD, fd, &event) == 0) {
+            _registered[id] = fd;
+        }
+    }
+
+    return polling;
+};
+
+size_t RnpEventLoop::runOnce(const int timeout_ms) {
+    if (!valid()) {
+        return 0;
+    }
+
+    const bool polling = syncInterfaces();
+
+    // Don't wait with packets queued, and wait at most the poll interval if
+    // interfaces need polling
+    int timeout = timeout_ms;
+    if (_queued) {
+        timeout = 0;
+    } else if (polling &&
+               ((timeout < 0) || (timeout > _pollInterval))) {
+        timeout = _pollInterval;
+    }
+
+    epoll_event events[maxEvents];
+    int count = ::epoll_wait(_epollFd, events, maxEvents, timeout);
+    if (count < 0) {
+        // Interrupted by a signal
+        count = 0;
+    }
+
+    // Collect the interfaces with data waiting, and run the timers which
+    // fired so packets they send are routed in this update
+    std::bitset<256> ready;
+    _ready.clear();
+    for (int i = 0; i < count; i++) {
+        const uint64_t tag = events[i].data.u64;
+        uint64_t value;
+        if (tag == wakeTag) {
+            // Reset the wake counter
+            (void)!::read(_wakeFd, &value, sizeof(value));
+        } else if ((tag & timerTag) != 0) {
+            // Acknowledge the expiry, and skip spurious wakeups
+            const size_t index = static_cast<size_t>(tag & ~timerTag);
+            if ((index < _timers.size()) &&
+                (::read(_timers[index].fd, &value, sizeof(value)) ==
+                 sizeof(value))) {
+                _timers[index].callback();
+            }
+        } else if (!ready.test(tag)) {
+            ready.set(tag);
+            _ready.push_back(static_cast<uint8_t>(tag));
+        }
+    }
+
+    // Nothing to do
+    if ((count == 0) && !polling && !_queued) {
+        return 0;
+    }
+
+    // Add the interfaces which need polling
+    if (polling) {
+        const std::vector<RnpInterface *> &interfaces =
+            _netman.getInterfaces();
+        for (size_t id = 0; id < interfaces.size(); id++) {
+            if ((interfaces[id] != nullptr) && !ready.test(id) &&
+                interfaces[id]->requiresPolling()) {
+                _ready.push_back(static_cast<uint8_t>(id));
+            }
+        }
+    }
+
+    const RnpUpdateResult result = _netman.update(_ready);
+    _queued = (result.queued > 0);
+    _updates++;
+
+    return static_cast<size_t>(count);
+};
+
+void RnpEventLoop::run() {
+    while (!_stop.load(std::memory_order_acquire)) {
+        runOnce();
+    }
+
+    // Allow the loop to be run again
+    _stop.store(false, std::memory_order_release);
+};
+
+void RnpEventLoop::stop() {
+    _stop.store(true, std::memory_order_release);
+    wake();
+};
+
+void RnpEventLoop::wake() {
+    // A write can only fail if the counter would overflow, in which case the
+    // loop is already woken
+    const uint64_t value = 1;
+    (void)!::write(_wakeFd, &value, sizeof(value));
+};
+
+#endif
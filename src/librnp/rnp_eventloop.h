@@ -0,0 +1,163 @@
+#pragma once
+
+#if defined(__linux__)
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "rnp_networkmanager.h"
+
+/**
+ * @brief Event driven runner for a network manager (Linux only)
+ *
+ * An alternative to calling RnpNetworkManager::update() continuously, which
+ * keeps a core busy even when every interface is idle. The loop blocks in
+ * epoll_wait() until an interface's getPollFd() is readable, a timer fires,
+ * or wake() is called, and then updates only the interfaces with data
+ * waiting. Interfaces which requiresPolling() are updated every poll
+ * interval instead, and the loop does not block while packets are queued.
+ *
+ * The loop runs on a single thread, like update(). Packets sent from that
+ * thread (i.e from service handlers or timers) are transmitted at the end
+ * of the update. Other code which sends packets between runs of the loop, or
+ * from another thread with a lock-free packet buffer, should call wake() so
+ * they are flushed without waiting for the next event.
+ *
+ * Embedded targets, and applications with their own main loop, keep calling
+ * update() directly.
+ */
+class RnpEventLoop {
+public:
+    /// @brief Timer callback
+    using TimerCb_t = std::function<void()>;
+
+    /**
+     * @brief Construct a new Event Loop object
+     *
+     * @param[in] netman Network manager, the loop registers the interfaces
+     * added to it
+     * @param[in] pollInterval_ms Interval at which interfaces which require
+     * polling are updated, in milliseconds
+     */
+    explicit RnpEventLoop(RnpNetworkManager &netman,
+                          const uint32_t pollInterval_ms = 1);
+
+    RnpEventLoop(const RnpEventLoop &) = delete;
+    RnpEventLoop &operator=(const RnpEventLoop &) = delete;
+
+    /**
+     * @brief Destroy the Event Loop object, closing the epoll, wake and timer
+     * descriptors
+     */
+    ~RnpEventLoop();
+
+    /**
+     * @brief Check the loop's descriptors were created
+     *
+     * @return true The loop can run
+     * @return false epoll or eventfd could not be created
+     */
+    bool valid() const { return (_epollFd >= 0) && (_wakeFd >= 0); };
+
+    /**
+     * @brief Call a function periodically from the loop, before the update in
+     * which it fires
+     *
+     * @param[in] period_ms Period in milliseconds
+     * @param[in] callback Function to call
+     * @return true Timer added
+     * @return false The timer could not be created
+     */
+    bool addTimer(const uint32_t period_ms, TimerCb_t callback);
+
+    /**
+     * @brief Wait for events and update the network manager once
+     *
+     * Does not wait if packets were left queued by the previous update, and
+     * waits at most the poll interval if any interface requires polling.
+     *
+     * @param[in] timeout_ms Longest wait in milliseconds, -1 to wait until an
+     * event
+     * @return size_t Number of events handled, the network manager is only
+     * updated if there were events or interfaces to poll or packets queued
+     */
+    size_t runOnce(const int timeout_ms = -1);
+
+    /**
+     * @brief Run the loop until stop() is called
+     */
+    void run();
+
+    /**
+     * @brief Stop run() at the end of the current update. Thread safe.
+     */
+    void stop();
+
+    /**
+     * @brief Wake the loop, so the network manager is updated. Thread safe,
+     * and async signal safe.
+     */
+    void wake();
+
+    /**
+     * @brief Get the number of times the network manager was updated
+     */
+    uint64_t getUpdateCount() const { return _updates; };
+
+private:
+    /**
+     * @brief Register interfaces added since the last update, and re-register
+     * those whose descriptor changed
+     *
+     * @return true An interface requires polling
+     * @return false All interfaces can be waited on
+     */
+    bool syncInterfaces();
+
+    /// @brief Periodic timer
+    struct Timer {
+        /// @brief timerfd
+        int fd;
+
+        /// @brief Function to call
+        TimerCb_t callback;
+    };
+
+    /// @brief Network manager
+    RnpNetworkManager &_netman;
+
+    /// @brief Poll interval in milliseconds
+    const int _pollInterval;
+
+    /// @brief epoll instance
+    int _epollFd;
+
+    /// @brief eventfd signalled by wake()
+    int _wakeFd;
+
+    /// @brief Descriptor registered for each interface, by identifier, -1 if
+    /// none
+    std::vector<int> _registered;
+
+    /// @brief Interface each registered descriptor belongs to, by identifier
+    std::vector<RnpInterface *> _registeredIface;
+
+    /// @brief Timers
+    std::vector<Timer> _timers;
+
+    /// @brief Identifiers of the interfaces to update, reused between updates
+    std::vector<uint8_t> _ready;
+
+    /// @brief Packets were left queued by the last update
+    bool _queued;
+
+    /// @brief stop() has been called
+    std::atomic<bool> _stop;
+
+    /// @brief Number of updates
+    uint64_t _updates;
+};
+
+#endif
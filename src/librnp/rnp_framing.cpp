@@ -0,0 +1,169 @@
+#include "rnp_framing.h"
+
+#include <array>
+#include <cstring>
+
+#include "rnp_endian.h"
+
+namespace {
+
+/**
+ * @brief Generate the CRC-16/CCITT lookup table (polynomial 0x1021)
+ */
+constexpr std::array<uint16_t, 256> crcTable() {
+    std::array<uint16_t, 256> table{};
+    for (size_t i = 0; i < 256; i++) {
+        uint16_t crc = static_cast<uint16_t>(i << 8);
+        for (size_t bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x8000) ? static_cast<uint16_t>((crc << 1) ^ 0x1021)
+                                 : static_cast<uint16_t>(crc << 1);
+        }
+        table[i] = crc;
+    }
+    return table;
+}
+
+constexpr std::array<uint16_t, 256> table = crcTable();
+
+/**
+ * @brief COBS encoder state, so a frame can be encoded from several buffers
+ */
+class CobsEncoder {
+public:
+    explicit CobsEncoder(uint8_t *out) : _out(out), _code(0), _pos(1){};
+
+    /**
+     * @brief Encode bytes, copying runs between zeros with memcpy()
+     *
+     * @param[in] data Bytes
+     * @param[in] size Number of bytes
+     */
+    void write(const uint8_t *data, size_t size) {
+        while (size > 0) {
+            // Copy up to the next zero or the end of the block
+            const size_t room = 0xFE - (_pos - _code - 1);
+            const size_t run = (size < room) ? size : room;
+            const void *found = std::memchr(data, 0, run);
+            const size_t copy =
+                (found != nullptr)
+                    ? static_cast<size_t>(static_cast<const uint8_t *>(found) -
+                                          data)
+                    : run;
+            std::memcpy(_out + _pos, data, copy);
+            _pos += copy;
+            data += copy;
+            size -= copy;
+
+            if (found != nullptr) {
+                // Replace the zero by ending the block
+                endBlock();
+                data++;
+                size--;
+            } else if (_pos - _code - 1 == 0xFE) {
+                // Full block, which has no implicit zero
+                endBlock();
+            }
+        }
+    };
+
+    /**
+     * @brief End the frame
+     *
+     * @return size_t Frame size, including the delimiter
+     */
+    size_t finish() {
+        _out[_code] = static_cast<uint8_t>(_pos - _code);
+        _out[_pos++] = RnpFraming::delimiter;
+        return _pos;
+    };
+
+private:
+    /**
+     * @brief Write the code byte of the current block and start the next
+     */
+    void endBlock() {
+        _out[_code] = static_cast<uint8_t>(_pos - _code);
+        _code = _pos++;
+    };
+
+    /// @brief Output buffer
+    uint8_t *_out;
+
+    /// @brief Position of the code byte of the current block
+    size_t _code;
+
+    /// @brief Next output position
+    size_t _pos;
+};
+
+} // namespace
+
+uint16_t RnpFraming::crc16(const RnpBufferView data, uint16_t crc) {
+    for (const uint8_t byte : data) {
+        crc = static_cast<uint16_t>((crc << 8) ^ table[(crc >> 8) ^ byte]);
+    }
+    return crc;
+}
+
+size_t RnpFraming::encode(const RnpBufferView payload, uint8_t *out) {
+    // Calculate the CRC in wire byte order
+    uint8_t crc[crcSize];
+    RnpEndian::store(crc, crc16(payload));
+
+    // Encode the payload followed by the CRC
+    CobsEncoder encoder(out);
+    encoder.write(payload.data(), payload.size());
+    encoder.write(crc, crcSize);
+    return encoder.finish();
+}
+
+size_t RnpFraming::encode(const RnpBufferView payload,
+                          std::vector<uint8_t> &out) {
+    // Make room for the largest frame
+    const size_t start = out.size();
+    out.resize(start + maxEncodedSize(payload.size()));
+
+    // Encode and trim to the actual size
+    const size_t size = encode(payload, out.data() + start);
+    out.resize(start + size);
+    return size;
+}
+
+void RnpDeframer::reset() {
+    _length = 0;
+    _remaining = 0;
+    _pendingZero = false;
+    _started = false;
+    _discard = false;
+}
+
+bool RnpDeframer::endFrame() {
+    // Ignore empty frames, i.e consecutive delimiters
+    if (!_started) {
+        reset();
+        return false;
+    }
+
+    // Check the frame was complete, fitted and holds a payload and CRC
+    bool valid = !_discard && (_remaining == 0) &&
+                 (_length > RnpFraming::crcSize);
+
+    // Check the CRC
+    if (valid) {
+        const size_t payloadSize = _length - RnpFraming::crcSize;
+        uint16_t crc;
+        RnpEndian::load(crc, _frame.data() + payloadSize);
+        valid = (crc == RnpFraming::crc16(
+                            RnpBufferView(_frame.data(), payloadSize)));
+    }
+
+    if (valid) {
+        _frames++;
+    } else {
+        _errors++;
+    }
+
+    // Start the next frame, the payload stays in _frame until then
+    reset();
+    return valid;
+}
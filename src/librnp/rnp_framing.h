@@ -0,0 +1,221 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "rnp_bufferview.h"
+
+/**
+ * @brief Framing for byte streams (TCP, serial)
+ *
+ * A frame is the payload followed by its CRC-16/CCITT (little endian), COBS
+ * encoded so it contains no zero bytes, then terminated by a zero delimiter.
+ * A receiver which joins mid-stream or sees corrupted bytes drops at most the
+ * frame in progress and resynchronizes at the next delimiter.
+ */
+namespace RnpFraming {
+
+/// @brief Frame delimiter
+constexpr uint8_t delimiter = 0x00;
+
+/// @brief Size of the CRC appended to the payload
+constexpr size_t crcSize = 2;
+
+/// @brief Initial CRC value
+constexpr uint16_t crcInit = 0xFFFF;
+
+/**
+ * @brief Calculate the CRC-16/CCITT of a buffer
+ *
+ * @param[in] data Buffer
+ * @param[in] crc CRC of the preceding data, to calculate it in parts
+ * @return uint16_t CRC
+ */
+uint16_t crc16(const RnpBufferView data, uint16_t crc = crcInit);
+
+/**
+ * @brief Get the largest encoded size of a payload, including the delimiter
+ *
+ * COBS adds a code byte per 254 bytes, plus one.
+ *
+ * @param[in] payloadSize Payload size
+ * @return constexpr size_t Maximum frame size
+ */
+constexpr size_t maxEncodedSize(const size_t payloadSize) {
+    return payloadSize + crcSize + ((payloadSize + crcSize) / 254) + 2;
+}
+
+/**
+ * @brief Encode a payload into a frame
+ *
+ * @param[in] payload Payload
+ * @param[out] out Output buffer, at least maxEncodedSize() bytes
+ * @return size_t Frame size, including the delimiter
+ */
+size_t encode(const RnpBufferView payload, uint8_t *out);
+
+/**
+ * @brief Encode a payload into a frame on the end of a buffer
+ *
+ * @param[in] payload Payload
+ * @param[in,out] out Output buffer, keeps its capacity between frames
+ * @return size_t Frame size, including the delimiter
+ */
+size_t encode(const RnpBufferView payload, std::vector<uint8_t> &out);
+
+} // namespace RnpFraming
+
+/**
+ * @brief Incremental frame decoder
+ *
+ * Accepts a byte stream in chunks of any size, i.e as returned by read(), and
+ * calls back with every complete payload which passes its CRC. Frames are
+ * decoded into a buffer allocated at construction, so feeding bytes never
+ * allocates. Runs of data are located with memchr() and copied with memcpy()
+ * rather than byte by byte.
+ */
+class RnpDeframer {
+public:
+    /**
+     * @brief Construct a new deframer
+     *
+     * @param[in] maxPayload Largest payload accepted, larger frames are
+     * dropped
+     */
+    explicit RnpDeframer(const size_t maxPayload)
+        : _frame(maxPayload + RnpFraming::crcSize){};
+
+    /**
+     * @brief Decode a chunk of the stream
+     *
+     * @tparam F Callable taking an RnpBufferView
+     * @param[in] chunk Stream bytes
+     * @param[in] onFrame Called with each decoded payload. The view is only
+     * valid for the duration of the call.
+     */
+    template <typename F>
+    void feed(const RnpBufferView chunk, F &&onFrame) {
+        const uint8_t *pos = chunk.data();
+        const uint8_t *const end = pos + chunk.size();
+
+        while (pos < end) {
+            // Read a code byte at the start of each block
+            if (_remaining == 0) {
+                const uint8_t code = *pos++;
+
+                // End of frame
+                if (code == RnpFraming::delimiter) {
+                    const size_t length = _length;
+                    if (endFrame()) {
+                        onFrame(RnpBufferView(_frame.data(),
+                                              length - RnpFraming::crcSize));
+                    }
+                    continue;
+                }
+
+                // The previous block ended with a zero, unless it was full
+                if (_pendingZero) {
+                    append(&zero, 1);
+                }
+                _started = true;
+                _remaining = code - 1;
+                _pendingZero = (code != 0xFF);
+                continue;
+            }
+
+            // Copy the rest of the block, or as much of it as is available
+            const size_t run =
+                std::min(static_cast<size_t>(_remaining),
+                         static_cast<size_t>(end - pos));
+            const void *delimiter =
+                std::memchr(pos, RnpFraming::delimiter, run);
+
+            // A delimiter inside a block truncates the frame, drop it and
+            // resynchronize on the delimiter
+            if (delimiter != nullptr) {
+                _discard = true;
+                _remaining = 0;
+                pos = static_cast<const uint8_t *>(delimiter);
+                continue;
+            }
+
+            append(pos, run);
+            pos += run;
+            _remaining -= static_cast<uint8_t>(run);
+        }
+    }
+
+    /**
+     * @brief Drop the frame in progress, i.e after reconnecting
+     */
+    void reset();
+
+    /**
+     * @brief Get the number of frames decoded
+     */
+    uint32_t frames() const { return _frames; };
+
+    /**
+     * @brief Get the number of frames dropped, as corrupted, truncated or
+     * too large
+     */
+    uint32_t errors() const { return _errors; };
+
+private:
+    /// @brief Zero byte restored between blocks
+    static constexpr uint8_t zero = 0;
+
+    /**
+     * @brief Add decoded bytes to the frame, discarding the frame if it is too
+     * large
+     *
+     * @param[in] data Bytes
+     * @param[in] size Number of bytes
+     */
+    void append(const uint8_t *data, const size_t size) {
+        if (_discard) {
+            return;
+        }
+        if (_length + size > _frame.size()) {
+            _discard = true;
+            return;
+        }
+        std::memcpy(_frame.data() + _length, data, size);
+        _length += size;
+    };
+
+    /**
+     * @brief Check the completed frame and start the next one
+     *
+     * @return true The frame is valid, its payload is at the start of _frame
+     * @return false The frame is empty or was dropped
+     */
+    bool endFrame();
+
+    /// @brief Decoded frame, payload and CRC
+    std::vector<uint8_t> _frame;
+
+    /// @brief Decoded frame size
+    size_t _length = 0;
+
+    /// @brief Bytes left in the current block
+    uint8_t _remaining = 0;
+
+    /// @brief A zero is decoded before the next block
+    bool _pendingZero = false;
+
+    /// @brief Bytes have been received since the last delimiter
+    bool _started = false;
+
+    /// @brief The frame in progress is dropped at the next delimiter
+    bool _discard = false;
+
+    /// @brief Frames decoded
+    uint32_t _frames = 0;
+
+    /// @brief Frames dropped
+    uint32_t _errors = 0;
+};
@@ -1,7 +1,6 @@
 #include "rnp_header.h"
 
 #include <cstring>
-#include <stdexcept>
 
 RnpHeader::RnpHeader() {}
 
@@ -12,16 +11,31 @@ RnpHeader::RnpHeader(uint8_t destinationService, uint8_t packetType,
     : packet_len{packetSize}, source_service{0},
       destination_service{destinationService}, type{packetType}, hops{0} {};
 
-RnpHeader::RnpHeader(const std::vector<uint8_t> &data) {
-    // Throw error if the buffer is too small for deserialization
+RnpHeader::RnpHeader(const std::vector<uint8_t> &data)
+    : RnpHeader(RnpBufferView(data)){};
+
+RnpHeader::RnpHeader(const RnpBufferView data) {
+    // Fail if the buffer is too small for deserialization
     if (data.size() < size()) {
-        throw std::runtime_error("Buffer too small to deserialize header from");
+        rnpDecodeFailed(RnpDecodeError::HEADER_TOO_SHORT);
     };
 
     // Deserialize header
     getSerializer().deserialize(*this, data);
 }
 
+RnpDecodeResult<RnpHeader> RnpHeader::tryDecode(const RnpBufferView data) {
+    // Check the buffer is large enough for a header
+    if (data.size() < size()) {
+        return RnpDecodeError::HEADER_TOO_SHORT;
+    }
+
+    // Deserialize header in place
+    RnpDecodeResult<RnpHeader> result(std::in_place);
+    getSerializer().deserialize(*result, data);
+    return result;
+}
+
 void RnpHeader::serialize(std::vector<uint8_t> &buf) const {
     // Extract buffer size
     size_t bufsize = buf.size();
@@ -29,7 +43,11 @@ void RnpHeader::serialize(std::vector<uint8_t> &buf) const {
     // Resize buffer to include header
     buf.resize(bufsize + size());
 
-    // Copy header to the end of the buffer
-    std::memcpy(buf.data() + bufsize, getSerializer().serialize(*this).data(),
-                size());
+    // Serialize header onto the end of the buffer
+    serialize(buf.data() + bufsize);
+};
+
+size_t RnpHeader::serialize(uint8_t *dst) const {
+    // Serialize header straight into the output location
+    return getSerializer().serializeInto(*this, dst);
 };
@@ -4,6 +4,9 @@
 #include <variant>
 #include <vector>
 
+#include "rnp_bufferview.h"
+#include "rnp_decode.h"
+#include "rnp_linkaddress.h"
 #include "rnp_serializer.h"
 
 /**
@@ -56,12 +59,31 @@ public:
     /**
      * @brief Construct a new Header object
      *
-     * Construct by deserializing existing packet
+     * Construct by deserializing existing packet. Fails with
+     * rnpDecodeFailed() if the packet is too small.
      *
      * @param[in] data Packet
      */
     RnpHeader(const std::vector<uint8_t> &data);
 
+    /**
+     * @brief Construct a new Header object
+     *
+     * Construct by deserializing directly from a view of an existing packet.
+     * Fails with rnpDecodeFailed() if the packet is too small.
+     *
+     * @param[in] data View of the packet bytes
+     */
+    RnpHeader(const RnpBufferView data);
+
+    /**
+     * @brief Decode a header without throwing
+     *
+     * @param[in] data View of the packet bytes
+     * @return RnpDecodeResult<RnpHeader> Header, or HEADER_TOO_SHORT
+     */
+    static RnpDecodeResult<RnpHeader> tryDecode(const RnpBufferView data);
+
     /**
      * @brief Destroy the Header object
      *
@@ -70,9 +92,7 @@ public:
     ~RnpHeader();
 
     /**
-     * @brief Serialize Header
-     *
-     * @todo Implement serialize with offset
+     * @brief Serialize Header, appending it to the end of the buffer
      *
      * @author Kiran de Silva
      *
@@ -80,6 +100,16 @@ public:
      */
     void serialize(std::vector<uint8_t> &buf) const;
 
+    /**
+     * @brief Serialize Header in place into a caller owned buffer
+     *
+     * The caller must ensure there is space for at least size() bytes at dst.
+     *
+     * @param[out] dst Output location
+     * @return size_t Number of bytes written
+     */
+    size_t serialize(uint8_t *dst) const;
+
     /// @brief Header start byte. Indicates the expected protocol. 0xAF is RNP
     uint8_t start_byte = 0xAF;
 
@@ -108,10 +138,10 @@ public:
     uint8_t hops = 0x00;
 
     /// @brief Source interface
-    uint8_t src_iface;
+    uint8_t src_iface = 0x00;
 
     /// @brief Link layer address
-    std::variant<std::monostate, std::string> lladdress;
+    RnpLinkAddress lladdress;
 
     /**
      * @brief Get size of Header
@@ -125,6 +155,24 @@ public:
         return getSerializer().member_size();
     }
 
+    /**
+     * @brief Get the offset of the source address in a serialized header
+     *
+     * @return constexpr size_t Source offset
+     */
+    static constexpr size_t sourceOffset() {
+        return getSerializer().member_offset(&RnpHeader::source);
+    }
+
+    /**
+     * @brief Get the offset of the number of hops in a serialized header
+     *
+     * @return constexpr size_t Hops offset
+     */
+    static constexpr size_t hopsOffset() {
+        return getSerializer().member_offset(&RnpHeader::hops);
+    }
+
     /**
      * @brief Generate string stream from Header
      *
@@ -0,0 +1,52 @@
+#include "rnp_inetaddress.h"
+
+#if defined(__linux__)
+
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+#include <arpa/inet.h>
+
+bool RnpInetAddress::parse(const std::string_view address,
+                           sockaddr_in &sockaddr) {
+    // Split the address at the port separator
+    const size_t separator = address.rfind(':');
+    if ((separator == std::string_view::npos) ||
+        (separator >= INET_ADDRSTRLEN)) {
+        return false;
+    }
+
+    // Copy the IP address so it is null terminated
+    char ip[INET_ADDRSTRLEN] = {};
+    std::memcpy(ip, address.data(), separator);
+
+    // Parse the port, which must make up the rest of the address
+    const char *portBegin = address.data() + separator + 1;
+    const char *portEnd = address.data() + address.size();
+    unsigned int port = 0;
+    const auto [end, error] = std::from_chars(portBegin, portEnd, port);
+    if ((error != std::errc()) || (end != portEnd) || (portBegin == portEnd) ||
+        (port > UINT16_MAX)) {
+        return false;
+    }
+
+    // Parse the IP address
+    sockaddr = {};
+    if (::inet_pton(AF_INET, ip, &sockaddr.sin_addr) != 1) {
+        return false;
+    }
+    sockaddr.sin_family = AF_INET;
+    sockaddr.sin_port = htons(static_cast<uint16_t>(port));
+    return true;
+}
+
+std::string RnpInetAddress::format(const sockaddr_in &sockaddr) {
+    char ip[INET_ADDRSTRLEN] = {};
+    ::inet_ntop(AF_INET, &sockaddr.sin_addr, ip, sizeof(ip));
+    return std::string(ip) + ":" + std::to_string(ntohs(sockaddr.sin_port));
+}
+
+#endif
@@ -0,0 +1,36 @@
+#pragma once
+
+#if defined(__linux__)
+
+#include <string>
+#include <string_view>
+
+#include <netinet/in.h>
+
+/**
+ * @brief Conversion between "ip:port" link layer addresses and IPv4 socket
+ * addresses, shared by the socket interfaces
+ */
+namespace RnpInetAddress {
+
+/**
+ * @brief Parse an "ip:port" IPv4 address
+ *
+ * @param[in] address Address string
+ * @param[out] sockaddr Socket address
+ * @return true Address parsed
+ * @return false Malformed address
+ */
+bool parse(const std::string_view address, sockaddr_in &sockaddr);
+
+/**
+ * @brief Format an IPv4 socket address as "ip:port"
+ *
+ * @param[in] sockaddr Socket address
+ * @return std::string Address string
+ */
+std::string format(const sockaddr_in &sockaddr);
+
+} // namespace RnpInetAddress
+
+#endif
@@ -6,13 +6,16 @@
 #include <string>
 #include <vector>
 
+#include "rnp_bufferview.h"
+#include "rnp_circularbuffer.h"
 #include "rnp_packet.h"
 #include "rnp_packetbufferinterface.h"
+#include "rnp_packetpool.h"
+#include "rnp_wirebuffer.h"
 
 // copied from rnp_networkmanager
-using packetptr_t = std::unique_ptr<RnpPacketSerialized>;
-using packetBuffer_t = std::queue<packetptr_t>;
-using packetBufferInterface_t = Rnp_PacketBufferInterface<packetptr_t>;
+using packetBuffer_t = std::queue<packetptr_t, Rnp_CircularBuffer<packetptr_t>>;
+using packetBufferInterface_t = Rnp_PacketBufferInterface<packetptr_t, packetBuffer_t>;
 
 /**
  * @brief Enumerate for default interfaces
@@ -34,19 +37,19 @@ enum class DEFAULT_INTERFACES : uint8_t {
  */
 struct RnpInterfaceInfo {
     /// @brief Interface status (UP/DOWN)
-    bool state;
+    bool state = false;
 
     /// @brief Interface error
-    bool error;
+    bool error = false;
 
     /// @brief Maximum Transmitable Unit
-    size_t MTU;
+    size_t MTU = 0;
 
     /// @brief Receive error
-    uint8_t rxerror;
+    uint8_t rxerror = 0;
 
     /// @brief Transmit error
-    uint8_t txerror;
+    uint8_t txerror = 0;
 
     /**
      * @brief Destroy the Interface Information structure
@@ -72,7 +75,7 @@ public:
      * @param[in] name Interface name
      */
     RnpInterface(const uint8_t id, const std::string name)
-        : _packetBuffer(nullptr), _id(id), _name(name){};
+        : _packetBuffer(nullptr), _packetPool(nullptr), _id(id), _name(name){};
 
     /**
      * @brief Set up Interface
@@ -90,6 +93,24 @@ public:
      */
     virtual void sendPacket(RnpPacket &data) = 0;
 
+    /**
+     * @brief Send an already serialized packet
+     *
+     * Used when the same packet is sent over several interfaces, so it is only
+     * serialized once. The default implementation ignores the serialized
+     * bytes and calls sendPacket(RnpPacket &), interfaces should override it
+     * to transmit the bytes directly.
+     *
+     * @param[in] data Packet, for the header (i.e link layer address)
+     * @param[in] wire Serialized packet, only valid for the duration of the
+     * call, use wire.retain() to keep it
+     */
+    virtual void sendPacket(RnpPacket &data, const RnpWireBuffer &wire) {
+        (void)wire;
+
+        sendPacket(data);
+    };
+
     /**
      * @brief Update Interface
      *
@@ -97,6 +118,39 @@ public:
      */
     virtual void update() = 0;
 
+    /**
+     * @brief Transmit packets held back by sendPacket()
+     *
+     * Called by the network manager at the end of every update, after the
+     * packets have been routed. Interfaces which batch transmissions (i.e
+     * one system call per update) queue packets in sendPacket() and send them
+     * here. The default implementation does nothing, for interfaces which
+     * transmit immediately.
+     */
+    virtual void flush(){};
+
+    /**
+     * @brief Get a file descriptor which becomes readable when the interface
+     * has data to receive
+     *
+     * Lets an event loop (i.e RnpEventLoop) wait for the interface rather than
+     * updating it continuously. The descriptor may change between updates,
+     * for example when a connection is re-established.
+     *
+     * @return int File descriptor, -1 if there is none (default)
+     */
+    virtual int getPollFd() { return -1; };
+
+    /**
+     * @brief Check if the interface has to be updated periodically by an
+     * event loop, as it cannot signal when it has data through getPollFd()
+     *
+     * @return true No file descriptor is available (default)
+     * @return false The interface only needs updating when its file
+     * descriptor is readable
+     */
+    virtual bool requiresPolling() { return getPollFd() < 0; };
+
     /**
      * @brief Get Interface information
      *
@@ -124,6 +178,13 @@ public:
      */
     void setPacketBuffer(packetBufferInterface_t *buffer) { _packetBuffer = buffer; };
 
+    /**
+     * @brief Set the Packet Pool used to allocate received packets
+     *
+     * @param[in] pool Packet pool, nullptr to allocate from the heap
+     */
+    void setPacketPool(RnpPacketPool *pool) { _packetPool = pool; };
+
     /**
      * @brief Get the Interface identifier
      *
@@ -149,9 +210,25 @@ public:
     };
 
 protected:
+    /**
+     * @brief Create a received packet from its serialized bytes, taking it
+     * from the packet pool when one is set
+     *
+     * @param[in] bytes Serialized packet (header and body)
+     * @return packetptr_t Packet, or nullptr if bytes is too small to contain
+     * a header
+     */
+    packetptr_t createPacket(const RnpBufferView bytes) {
+        // Allocate from the pool if set, otherwise the heap
+        return RnpPacketPool::allocate(_packetPool, bytes);
+    };
+
     /// @brief Packet buffer
     packetBufferInterface_t *_packetBuffer;
 
+    /// @brief Packet pool
+    RnpPacketPool *_packetPool;
+
     /// @brief Interface unique identifier
     const uint8_t _id;
 
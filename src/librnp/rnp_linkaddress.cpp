@@ -0,0 +1,63 @@
+#include "rnp_linkaddress.h"
+
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+namespace {
+
+/// @brief Intern table type, ordered with a transparent comparator so
+/// addresses can be looked up without building a string
+using InternTable = std::map<std::string, std::atomic<uint32_t>, std::less<>>;
+
+/// @brief Intern table, node based so element addresses are stable. Never
+/// destroyed, as addresses in static objects may be released after it would
+/// be.
+InternTable &internTable() {
+    static auto *table = new InternTable();
+    return *table;
+}
+
+/// @brief Guards the intern table, never destroyed for the same reason
+std::mutex &internMutex() {
+    static auto *mutex = new std::mutex();
+    return *mutex;
+}
+
+} // namespace
+
+RnpLinkAddress::Entry *RnpLinkAddress::intern(std::string_view address) {
+    std::lock_guard<std::mutex> lock(internMutex());
+
+    // Insert the address if it has not been seen before, only then copying it
+    // into a string, and reference it
+    InternTable &table = internTable();
+    auto it = table.find(address);
+    if (it == table.end()) {
+        it = table.emplace(std::string(address), 0).first;
+    }
+    it->second.fetch_add(1, std::memory_order_relaxed);
+    return &*it;
+}
+
+void RnpLinkAddress::releaseLast(Entry *entry) {
+    std::lock_guard<std::mutex> lock(internMutex());
+
+    // Remove the address once nothing refers to it. Interning holds the lock,
+    // so the count cannot be raised from zero before it is removed.
+    if (entry->second.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        internTable().erase(internTable().find(entry->first));
+    }
+}
+
+size_t RnpLinkAddress::internedCount() {
+    std::lock_guard<std::mutex> lock(internMutex());
+    return internTable().size();
+}
+
+const std::string &RnpLinkAddress::emptyString() {
+    static const std::string empty;
+    return empty;
+}
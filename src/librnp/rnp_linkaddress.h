@@ -0,0 +1,209 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <variant>
+
+/**
+ * @brief Interned link layer address
+ *
+ * Link layer addresses are interned into a process wide table the first time
+ * they are seen, so an address is just a pointer to the interned string.
+ * Copying, comparing and clearing an address never allocates, which keeps
+ * std::string off the per packet routing path. Only constructing an address
+ * from a string touches the intern table.
+ *
+ * Interned strings are reference counted, and removed from the table when
+ * the last address referring to them is destroyed, so addresses taken from
+ * the network only use memory while something (i.e a route) holds them.
+ * Copying an address is an atomic increment, the lock guarding the table is
+ * only taken to intern a string or release its last reference.
+ */
+class RnpLinkAddress {
+public:
+    /**
+     * @brief Construct an empty address
+     */
+    constexpr RnpLinkAddress() : _entry(nullptr){};
+
+    /**
+     * @brief Construct an empty address
+     */
+    constexpr RnpLinkAddress(std::monostate) : _entry(nullptr){};
+
+    /**
+     * @brief Construct an address, interning the string
+     *
+     * @param[in] address Address string
+     */
+    RnpLinkAddress(std::string_view address) : _entry(intern(address)){};
+
+    /**
+     * @brief Construct an address, interning the string
+     *
+     * @param[in] address Address string
+     */
+    RnpLinkAddress(const std::string &address)
+        : RnpLinkAddress(std::string_view(address)){};
+
+    /**
+     * @brief Construct an address, interning the string
+     *
+     * @param[in] address Null terminated address string
+     */
+    RnpLinkAddress(const char *address)
+        : RnpLinkAddress(std::string_view(address)){};
+
+    RnpLinkAddress(const RnpLinkAddress &other) : _entry(other._entry) {
+        retain();
+    };
+
+    RnpLinkAddress(RnpLinkAddress &&other) noexcept : _entry(other._entry) {
+        other._entry = nullptr;
+    };
+
+    RnpLinkAddress &operator=(const RnpLinkAddress &other) {
+        if (_entry != other._entry) {
+            other.retain();
+            release();
+            _entry = other._entry;
+        }
+        return *this;
+    };
+
+    RnpLinkAddress &operator=(RnpLinkAddress &&other) noexcept {
+        if (this != &other) {
+            release();
+            _entry = other._entry;
+            other._entry = nullptr;
+        }
+        return *this;
+    };
+
+    /**
+     * @brief Destroy the address, removing the interned string if this was
+     * the last address referring to it
+     */
+    ~RnpLinkAddress() { release(); };
+
+    /**
+     * @brief Check if the address is empty
+     */
+    bool empty() const { return _entry == nullptr; };
+
+    /**
+     * @brief Get the address string, empty if there is no address
+     */
+    const std::string &str() const {
+        return (_entry != nullptr) ? _entry->first : emptyString();
+    };
+
+    /**
+     * @brief Get a pointer to the interned address string
+     *
+     * @return const std::string* Interned string, nullptr if there is no
+     * address. Only stable while an address refers to it, so hold an
+     * RnpLinkAddress rather than the pointer.
+     */
+    const std::string *get() const {
+        return (_entry != nullptr) ? &_entry->first : nullptr;
+    };
+
+    bool operator==(const RnpLinkAddress &other) const {
+        return _entry == other._entry;
+    };
+
+    bool operator!=(const RnpLinkAddress &other) const {
+        return _entry != other._entry;
+    };
+
+    /**
+     * @brief Get the number of interned strings, i.e to check addresses are
+     * released. Thread safe.
+     *
+     * @return size_t Number of strings in the intern table
+     */
+    static size_t internedCount();
+
+private:
+    /// @brief Interned string and the number of addresses referring to it
+    using Entry = std::pair<const std::string, std::atomic<uint32_t>>;
+
+    /**
+     * @brief Find or insert an address in the intern table, adding a
+     * reference. Thread safe.
+     *
+     * @param[in] address Address string
+     * @return Entry* Interned entry
+     */
+    static Entry *intern(std::string_view address);
+
+    /**
+     * @brief Drop the last reference to an entry, removing it from the
+     * intern table unless it was interned again meanwhile. Thread safe.
+     *
+     * @param[in] entry Interned entry
+     */
+    static void releaseLast(Entry *entry);
+
+    /**
+     * @brief Empty string returned by str() for an empty address
+     */
+    static const std::string &emptyString();
+
+    /**
+     * @brief Add a reference to the interned entry, if any
+     */
+    void retain() const {
+        if (_entry != nullptr) {
+            _entry->second.fetch_add(1, std::memory_order_relaxed);
+        }
+    };
+
+    /**
+     * @brief Drop the reference to the interned entry, if any
+     *
+     * Only the last reference takes the intern table lock, so the count can
+     * never reach zero while another thread interns the same string.
+     */
+    void release() {
+        if (_entry == nullptr) {
+            return;
+        }
+
+        uint32_t references = _entry->second.load(std::memory_order_relaxed);
+        while (references > 1) {
+            if (_entry->second.compare_exchange_weak(
+                    references, references - 1, std::memory_order_acq_rel)) {
+                _entry = nullptr;
+                return;
+            }
+        }
+
+        releaseLast(_entry);
+        _entry = nullptr;
+    };
+
+    /// @brief Interned entry, nullptr if there is no address
+    Entry *_entry;
+};
+
+namespace std {
+
+/**
+ * @brief Hash of a link layer address, so addresses can key a cache while
+ * keeping their interned strings alive
+ */
+template <>
+struct hash<RnpLinkAddress> {
+    size_t operator()(const RnpLinkAddress &address) const noexcept {
+        return hash<const string *>()(address.get());
+    }
+};
+
+} // namespace std
@@ -0,0 +1,141 @@
+#include "rnp_logger.h"
+
+#include "rnp_asynclogsink.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <string_view>
+
+#if defined(ARDUINO)
+#include <Arduino.h>
+#else
+#include <iostream>
+#endif
+
+RnpLogger::RnpLogger() {
+    // Allocate the callback string up front
+    _output.reserve(RnpLogRecord::maxLength);
+}
+
+RnpLogger::~RnpLogger() = default;
+
+void RnpLogger::setCallback(LogCb_t callback, const bool async,
+                            const size_t capacity) {
+    // Stop the previous asynchronous output, writing out its queue
+    if (_sink) {
+        _droppedBefore += _sink->dropped();
+        _sink.reset();
+    }
+
+#if RNP_ASYNC_LOG_SUPPORTED
+    if (async) {
+        _sink = std::make_unique<RnpAsyncLogSink>(callback, capacity);
+    }
+#else
+    (void)async;
+    (void)capacity;
+#endif
+
+    _callback = callback;
+}
+
+uint32_t RnpLogger::dropped() const {
+    return _droppedBefore + (_sink ? _sink->dropped() : 0);
+}
+
+void RnpLogger::appendPrefix(RnpLogRecord &record) {
+    switch (record.level) {
+    case LOG_LEVEL::ERR: {
+        append(record, "[E] ");
+        break;
+    }
+    case LOG_LEVEL::WARN: {
+        append(record, "[W] ");
+        break;
+    }
+    case LOG_LEVEL::DBG: {
+        append(record, "[D] ");
+        break;
+    }
+    default: {
+        break;
+    }
+    }
+}
+
+void RnpLogger::append(RnpLogRecord &record, const std::string_view str) {
+    // Copy as much as fits, truncating the message
+    const size_t count =
+        std::min(str.size(), record.text.size() - record.length);
+    std::memcpy(record.text.data() + record.length, str.data(), count);
+    record.length += static_cast<uint8_t>(count);
+}
+
+void RnpLogger::appendFloat(RnpLogRecord &record, const float value) {
+#if defined(__cpp_lib_to_chars)
+    // Shortest representation which round trips as a float, not as the double
+    // it widens to
+    char *const first = record.text.data() + record.length;
+    char *const last = record.text.data() + record.text.size();
+    const std::to_chars_result result = std::to_chars(first, last, value);
+    if (result.ec == std::errc()) {
+        record.length = static_cast<uint8_t>(result.ptr - record.text.data());
+    }
+#else
+    appendFloat(record, static_cast<double>(value));
+#endif
+}
+
+void RnpLogger::appendFloat(RnpLogRecord &record, const double value) {
+    char *const first = record.text.data() + record.length;
+    char *const last = record.text.data() + record.text.size();
+
+#if defined(__cpp_lib_to_chars)
+    // Shortest representation which round trips
+    const std::to_chars_result result = std::to_chars(first, last, value);
+    if (result.ec == std::errc()) {
+        record.length = static_cast<uint8_t>(result.ptr - record.text.data());
+    }
+#else
+    // Format into a temporary, as snprintf always null terminates
+    char buffer[32];
+    const int length = std::snprintf(buffer, sizeof(buffer), "%g", value);
+    if ((length > 0) && (length <= (last - first))) {
+        std::memcpy(first, buffer, length);
+        record.length += static_cast<uint8_t>(length);
+    }
+#endif
+}
+
+void RnpLogger::output(const RnpLogRecord &record) {
+    // Hand the record to the background thread if asynchronous
+    if (_sink) {
+        _sink->push(record);
+        return;
+    }
+
+    write(_callback, _output, record);
+}
+
+void RnpLogger::write(const LogCb_t &callback, std::string &output,
+                      const RnpLogRecord &record) {
+    // Use default logging if no logging callback is set
+    if (!callback) {
+#if defined(ARDUINO)
+        // Print log message to serial
+        Serial.write(record.text.data(), record.length);
+        Serial.println();
+#else
+        // Print log message to standard output
+        std::cout.write(record.text.data(), record.length);
+        std::cout << "\n";
+#endif
+        return;
+    }
+
+    // Log via the logging callback, reusing the string's storage
+    output.assign(record.text.data(), record.length);
+    callback(output);
+}
@@ -0,0 +1,257 @@
+#pragma once
+
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+/// @brief Log levels, used to set RNP_LOG_LEVEL
+#define RNP_LOG_LEVEL_NONE 0
+#define RNP_LOG_LEVEL_ERROR 1
+#define RNP_LOG_LEVEL_WARN 2
+#define RNP_LOG_LEVEL_INFO 3
+#define RNP_LOG_LEVEL_DEBUG 4
+
+/// @brief Most verbose level compiled in, log calls above it compile to
+/// nothing
+#ifndef RNP_LOG_LEVEL
+#define RNP_LOG_LEVEL RNP_LOG_LEVEL_INFO
+#endif
+
+/**
+ * @brief Enumerate for log levels
+ *
+ * Names are abbreviated to avoid clashing with common ERROR/DEBUG macros.
+ */
+enum class LOG_LEVEL : uint8_t {
+    /// @brief Errors, i.e dropped or invalid packets
+    ERR = RNP_LOG_LEVEL_ERROR,
+
+    /// @brief Warnings
+    WARN = RNP_LOG_LEVEL_WARN,
+
+    /// @brief Information, i.e configuration changes
+    INFO = RNP_LOG_LEVEL_INFO,
+
+    /// @brief Debugging
+    DBG = RNP_LOG_LEVEL_DEBUG,
+};
+
+/// @brief Logging callback type
+using LogCb_t = std::function<void(const std::string &)>;
+
+class RnpAsyncLogSink;
+
+/**
+ * @brief Log argument wrapper for printing an integer in hexadecimal
+ */
+struct RnpLogHex {
+    /// @brief Value
+    uint32_t value;
+};
+
+/**
+ * @brief Formatted log message
+ */
+struct RnpLogRecord {
+    /// @brief Maximum message length, longer messages are truncated
+    static constexpr size_t maxLength = 126;
+
+    /// @brief Level
+    LOG_LEVEL level = LOG_LEVEL::INFO;
+
+    /// @brief Message length
+    uint8_t length = 0;
+
+    /// @brief Message text, not null terminated
+    std::array<char, maxLength> text;
+
+    /**
+     * @brief Get the message text
+     */
+    std::string_view str() const { return {text.data(), length}; };
+};
+
+/**
+ * @brief Logger formatting messages without allocating
+ *
+ * Arguments are formatted only when a message is logged, straight into the
+ * next record of a preallocated ring, which also keeps the most recent
+ * messages. Strings, integers, floating point values, enums and RnpLogHex can
+ * be logged.
+ *
+ * Messages are passed to the callback through a reused string, so once its
+ * capacity has grown to the longest message nothing is allocated. With an
+ * asynchronous callback, records are instead queued for a background thread
+ * so slow outputs do not stall the caller.
+ */
+class RnpLogger {
+public:
+    /// @brief Number of records kept
+    static constexpr size_t historySize = 8;
+
+    /**
+     * @brief Check if a level is compiled in
+     *
+     * @tparam LEVEL Level
+     * @return true if the level is at or below RNP_LOG_LEVEL
+     */
+    template <LOG_LEVEL LEVEL>
+    static constexpr bool compiledIn() {
+        return static_cast<uint8_t>(LEVEL) <= RNP_LOG_LEVEL;
+    }
+
+    /**
+     * @brief Construct a new logger printing to the default output
+     */
+    RnpLogger();
+
+    /**
+     * @brief Destroy the logger, writing out queued records
+     */
+    ~RnpLogger();
+
+    /**
+     * @brief Format and output a message
+     *
+     * @param[in] level Level
+     * @param[in] args Message parts, concatenated
+     */
+    template <typename... ARGS>
+    void log(const LOG_LEVEL level, const ARGS &...args) {
+        // Take the oldest record
+        RnpLogRecord &record = _history[_next];
+        _next = (_next + 1) % historySize;
+
+        // Format the message into the record
+        record.level = level;
+        record.length = 0;
+        appendPrefix(record);
+        (append(record, args), ...);
+
+        // Output the record
+        output(record);
+    }
+
+    /**
+     * @brief Set the output callback
+     *
+     * @param[in] callback Logging callback, empty for the default output
+     * (serial on Arduino, standard output otherwise)
+     * @param[in] async Output from a background thread, dropping messages
+     * when the queue is full. Ignored where threads are unavailable
+     * @param[in] capacity Maximum number of queued messages when asynchronous
+     */
+    void setCallback(LogCb_t callback, const bool async = false,
+                     const size_t capacity = 32);
+
+    /**
+     * @brief Get the number of messages dropped by the asynchronous output
+     *
+     * @return uint32_t Dropped messages, wraps around
+     */
+    uint32_t dropped() const;
+
+    /**
+     * @brief Output a record to a callback
+     *
+     * @param[in] callback Logging callback, empty for the default output
+     * @param[in,out] output String passed to the callback, reused between
+     * records
+     * @param[in] record Record
+     */
+    static void write(const LogCb_t &callback, std::string &output,
+                      const RnpLogRecord &record);
+
+    /**
+     * @brief Get a recent record
+     *
+     * @param[in] age Age of the record, 0 for the newest
+     * @return const RnpLogRecord& Record, empty if fewer messages were logged
+     */
+    const RnpLogRecord &recent(const size_t age) const {
+        return _history[(_next + historySize - 1 - (age % historySize)) %
+                        historySize];
+    };
+
+private:
+    static void appendPrefix(RnpLogRecord &record);
+
+    static void append(RnpLogRecord &record, const std::string_view str);
+
+    static void append(RnpLogRecord &record, const char *str) {
+        append(record, std::string_view(str));
+    };
+
+    static void append(RnpLogRecord &record, const std::string &str) {
+        append(record, std::string_view(str));
+    };
+
+    static void append(RnpLogRecord &record, const RnpLogHex hex) {
+        appendInteger(record, hex.value, 16);
+    };
+
+    static void appendFloat(RnpLogRecord &record, const float value);
+
+    static void appendFloat(RnpLogRecord &record, const double value);
+
+    template <typename T>
+    static void append(RnpLogRecord &record, const T value) {
+        if constexpr (std::is_enum_v<T>) {
+            append(record, static_cast<std::underlying_type_t<T>>(value));
+        } else if constexpr (std::is_same_v<T, bool>) {
+            appendInteger(record, static_cast<int>(value), 10);
+        } else if constexpr (std::is_same_v<T, float>) {
+            appendFloat(record, value);
+        } else if constexpr (std::is_floating_point_v<T>) {
+            appendFloat(record, static_cast<double>(value));
+        } else {
+            static_assert(std::is_integral_v<T>, "Unsupported log argument");
+            appendInteger(record, value, 10);
+        }
+    }
+
+    template <typename T>
+    static void appendInteger(RnpLogRecord &record, const T value,
+                              const int base) {
+        char *const first = record.text.data() + record.length;
+        char *const last = record.text.data() + record.text.size();
+
+        // Leave the record as it is if the value does not fit
+        const std::to_chars_result result =
+            std::to_chars(first, last, value, base);
+        if (result.ec == std::errc()) {
+            record.length = static_cast<uint8_t>(result.ptr - record.text.data());
+        }
+    }
+
+    /**
+     * @brief Output a record
+     *
+     * @param[in] record Record
+     */
+    void output(const RnpLogRecord &record);
+
+    /// @brief Record ring
+    std::array<RnpLogRecord, historySize> _history;
+
+    /// @brief Next record to be written
+    size_t _next = 0;
+
+    /// @brief Output callback
+    LogCb_t _callback;
+
+    /// @brief String passed to the callback, reused between messages
+    std::string _output;
+
+    /// @brief Asynchronous output, null when synchronous
+    std::unique_ptr<RnpAsyncLogSink> _sink;
+
+    /// @brief Messages dropped by previous asynchronous outputs
+    uint32_t _droppedBefore = 0;
+};
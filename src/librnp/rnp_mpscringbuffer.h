@@ -0,0 +1,170 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+/**
+ * @brief Bounded lock-free multi-producer/single-consumer ring buffer
+ *
+ * Based on Dmitry Vyukov's bounded MPMC queue: every cell carries a sequence
+ * number which tells producers whether the cell is free and the consumer
+ * whether it has been published, so producers only contend on a single
+ * compare-exchange of the enqueue position. push() may be called from any
+ * number of threads (or cores) concurrently, pop() must only ever be called
+ * from one thread at a time.
+ *
+ * The capacity is rounded up to the next power of two. Elements must be
+ * default constructible and move assignable, popped cells are reset to a
+ * default constructed element.
+ *
+ * @tparam T Element type
+ */
+template <typename T>
+class Rnp_MPSCRingBuffer {
+public:
+    /**
+     * @brief Construct a new ring buffer
+     *
+     * @param capacity minimum number of elements, rounded up to a power of
+     * two. A capacity of zero creates a ring which rejects every push.
+     */
+    explicit Rnp_MPSCRingBuffer(const size_t capacity)
+        : _capacity(roundCapacity(capacity)), _mask(_capacity - 1),
+          _cells(_capacity ? new Cell[_capacity] : nullptr), _enqueuePos(0),
+          _dequeuePos(0) {
+        for (size_t i = 0; i < _capacity; i++) {
+            _cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    };
+
+    Rnp_MPSCRingBuffer(const Rnp_MPSCRingBuffer &) = delete;
+    Rnp_MPSCRingBuffer &operator=(const Rnp_MPSCRingBuffer &) = delete;
+
+    /**
+     * @brief Push an element with perfect forwarding. Safe to call from
+     * multiple threads concurrently. Returns false if the ring is full.
+     *
+     * @param arg element
+     * @return true element pushed
+     * @return false ring full, element not consumed
+     */
+    template <typename U>
+    bool push(U &&arg) {
+        if (_capacity == 0) {
+            return false;
+        }
+
+        size_t pos = _enqueuePos.load(std::memory_order_relaxed);
+        Cell *cell;
+
+        for (;;) {
+            cell = &_cells[pos & _mask];
+            const size_t seq = cell->sequence.load(std::memory_order_acquire);
+            const intptr_t diff =
+                static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+
+            if (diff == 0) {
+                // Cell is free, try to claim it
+                if (_enqueuePos.compare_exchange_weak(
+                        pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                // Cell still holds an element from the previous lap
+                return false;
+            } else {
+                // Another producer claimed this cell, reload the position
+                pos = _enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->data = std::forward<U>(arg);
+
+        // Publish the element to the consumer
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Pop the oldest element. Must only be called from the single
+     * consumer thread.
+     *
+     * @param out popped element
+     * @return true element popped
+     * @return false ring empty (or the oldest element is still being written)
+     */
+    bool pop(T &out) {
+        if (_capacity == 0) {
+            return false;
+        }
+
+        const size_t pos = _dequeuePos.load(std::memory_order_relaxed);
+        Cell &cell = _cells[pos & _mask];
+        const size_t seq = cell.sequence.load(std::memory_order_acquire);
+
+        if (static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1) < 0) {
+            return false;
+        }
+
+        out = std::move(cell.data);
+        cell.data = T();
+
+        // Hand the cell back to the producers for the next lap
+        cell.sequence.store(pos + _capacity, std::memory_order_release);
+        _dequeuePos.store(pos + 1, std::memory_order_relaxed);
+        return true;
+    };
+
+    /**
+     * @brief Get the number of queued elements. Only approximate while
+     * producers are pushing, as claimed cells are counted before they are
+     * published.
+     *
+     * @return size_t number of elements
+     */
+    size_t size() const {
+        const size_t dequeuePos = _dequeuePos.load(std::memory_order_relaxed);
+        const size_t enqueuePos = _enqueuePos.load(std::memory_order_relaxed);
+        return (enqueuePos > dequeuePos) ? (enqueuePos - dequeuePos) : 0;
+    };
+
+    bool empty() const { return size() == 0; };
+
+    size_t capacity() const { return _capacity; };
+
+private:
+    /// @brief Destructive interference size, kept fixed so the layout is the
+    /// same on every target
+    static constexpr size_t cacheLineSize = 64;
+
+    struct Cell {
+        std::atomic<size_t> sequence;
+        T data;
+    };
+
+    static size_t roundCapacity(const size_t capacity) {
+        if (capacity == 0) {
+            return 0;
+        }
+        size_t rounded = 1;
+        while (rounded < capacity) {
+            rounded <<= 1;
+        }
+        return rounded;
+    };
+
+    const size_t _capacity;
+
+    const size_t _mask;
+
+    std::unique_ptr<Cell[]> _cells;
+
+    /// @brief Next position to be claimed by a producer
+    alignas(cacheLineSize) std::atomic<size_t> _enqueuePos;
+
+    /// @brief Next position to be read by the consumer
+    alignas(cacheLineSize) std::atomic<size_t> _dequeuePos;
+};
@@ -1,9 +1,12 @@
 #include "rnp_netman_packets.h"
 
+#include <algorithm>
 #include <cstring>
+#include <string_view>
 
 #include "rnp_header.h"
 #include "rnp_networkmanager.h"
+#include "rnp_networkstats.h"
 #include "rnp_packet.h"
 #include "rnp_routingtable.h"
 #include "rnp_serializer.h"
@@ -14,63 +17,68 @@ SetRoutePacket::SetRoutePacket(const uint8_t dest, const Route &route)
     : RnpPacket(static_cast<uint8_t>(DEFAULT_SERVICES::NETMAN),
                 static_cast<uint8_t>(NETMAN_TYPES::SET_ROUTE), size()),
       destination(dest), iface(route.iface), metric(route.metric) {
-    // Switch address type
-    switch (route.address.index()) {
-    case 0: { // No type
-        // Set address type and length
+    // Check for an address
+    if (route.address.empty()) {
+        // Set address type
         address_type = (uint8_t)ADDRESS_TYPE::NOTYPE;
-        address_len = 0;
-        break;
-    }
-    case 1: { // String
-        // set address string, type, and length
-        const std::string &address_string =
-            std::get<std::string>(route.address);
-        address_type = (uint8_t)ADDRESS_TYPE::STRING;
-        address_len = address_string.size();
-        std::memcpy(address_data.data(), address_string.data(), address_len);
-        break;
-    }
-    default: { // Unrecognised type
-        // Set address type and length
-        address_type = (uint8_t)ADDRESS_TYPE::NOTYPE;
-        address_len = 0;
-        break;
-    }
+        return;
     }
+
+    // set address string and type, truncating the address to 32 bytes
+    address_type = (uint8_t)ADDRESS_TYPE::STRING;
+    address.assign(route.address.str());
 };
 
 SetRoutePacket::SetRoutePacket(const RnpPacketSerialized &packet)
     : RnpPacket(packet, size()) {
-    // Deserialize packet
-    getSerializer().deserialize(*this, packet.getBody());
-
-    // Calculate offset (not including the payload)
-    const size_t offset = header.size() + getSerializer().member_size();
+    // Deserialize packet, clamping the address length to 32 bytes
+    getSerializer().deserialize(*this, packet.getBodyView());
+};
 
-    // Copy the address data
-    std::memcpy(address_data.data(), packet.packet.data() + offset,
-                address_len);
+SetRoutePacket::SetRoutePacket(const RnpPacketSerialized &packet,
+                               RnpPrevalidated)
+    : RnpPacket(packet.header) {
+    // Deserialize packet, clamping the address length to 32 bytes
+    getSerializer().deserialize(*this, packet.getBodyView());
 };
 
-void SetRoutePacket::serialize(std::vector<uint8_t> &buf) {
-    // Serialize packet to buffer
-    RnpPacket::serialize(buf);
+RnpDecodeResult<SetRoutePacket>
+SetRoutePacket::tryDecode(const RnpPacketSerialized &packet) {
+    // Validate the sizes once up front
+    const RnpDecodeError error = checkSize(packet, size());
+    if (error != RnpDecodeError::NONE) {
+        return error;
+    }
+
+    return RnpDecodeResult<SetRoutePacket>(std::in_place, packet,
+                                           rnpPrevalidated);
+}
 
-    // Extract buffer and member sizes
+void SetRoutePacket::serialize(std::vector<uint8_t> &buf) {
+    // Extract buffer size
     const size_t bufsize = buf.size();
-    const size_t member_size = getSerializer().member_size();
 
     // Resize buffer
-    buf.resize(bufsize + size());
+    buf.resize(bufsize + header.size() + size());
+
+    // Serialize packet onto the end of the buffer
+    serialize(buf.data() + bufsize, header.size() + size());
+}
+
+size_t SetRoutePacket::serialize(uint8_t *buf, size_t capacity) {
+    // Check the packet fits
+    if (capacity < header.size() + size()) {
+        return 0;
+    }
 
-    // Copy data serialized by the serializer
-    std::memcpy(buf.data() + bufsize, getSerializer().serialize(*this).data(),
-                member_size);
+    // Serialize header
+    size_t pos = header.serialize(buf);
 
-    // Copy data not serialized by the serializer
-    std::memcpy(buf.data() + bufsize + member_size, address_data.data(),
-                address_len);
+    // Serialize data, zero filling the unused part of the address
+    pos += getSerializer().serializeInto(*this, buf + pos);
+
+    // Return bytes written
+    return pos;
 }
 
 Route SetRoutePacket::getRoute() {
@@ -84,12 +92,8 @@ Route SetRoutePacket::getRoute() {
         return ret;
     }
     case (uint8_t)ADDRESS_TYPE::STRING: { // String
-        // Create string from address data (unsigned char* -> char*)
-        std::string address(reinterpret_cast<char *>(address_data.data()),
-                            address_len);
-
-        // Update route address
-        ret.address = address;
+        // Intern the address data, released again when the route is replaced
+        ret.address = RnpLinkAddress(address.str());
 
         // Return route
         return ret;
@@ -99,4 +103,79 @@ Route SetRoutePacket::getRoute() {
         return ret;
     }
     }
-};
\ No newline at end of file
+};
+NetworkStatsPacket::~NetworkStatsPacket(){};
+
+NetworkStatsPacket::NetworkStatsPacket(const RnpNetworkStats &stats,
+                                       const uint8_t _iface,
+                                       const uint8_t _service)
+    : RnpPacket(static_cast<uint8_t>(DEFAULT_SERVICES::NETMAN),
+                static_cast<uint8_t>(NETMAN_TYPES::STATS), size()),
+      iface(_iface), service(_service), rxPackets(0), rxBytes(0),
+      txPackets(0), txBytes(0),
+      serviceDeliveries(stats.serviceDeliveries[_service]),
+      dropBufferFull(stats.dropped(DROP_REASON::BUFFER_FULL)),
+      dropInvalid(stats.dropped(DROP_REASON::INVALID)),
+      dropNoRoute(stats.dropped(DROP_REASON::NO_ROUTE)),
+      dropNoService(stats.dropped(DROP_REASON::NO_SERVICE)),
+      dropLoop(stats.dropped(DROP_REASON::LOOP)),
+      dropDuplicate(stats.dropped(DROP_REASON::DUPLICATE)),
+      dropSameIface(stats.dropped(DROP_REASON::SAME_IFACE)) {
+    // Copy the interface counters if the interface has any
+    if (_iface < stats.interfaces.size()) {
+        const RnpInterfaceStats &ifaceStats = stats.interfaces[_iface];
+        rxPackets = ifaceStats.rxPackets;
+        rxBytes = ifaceStats.rxBytes;
+        txPackets = ifaceStats.txPackets;
+        txBytes = ifaceStats.txBytes;
+    }
+};
+
+NetworkStatsPacket::NetworkStatsPacket(const RnpPacketSerialized &packet)
+    : RnpPacket(packet, size()) {
+    // Deserialize packet
+    getSerializer().deserialize(*this, packet.getBodyView());
+};
+
+NetworkStatsPacket::NetworkStatsPacket(const RnpPacketSerialized &packet,
+                                       RnpPrevalidated)
+    : RnpPacket(packet.header) {
+    // Deserialize packet
+    getSerializer().deserialize(*this, packet.getBodyView());
+};
+
+RnpDecodeResult<NetworkStatsPacket>
+NetworkStatsPacket::tryDecode(const RnpPacketSerialized &packet) {
+    // Validate the sizes once up front
+    const RnpDecodeError error = checkSize(packet, size());
+    if (error != RnpDecodeError::NONE) {
+        return error;
+    }
+
+    return RnpDecodeResult<NetworkStatsPacket>(std::in_place, packet,
+                                               rnpPrevalidated);
+}
+
+void NetworkStatsPacket::serialize(std::vector<uint8_t> &buf) {
+    // Extract buffer size
+    const size_t bufsize = buf.size();
+
+    // Resize buffer
+    buf.resize(bufsize + header.size() + size());
+
+    // Serialize packet onto the end of the buffer
+    serialize(buf.data() + bufsize, header.size() + size());
+}
+
+size_t NetworkStatsPacket::serialize(uint8_t *buf, size_t capacity) {
+    // Check the packet fits
+    if (capacity < header.size() + size()) {
+        return 0;
+    }
+
+    // Serialize header
+    const size_t headersize = header.serialize(buf);
+
+    // Serialize packet after the header
+    return headersize + getSerializer().serializeInto(*this, buf + headersize);
+}
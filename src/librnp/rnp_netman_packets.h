@@ -1,7 +1,9 @@
 #pragma once
 
+#include "rnp_boundedbuffer.h"
 #include "rnp_header.h"
 #include "rnp_networkmanager.h"
+#include "rnp_networkstats.h"
 #include "rnp_packet.h"
 #include "rnp_routingtable.h"
 #include "rnp_serializer.h"
@@ -43,6 +45,17 @@ enum class NETMAN_TYPES : uint8_t {
     /// @brief Reset Network Manager configuration
     RESET_NETMAN = 9,
 
+    /// @brief Packet dropped after reaching the hop limit, sent to the
+    /// source of the dropped packet
+    HOP_LIMIT = 10,
+
+    /// @brief Get traffic statistics, data selects the interface (bits 0-7)
+    /// and service (bits 8-15) reported
+    GET_STATS = 11,
+
+    /// @brief Traffic statistics response
+    STATS = 12,
+
     /// @brief Get Node info
     NODEINFO = 254,
 
@@ -57,8 +70,8 @@ enum class NETMAN_TYPES : uint8_t {
  */
 template <uint8_t TYPE>
 using GenericRnpPacket_Base =
-    BasicDataPacket<uint32_t, TYPE,
-                    static_cast<uint8_t>(DEFAULT_SERVICES::NETMAN)>;
+    BasicDataPacket<uint32_t, static_cast<uint8_t>(DEFAULT_SERVICES::NETMAN),
+                    TYPE>;
 
 /**
  * @brief Generic base packet (no type)
@@ -109,6 +122,159 @@ using SetNoRouteActionPacket = GenericRnpPacket_Base<static_cast<uint8_t>(
 using SetRouteGenPacket =
     GenericRnpPacket_Base<static_cast<uint8_t>(NETMAN_TYPES::SET_ROUTEGEN)>;
 
+/**
+ * @brief Hop limit notification packet
+ *
+ * Data is the destination of the dropped packet, the uid is copied from the
+ * dropped packet.
+ */
+using HopLimitPacket =
+    GenericRnpPacket_Base<static_cast<uint8_t>(NETMAN_TYPES::HOP_LIMIT)>;
+
+/**
+ * @brief Get statistics request packet
+ *
+ * Data selects the interface (bits 0-7) and service (bits 8-15) reported in
+ * the response.
+ */
+using GetStatsPacket =
+    GenericRnpPacket_Base<static_cast<uint8_t>(NETMAN_TYPES::GET_STATS)>;
+
+/**
+ * @brief Packet class for reporting traffic statistics
+ *
+ * Carries the drop counters, the counters of one interface and the deliveries
+ * to one service, so the packet stays small enough for any link.
+ */
+class NetworkStatsPacket : public RnpPacket {
+private:
+    /**
+     * @brief Get the packet Serializer
+     *
+     * @return constexpr auto Serializer
+     */
+    static constexpr auto getSerializer() {
+        auto ret = RnpSerializer(
+            &NetworkStatsPacket::iface, &NetworkStatsPacket::service,
+            &NetworkStatsPacket::rxPackets, &NetworkStatsPacket::rxBytes,
+            &NetworkStatsPacket::txPackets, &NetworkStatsPacket::txBytes,
+            &NetworkStatsPacket::serviceDeliveries,
+            &NetworkStatsPacket::dropBufferFull,
+            &NetworkStatsPacket::dropInvalid, &NetworkStatsPacket::dropNoRoute,
+            &NetworkStatsPacket::dropNoService, &NetworkStatsPacket::dropLoop,
+            &NetworkStatsPacket::dropDuplicate,
+            &NetworkStatsPacket::dropSameIface);
+        return ret;
+    }
+
+public:
+    /**
+     * @brief Destroy the Network Stats Packet object
+     */
+    ~NetworkStatsPacket();
+
+    /**
+     * @brief Create the Network Stats Packet from statistics
+     *
+     * @param[in] stats Network statistics
+     * @param[in] iface Interface to report
+     * @param[in] service Service to report
+     */
+    NetworkStatsPacket(const RnpNetworkStats &stats, const uint8_t iface,
+                       const uint8_t service);
+
+    /**
+     * @brief Deserialize the Network Stats Packet
+     *
+     * @param[in] packet Serialized packet
+     */
+    NetworkStatsPacket(const RnpPacketSerialized &packet);
+
+    /**
+     * @brief Deserialize a packet already validated by checkSize()
+     *
+     * @param[in] packet Serialized packet
+     */
+    NetworkStatsPacket(const RnpPacketSerialized &packet, RnpPrevalidated);
+
+    /**
+     * @brief Deserialize a packet without throwing
+     *
+     * @param[in] packet Serialized packet
+     * @return RnpDecodeResult<NetworkStatsPacket> Packet, or the size mismatch
+     */
+    static RnpDecodeResult<NetworkStatsPacket>
+    tryDecode(const RnpPacketSerialized &packet);
+
+    /**
+     * @brief Serialize Network Stats Packet into buffer
+     *
+     * @param[out] buf Buffer
+     */
+    void serialize(std::vector<uint8_t> &buf) override;
+
+    /**
+     * @brief Serialize Network Stats Packet in place into a caller owned
+     * buffer
+     *
+     * @param[out] buf Output buffer
+     * @param[in] capacity Size of the output buffer
+     * @return size_t Number of bytes written, 0 if the packet does not fit
+     */
+    size_t serialize(uint8_t *buf, size_t capacity) override;
+
+    // data members
+    /// @brief Reported interface
+    uint8_t iface;
+
+    /// @brief Reported service
+    uint8_t service;
+
+    /// @brief Packets received on the interface
+    uint32_t rxPackets;
+
+    /// @brief Bytes received on the interface
+    uint32_t rxBytes;
+
+    /// @brief Packets sent on the interface
+    uint32_t txPackets;
+
+    /// @brief Bytes sent on the interface
+    uint32_t txBytes;
+
+    /// @brief Packets delivered to the service
+    uint32_t serviceDeliveries;
+
+    /// @brief Packets dropped as the packet buffer was full
+    uint32_t dropBufferFull;
+
+    /// @brief Invalid packets dropped
+    uint32_t dropInvalid;
+
+    /// @brief Packets dropped without a route
+    uint32_t dropNoRoute;
+
+    /// @brief Packets dropped without a service handler
+    uint32_t dropNoService;
+
+    /// @brief Packets dropped at the hop limit
+    uint32_t dropLoop;
+
+    /// @brief Duplicate packets dropped
+    uint32_t dropDuplicate;
+
+    /// @brief Packets dropped rather than forwarded back out of the interface
+    /// they were received on
+    uint32_t dropSameIface;
+
+    /**
+     * @brief Get the size of the Network Stats Packet
+     *
+     * @return constexpr size_t Packet size
+     */
+    static constexpr size_t size() { return getSerializer().member_size(); };
+};
+
 /**
  * @brief Packet class for setting routes
  *
@@ -131,7 +297,7 @@ private:
         auto ret = RnpSerializer(
             &SetRoutePacket::destination, &SetRoutePacket::iface,
             &SetRoutePacket::metric, &SetRoutePacket::address_type,
-            &SetRoutePacket::address_len);
+            &SetRoutePacket::address);
         return ret;
     }
 
@@ -162,6 +328,22 @@ public:
      */
     SetRoutePacket(const RnpPacketSerialized &packet);
 
+    /**
+     * @brief Deserialize a packet already validated by checkSize()
+     *
+     * @param[in] packet Serialized packet
+     */
+    SetRoutePacket(const RnpPacketSerialized &packet, RnpPrevalidated);
+
+    /**
+     * @brief Deserialize a packet without throwing
+     *
+     * @param[in] packet Serialized packet
+     * @return RnpDecodeResult<SetRoutePacket> Packet, or the size mismatch
+     */
+    static RnpDecodeResult<SetRoutePacket>
+    tryDecode(const RnpPacketSerialized &packet);
+
     /**
      * @brief Serialize Route Packet into buffer
      *
@@ -171,6 +353,15 @@ public:
      */
     void serialize(std::vector<uint8_t> &buf) override;
 
+    /**
+     * @brief Serialize Route Packet in place into a caller owned buffer
+     *
+     * @param[out] buf Output buffer
+     * @param[in] capacity Size of the output buffer
+     * @return size_t Number of bytes written, 0 if the packet does not fit
+     */
+    size_t serialize(uint8_t *buf, size_t capacity) override;
+
     /**
      * @brief Get the Route from the Route Packet
      *
@@ -193,11 +384,8 @@ public:
     /// @brief Address type
     uint8_t address_type;
 
-    /// @brief Address length
-    uint8_t address_len;
-
-    /// @brief Address data
-    std::array<uint8_t, 32> address_data;
+    /// @brief Address, always sent as its length followed by 32 bytes
+    RnpBoundedBuffer<32, true> address;
 
     /**
      * @brief Get the size of the Set Route Packet
@@ -207,8 +395,7 @@ public:
      * @return constexpr size_t Route Packet size
      */
     static constexpr size_t size() {
-        // Return size of packet (including payload which is not in the
-        // serializer)
-        return getSerializer().member_size() + sizeof(address_data);
+        // Return size of packet
+        return getSerializer().member_size();
     };
 };
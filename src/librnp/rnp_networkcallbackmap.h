@@ -5,6 +5,7 @@
 #include <unordered_map>
 
 #include "rnp_packet.h"
+#include "rnp_packetpool.h"
 
 namespace NetworkCallbackMap {
 
@@ -32,5 +33,5 @@ namespace NetworkCallbackMap {
  */
 using NetworkCallbackMap_t = std::unordered_map<
     std::pair<uint8_t, uint8_t>,
-    std::function<void(std::unique_ptr<RnpPacketSerialized>)>,
+    std::function<void(packetptr_t)>,
     decltype(NetworkCallbackMap::pair_hash_func)>;
@@ -1,8 +1,7 @@
 #include "rnp_networkmanager.h"
 
+#include <algorithm>
 #include <functional>
-#include <iostream>
-#include <iomanip>
 #include <memory>
 #include <optional>
 #include <utility>
@@ -13,6 +12,7 @@
 #include "rnp_packet.h"
 #include "rnp_routingtable.h"
 #include "rnp_packetbufferinterface.h"
+#include "rnp_time.h"
 
 #if defined(ARDUINO)
 #include <Arduino.h>
@@ -28,15 +28,31 @@
 RnpNetworkManager::RnpNetworkManager(const uint8_t address,
                                      const NODETYPE nodeType,
                                      const bool enableLogging,
-                                     size_t maxBufferSize)
-    : RnpNetworkManager({address, nodeType, NOROUTE_ACTION::DUMP, false},enableLogging,maxBufferSize)
+                                     size_t maxBufferSize,
+                                     size_t packetPoolCapacity,
+                                     PACKETBUFFER_TYPE packetBufferType)
+    : RnpNetworkManager({address, nodeType, NOROUTE_ACTION::DUMP, false},enableLogging,maxBufferSize,packetPoolCapacity,packetBufferType)
     {};
 
 RnpNetworkManager::RnpNetworkManager(const RnpNetworkManagerConfig config,
                                      const bool enableLogging,
-                                     size_t maxBufferSize)
-    : packetBufferInterface(packetBuffer,maxBufferSize),
-    serviceLookup(1), _config(config), routingtable(1),
+                                     size_t maxBufferSize,
+                                     size_t packetPoolCapacity,
+                                     PACKETBUFFER_TYPE packetBufferType)
+    : packetPool(packetPoolCapacity),
+    packetBuffer(Rnp_CircularBuffer<packetptr_t>(
+        (packetBufferType == PACKETBUFFER_TYPE::QUEUE) ? maxBufferSize : 0)),
+    packetRing((packetBufferType == PACKETBUFFER_TYPE::MPSC_RING)
+                   ? (maxBufferSize ? maxBufferSize : 256)
+                   : 0),
+    packetBufferInterface(
+        (packetBufferType == PACKETBUFFER_TYPE::MPSC_RING)
+            ? packetBufferInterface_t(packetRing, maxBufferSize)
+            : packetBufferInterface_t(packetBuffer, maxBufferSize)),
+    _config(config), routingtable(1),
+    // Start uids at an arbitrary non zero value, so a restarted node is
+    // unlikely to reuse recent uids
+    _nextUid(static_cast<uint16_t>((RnpTime::micros() % UINT16_MAX) + 1)),
       _loggingEnabled(enableLogging)
     {
 
@@ -47,7 +63,7 @@ RnpNetworkManager::RnpNetworkManager(const RnpNetworkManagerConfig config,
     generateDefaultRoutes();
 };
 
-void RnpNetworkManager::update() {
+RnpUpdateResult RnpNetworkManager::update() {
     // Iterate through the interface list
     for (auto iface_ptr : ifaceList) {
         // Check that interface exists
@@ -57,8 +73,34 @@ void RnpNetworkManager::update() {
         }
     }
 
+    return finishUpdate();
+}
+
+RnpUpdateResult
+RnpNetworkManager::update(const std::vector<uint8_t> &ifaceIDs) {
+    // Update the given interfaces which exist
+    for (const uint8_t ifaceID : ifaceIDs) {
+        if ((ifaceID < ifaceList.size()) && (ifaceList[ifaceID] != nullptr)) {
+            ifaceList[ifaceID]->update();
+        }
+    }
+
+    return finishUpdate();
+}
+
+RnpUpdateResult RnpNetworkManager::finishUpdate() {
     // Route packets
-    routePackets();
+    const size_t processed = routePackets();
+
+    // Transmit the packets the interfaces batched while routing
+    for (auto iface_ptr : ifaceList) {
+        if (iface_ptr != nullptr) {
+            iface_ptr->flush();
+        }
+    }
+
+    // Report how many packets were processed and are still queued
+    return {processed, packetBufferInterface.size()};
 }
 
 void RnpNetworkManager::reset() {
@@ -101,22 +143,52 @@ void RnpNetworkManager::sendPacket(RnpPacket &packet) {
     // Increment the number of hops of the packet
     packet.header.hops += 1;
 
+    // Assign a uid to locally originated packets without one, so they can be
+    // identified by the duplicate filter
+    const bool assignUid = (packet.header.source == _config.currentAddress) &&
+                           (packet.header.uid == 0);
+    if (assignUid) {
+        packet.header.uid = _nextUid;
+
+        // Never hand out 0
+        _nextUid = (_nextUid == UINT16_MAX) ? 1 : (_nextUid + 1);
+    }
+
+    // Send the packet, letting the interfaces serialize it
+    dispatchPacket(packet, nullptr);
+
+    // Clear the assigned uid, as the interfaces have serialized the packet, so
+    // the packet gets a fresh uid if it is sent again
+    if (assignUid) {
+        packet.header.uid = 0;
+    }
+}
+
+void RnpNetworkManager::dispatchPacket(RnpPacket &packet,
+                                       const RnpWireBuffer *wire) {
     // Extract the destination from the packet header
     uint8_t destination = packet.header.destination;
 
     // Get the route to the destination from the routing table
-    std::optional<Route> route = routingtable.getRoute(destination);
+    const Route *route = routingtable.findRoute(destination);
 
     // Check if no route exists
-    if (!route) {
+    if (route == nullptr) {
         // Check the no route action
         switch (_config.noRouteAction) {
         case NOROUTE_ACTION::DUMP: { // Dump the packet
+            countDrop(DROP_REASON::NO_ROUTE);
             return;
         }
         case NOROUTE_ACTION::BROADCAST: { // Broadcast the packet
+            // Serialize the packet once, sharing the bytes between interfaces,
+            // unless it is already serialized
+            const RnpWireBuffer broadcastWire =
+                (wire != nullptr) ? *wire : serializeShared(packet);
+
             // Function for broadcast the packet on a given interface
-            auto broadcastPacket = [&packet, this](uint8_t ifaceID) {
+            auto broadcastPacket = [&packet, &broadcastWire,
+                                    this](uint8_t ifaceID) {
                 // Dump the packet if broadcast is attempted on the same
                 // interface as it was received
                 if ((ifaceID == packet.header.src_iface) ||
@@ -126,7 +198,7 @@ void RnpNetworkManager::sendPacket(RnpPacket &packet) {
                 }
 
                 // Broadcast the packet on the specified interface
-                sendByRoute({ifaceID, 0, {}}, packet);
+                sendByRoute({ifaceID, 0, {}}, packet, &broadcastWire);
             };
 
             // Broadcast over listed or all available interfaces
@@ -143,8 +215,10 @@ void RnpNetworkManager::sendPacket(RnpPacket &packet) {
                     broadcastPacket(ifaceID);
                 }
             }
+            return;
         }
         default: { // Dump the packet
+            countDrop(DROP_REASON::NO_ROUTE);
             return;
         }
         }
@@ -154,16 +228,18 @@ void RnpNetworkManager::sendPacket(RnpPacket &packet) {
     if (packet.header.source != _config.currentAddress) {
         // Dump the packet if forwarding is attempted on the same interface as
         // it was received
-        if (packet.header.src_iface == route.value().iface) {
+        if (packet.header.src_iface == route->iface) {
+            countDrop(DROP_REASON::SAME_IFACE);
             return;
         }
     }
 
     // Send the packet via the route
-    sendByRoute(route.value(), packet);
+    sendByRoute(*route, packet, wire);
 }
 
-void RnpNetworkManager::sendByRoute(const Route &route, RnpPacket &packet) {
+void RnpNetworkManager::sendByRoute(const Route &route, RnpPacket &packet,
+                                    const RnpWireBuffer *wire) {
     // Get the interface identifier
     uint8_t ifaceID = route.iface;
 
@@ -172,7 +248,8 @@ void RnpNetworkManager::sendByRoute(const Route &route, RnpPacket &packet) {
     if (ifaceID == static_cast<uint8_t>(DEFAULT_INTERFACES::LOOPBACK) &&
         (packet.header.destination != _config.currentAddress)) {
         // Log the bad route
-        log("[E] Bad route: destination and current address do not match when "
+        log<LOG_LEVEL::ERR>(
+            "Bad route: destination and current address do not match when "
             "sending over the loopback interface");
         return;
     }
@@ -182,24 +259,52 @@ void RnpNetworkManager::sendByRoute(const Route &route, RnpPacket &packet) {
 
     // Dump the packet if an invalid interface is returned
     if (!iface_ptr) {
-        log("[E] Invalid/non-existent interface");
+        log<LOG_LEVEL::ERR>("Invalid/non-existent interface");
         return;
     }
 
     // Update the packet header link layer address
     packet.header.lladdress = route.address;
 
+    // Count the sent packet
+    if (ifaceID < _stats.interfaces.size()) {
+        RnpInterfaceStats &ifaceStats = _stats.interfaces[ifaceID];
+        ifaceStats.txPackets++;
+        ifaceStats.txBytes +=
+            (wire != nullptr) ? wire->size()
+                              : (packet.header.size() + packet.header.packet_len);
+    }
+
+    // Send the already serialized packet if provided
+    if (wire != nullptr) {
+        iface_ptr.value()->sendPacket(packet, *wire);
+        return;
+    }
+
     // Send the packet over the interface
     iface_ptr.value()->sendPacket(packet);
 };
 
+RnpWireBuffer RnpNetworkManager::serializeShared(RnpPacket &packet) {
+    // Reuse the previous buffer unless an interface is still holding on to it
+    if ((_wireBuffer == nullptr) || (_wireBuffer.use_count() > 1)) {
+        _wireBuffer = std::make_shared<std::vector<uint8_t>>();
+    }
+
+    // Serialize the packet into the buffer, keeping its capacity
+    _wireBuffer->clear();
+    packet.serialize(*_wireBuffer);
+
+    return RnpWireBuffer(_wireBuffer);
+};
+
 void RnpNetworkManager::setAddress(const uint8_t address) {
     // Get the current route from the routing table
-    auto currentRoute = routingtable.getRoute(_config.currentAddress);
+    const Route *currentRoute = routingtable.findRoute(_config.currentAddress);
 
     // Ensure that we do no delete a new route if this is called after a new
     // routing table is assigned
-    if (currentRoute && (currentRoute.value().iface ==
+    if ((currentRoute != nullptr) && (currentRoute->iface ==
                          static_cast<uint8_t>(DEFAULT_INTERFACES::LOOPBACK))) {
         routingtable.deleteRoute(_config.currentAddress);
     }
@@ -230,14 +335,31 @@ void RnpNetworkManager::addInterface(RnpInterface *iface) {
     if ((ifaceList.at(ifaceID) != nullptr) &&
         (ifaceList.at(ifaceID) != iface)) {
         // Log interface clash
-        log("[E] Non-unique interface identifier");
+        log<LOG_LEVEL::ERR>("Non-unique interface identifier");
     }
 
     // Add interface to list
     ifaceList.at(ifaceID) = iface;
 
+    // Add counters for the interface, keeping any existing counts
+    if (ifaceID >= _stats.interfaces.size()) {
+        _stats.interfaces.resize(ifaceID + 1);
+    }
+
     // Set interface packet buffer
     iface->setPacketBuffer(&packetBufferInterface);
+
+    // Set interface packet pool. The pool is not thread safe, so when the
+    // lock-free packet buffer is used only the loopback takes from the pool
+    if ((packetRing.capacity() == 0) || (iface == &lo)) {
+        iface->setPacketPool(&packetPool);
+    }
+
+    // Grow the pooled packets to cover the interface MTU
+    const RnpInterfaceInfo *info = iface->getInfo();
+    if (info != nullptr) {
+        packetPool.reserveSlotSize(info->MTU);
+    }
 };
 
 std::optional<RnpInterface *>
@@ -245,7 +367,7 @@ RnpNetworkManager::getInterface(const uint8_t ifaceID) {
     // Check if the identifier is greater than the size of the interface list
     if (ifaceID >= ifaceList.size()) {
         // Log out of range
-        log("[E] Interface identifier is out of range");
+        log<LOG_LEVEL::ERR>("Interface identifier is out of range");
 
         // Return null interface
         return {};
@@ -267,7 +389,7 @@ RnpNetworkManager::getInterface(const uint8_t ifaceID) {
 void RnpNetworkManager::removeInterface(const uint8_t ifaceID) {
     // Check if the identifier is greater than the size of the interface list
     if (ifaceID >= ifaceList.size()) {
-        log("[E] Interface identifier is out of range");
+        log<LOG_LEVEL::ERR>("Interface identifier is out of range");
         return;
     }
 
@@ -277,13 +399,16 @@ void RnpNetworkManager::removeInterface(const uint8_t ifaceID) {
     // Set null packet buffer
     iface_ptr->setPacketBuffer(nullptr);
 
+    // Set null packet pool
+    iface_ptr->setPacketPool(nullptr);
+
     // Set null pointer in interface list
     ifaceList.at(ifaceID) = nullptr;
 
     // Erase the last element from the interface list if the index is the final
     // element in the vector
     if (ifaceID == ifaceList.size() - 1) {
-        ifaceList.erase(ifaceList.end());
+        ifaceList.pop_back();
     }
 };
 
@@ -314,45 +439,81 @@ void RnpNetworkManager::registerService(const uint8_t serviceID,
     // Prevent adding a service with identifier = 0
     if (serviceID == 0) {
         // Log the attempt
-        log("[E] registerService-> Illegal Service identifier provided");
+        log<LOG_LEVEL::ERR>(
+            "registerService-> Illegal Service identifier provided");
         return;
     }
 
-    // Check if the service identifier is greater than the size of the service
-    // list
-    if (serviceID >= serviceLookup.size()) {
-        // Resize the service lsit
-        serviceLookup.resize(serviceID + 1);
+    // An empty callback is no handler, so packets to the service are dropped
+    if (!packetHandler) {
+        unregisterService(serviceID);
+        return;
     }
 
-    // Set the packet handler
-    serviceLookup.at(serviceID) = packetHandler;
+    // Release any callback previously registered for this service
+    releaseServiceCallback(serviceID);
+
+    // Take ownership of the callback, so it can be invoked in place
+    auto callback = std::make_unique<PacketHandlerCb>(std::move(packetHandler));
+
+    // Set the packet handler to refer to the owned callback
+    serviceLookup[serviceID] = PacketHandlerRef(
+        callback.get(), [](void *context, packetptr_t packet_ptr) {
+            (*static_cast<PacketHandlerCb *>(context))(std::move(packet_ptr));
+        });
+
+    // Store the callback
+    _serviceCallbacks.emplace_back(serviceID, std::move(callback));
 }
 
-void RnpNetworkManager::unregisterService(const uint8_t serviceID) {
-    // Prevent removing a service with identifier = 0
+void RnpNetworkManager::registerService(const uint8_t serviceID,
+                                        PacketHandlerRef packetHandler) {
+    // Prevent adding a service with identifier = 0
     if (serviceID == 0) {
         // Log the attempt
-        log("[E] unregisterService-> Illegal Service ID provided");
+        log<LOG_LEVEL::ERR>(
+            "registerService-> Illegal Service identifier provided");
         return;
     }
 
-    // Check if the service identifier is greater than the size of the service
-    // list
-    if (serviceID >= serviceLookup.size()) {
-        // Log the error
-        log("[E] service ID out of range");
+    // Release any callback previously registered for this service
+    releaseServiceCallback(serviceID);
+
+    // Set the packet handler
+    serviceLookup[serviceID] = packetHandler;
+}
+
+void RnpNetworkManager::unregisterService(const uint8_t serviceID) {
+    // Prevent removing a service with identifier = 0
+    if (serviceID == 0) {
+        // Log the attempt
+        log<LOG_LEVEL::ERR>(
+            "unregisterService-> Illegal Service ID provided");
         return;
     }
 
     // Set a null packet handler
-    serviceLookup.at(serviceID) = PacketHandlerCb{};
+    serviceLookup[serviceID] = PacketHandlerRef{};
 
-    // Erase the last element from the service list if the index is the final
-    // element in the vector
-    if (serviceID == serviceLookup.size() - 1) {
-        serviceLookup.erase(serviceLookup.end());
+    // Release the owned callback
+    releaseServiceCallback(serviceID);
+}
+
+void RnpNetworkManager::releaseServiceCallback(const uint8_t serviceID) {
+    // Find the owned callback for the service
+    auto it = std::find_if(_serviceCallbacks.begin(), _serviceCallbacks.end(),
+                           [serviceID](const auto &entry) {
+                               return entry.first == serviceID;
+                           });
+
+    if (it == _serviceCallbacks.end()) {
+        return;
     }
+
+    // Retire rather than destroy the callback, as this may be called from
+    // within the callback itself
+    _retiredServiceCallbacks.push_back(std::move(it->second));
+    _serviceCallbacks.erase(it);
 }
 
 void RnpNetworkManager::setNoRouteAction(const NOROUTE_ACTION action,
@@ -373,32 +534,71 @@ void RnpNetworkManager::generateDefaultRoutes() {
                           Route{1, 1, {}});
 };
 
-void RnpNetworkManager::routePackets() {
-    // Return if the packet buffer is empty
-    if (packetBuffer.empty()) {
-        return;
+size_t RnpNetworkManager::routePackets() {
+    // Limit the packet count to the packets queued now if no limit is set,
+    // so packets queued while routing (i.e over loopback) wait until the next
+    // update
+    const size_t maxPackets = (_routingBudgetPackets == 0)
+                                  ? packetBufferInterface.size()
+                                  : _routingBudgetPackets;
+
+    // Record the start time if a time budget is set
+    const uint32_t startTime = (_routingBudgetTime == 0) ? 0 : RnpTime::micros();
+
+    size_t processed = 0;
+
+    // Packet taken from the top of the buffer
+    packetptr_t packet_ptr;
+
+    // Take "ownership" of packets at the top of the buffer
+    while ((processed < maxPackets) && packetBufferInterface.pop(packet_ptr)) {
+        // Process the packet
+        routePacket(std::move(packet_ptr));
+        processed++;
+
+        // Stop once the time budget is used up
+        if ((_routingBudgetTime != 0) &&
+            (static_cast<uint32_t>(RnpTime::micros() - startTime) >=
+             _routingBudgetTime)) {
+            break;
+        }
     }
 
-    // Take "ownership" of packet at the top of the buffer
-    packetptr_t packet_ptr = std::move(packetBuffer.front());
+    // Destroy the callbacks retired while routing, now none are running
+    _retiredServiceCallbacks.clear();
+
+    return processed;
+}
 
-    // Remove packet from the top of the buffer
-    packetBuffer.pop();
+void RnpNetworkManager::routePacket(packetptr_t packet_ptr) {
+    // Count the received packet
+    if (packet_ptr->header.src_iface < _stats.interfaces.size()) {
+        RnpInterfaceStats &ifaceStats =
+            _stats.interfaces[packet_ptr->header.src_iface];
+        ifaceStats.rxPackets++;
+        ifaceStats.rxBytes += packet_ptr->packet.size();
+    }
 
     //check if packet is a valid RNP packet , dump it if not
     if ( !validPacket(*packet_ptr) )
     {
+        countDrop(DROP_REASON::INVALID);
+        return;
+    }
+
+    // Drop packets which have already been routed, except for local packets
+    if (_duplicateFilter.enabled() &&
+        (packet_ptr->header.src_iface !=
+         static_cast<uint8_t>(DEFAULT_INTERFACES::LOOPBACK)) &&
+        _duplicateFilter.isDuplicate(packet_ptr->header, RnpTime::millis())) {
+        countDrop(DROP_REASON::DUPLICATE);
         return;
     }
 
     // Check if automatic route generation is enabled
     if (_config.routeGenEnabled) {
-        // Get the route to the source node
-        std::optional<Route> currentRoute =
-            routingtable.getRoute(packet_ptr->header.source);
-
         // If a route does not exist, generate a new route
-        if (!currentRoute) {
+        if (routingtable.findRoute(packet_ptr->header.source) == nullptr) {
             // Create a new route
             Route newroute{packet_ptr->header.src_iface,
                            packet_ptr->header.hops,
@@ -448,29 +648,29 @@ void RnpNetworkManager::routePackets() {
         break;
     }
     case static_cast<uint8_t>(DEFAULT_SERVICES::NETMAN): {
+        // Count the delivery
+        _stats.serviceDeliveries[packetService]++;
+
         // Mpve the packet to the network manager service
         NetManHandler(std::move(packet_ptr));
         break;
     }
     default: // pass packet to service handler
     {
-        // Check if the service identifier is greater than the size of the
-        // service list
-        if (packetService >= serviceLookup.size()) {
-            // Dump the packet
-            return;
-        }
-
         // Extract the packet callback handler
-        PacketHandlerCb callback = serviceLookup.at(packetService);
+        const PacketHandlerRef &callback = serviceLookup[packetService];
 
         // Check for an empty packet callback handler
         if (!callback) {
             // Dump the packet
+            countDrop(DROP_REASON::NO_SERVICE);
             return;
         }
 
-        // Call the packet callback handler
+        // Count the delivery
+        _stats.serviceDeliveries[packetService]++;
+
+        // Call the packet callback handler in place
         callback(std::move(packet_ptr));
         break;
     }
@@ -482,12 +682,15 @@ void RnpNetworkManager::NetManHandler(packetptr_t packet_ptr) {
     switch (static_cast<NETMAN_TYPES>(packet_ptr->header.type)) {
     case NETMAN_TYPES::PING_REQ: { // Ping request
         // Deserialize packet
-        PingPacket ping(*packet_ptr);
+        auto ping = decodeNetMan<PingPacket>(*packet_ptr);
+        if (!ping) {
+            break;
+        }
         //uid is implicitly copied here
-        PingPacket pong(ping.data);
+        PingPacket pong(ping->data);
 
         //generate response header (pong) based on request packet (ping)
-        RnpHeader::generateResponseHeader(ping.header,pong.header);
+        RnpHeader::generateResponseHeader(ping->header,pong.header);
 
         // Set response type
         pong.header.type = (uint8_t)NETMAN_TYPES::PING_RES;
@@ -496,87 +699,109 @@ void RnpNetworkManager::NetManHandler(packetptr_t packet_ptr) {
         sendPacket(pong);
 
         // Log sent response
-        log("Ping sent");
+        log<LOG_LEVEL::INFO>("Ping sent");
         break;
     }
     case NETMAN_TYPES::PING_RES: { // Ping response
         // Deserialize packet
-        GenericRnpPacket packet(*packet_ptr);
+        auto packet = decodeNetMan<GenericRnpPacket>(*packet_ptr);
+        if (!packet) {
+            break;
+        }
 
         // Log received ping
-        log("Ping received with systime of " + std::to_string(packet.data));
+        log<LOG_LEVEL::INFO>("Ping received with systime of ", packet->data);
         break;
     }
     case NETMAN_TYPES::SET_ADDRESS: { // Set address
         // Deserialize packet
-        GenericRnpPacket packet(*packet_ptr);
+        auto packet = decodeNetMan<GenericRnpPacket>(*packet_ptr);
+        if (!packet) {
+            break;
+        }
 
         // Set address from packet data
-        setAddress(static_cast<uint8_t>(packet.data));
+        setAddress(static_cast<uint8_t>(packet->data));
 
         // Log address change
-        log("Node address is now " +
-            std::to_string(static_cast<uint8_t>(packet.data)));
+        log<LOG_LEVEL::INFO>("Node address is now ",
+                             static_cast<uint8_t>(packet->data));
         break;
     }
     case NETMAN_TYPES::SET_ROUTE: { // Set route
         // Deserialize packet
-        SetRoutePacket setroutepacket(*packet_ptr);
+        auto setroutepacket = decodeNetMan<SetRoutePacket>(*packet_ptr);
+        if (!setroutepacket) {
+            break;
+        }
 
         // Set route
-        routingtable.setRoute(setroutepacket.destination,
-                              setroutepacket.getRoute());
+        routingtable.setRoute(setroutepacket->destination,
+                              setroutepacket->getRoute());
 
         // Log route change
-        log("Route for Node " + std::to_string(setroutepacket.destination) +
-            " has been updated");
+        log<LOG_LEVEL::INFO>("Route for Node ", setroutepacket->destination,
+                             " has been updated");
         break;
     }
     case NETMAN_TYPES::SET_TYPE: { // Set node type
         // Deserialize packet
-        GenericRnpPacket packet(*packet_ptr);
+        auto packet = decodeNetMan<GenericRnpPacket>(*packet_ptr);
+        if (!packet) {
+            break;
+        }
 
         // Set node type
-        _config.nodeType = static_cast<NODETYPE>(packet.data);
+        _config.nodeType = static_cast<NODETYPE>(packet->data);
 
         // Log change to node type
-        log("Node type is now " +
-            std::to_string(static_cast<uint8_t>(packet.data)));
+        log<LOG_LEVEL::INFO>("Node type is now ",
+                             static_cast<uint8_t>(packet->data));
         break;
     }
     case NETMAN_TYPES::SET_NOROUTEACTION: { // Set no route action
         // Deserialize packet
-        GenericRnpPacket packet(*packet_ptr);
+        auto packet = decodeNetMan<GenericRnpPacket>(*packet_ptr);
+        if (!packet) {
+            break;
+        }
 
         // Set no route action
-        _config.noRouteAction = static_cast<NOROUTE_ACTION>(packet.data);
+        _config.noRouteAction = static_cast<NOROUTE_ACTION>(packet->data);
 
         // Log change in no route action
-        log("Node NoRouteAction is now " +
-            std::to_string(static_cast<uint8_t>(packet.data)));
+        log<LOG_LEVEL::INFO>("Node NoRouteAction is now ",
+                             static_cast<uint8_t>(packet->data));
         break;
     }
     case NETMAN_TYPES::SET_ROUTEGEN: { // Set automatic route generation
         // Deserialize packet
-        GenericRnpPacket packet(*packet_ptr);
+        auto packet = decodeNetMan<GenericRnpPacket>(*packet_ptr);
+        if (!packet) {
+            break;
+        }
 
         // Set automatic route generation
-        _config.routeGenEnabled = static_cast<bool>(packet.data);
+        _config.routeGenEnabled = static_cast<bool>(packet->data);
 
         // Log change in automatic route generation
-        log("Node RouteGen is now " +
-            std::to_string(static_cast<bool>(packet.data)));
+        log<LOG_LEVEL::INFO>("Node RouteGen is now ",
+                             static_cast<bool>(packet->data));
         break;
     }
     case NETMAN_TYPES::SAVE_CONF: { // Save configuration
         // Check for save configuration implementation
         if (_saveConfigImpl) {
             // Save configuration, log if successful
-            _saveConfigImpl(_config) ? log("Configuration Failed to Save!")
-                                     : log("Configuration Saved!");
+            if (_saveConfigImpl(_config)) {
+                log<LOG_LEVEL::ERR>("Configuration Failed to Save!");
+            } else {
+                log<LOG_LEVEL::INFO>("Configuration Saved!");
+            }
         } else {
             // Log lack of save configuration implementation
-            log("No Save Configuration Implementation Provided - Not Saved!");
+            log<LOG_LEVEL::WARN>(
+                "No Save Configuration Implementation Provided - Not Saved!");
         }
 
         break;
@@ -586,6 +811,39 @@ void RnpNetworkManager::NetManHandler(packetptr_t packet_ptr) {
         reset();
         break;
     }
+    case NETMAN_TYPES::HOP_LIMIT: { // Hop limit notification
+        // Deserialize packet
+        auto packet = decodeNetMan<GenericRnpPacket>(*packet_ptr);
+        if (!packet) {
+            break;
+        }
+
+        // Log the dropped packet
+        log<LOG_LEVEL::ERR>("Packet to Node ",
+                            static_cast<uint8_t>(packet->data),
+                            " dropped at hop limit by Node ",
+                            packet->header.source);
+        break;
+    }
+    case NETMAN_TYPES::GET_STATS: { // Get statistics
+        // Deserialize packet
+        auto request = decodeNetMan<GenericRnpPacket>(*packet_ptr);
+        if (!request) {
+            break;
+        }
+
+        // Report the selected interface and service
+        NetworkStatsPacket response(getStats(),
+                                    static_cast<uint8_t>(request->data),
+                                    static_cast<uint8_t>(request->data >> 8));
+
+        // Generate response header based on the request
+        RnpHeader::generateResponseHeader(request->header, response.header);
+
+        // Send response
+        sendPacket(response);
+        break;
+    }
     case NETMAN_TYPES::NODEINFO:{
 
         std::stringstream info;
@@ -611,7 +869,54 @@ void RnpNetworkManager::NetManHandler(packetptr_t packet_ptr) {
     }
 };
 
-void RnpNetworkManager::forwardPacket(RnpPacket &packet) {
+const RnpNetworkStats &RnpNetworkManager::getStats() {
+    // Packets rejected by the packet buffer are counted by the buffer, as
+    // interfaces may push from other threads
+    _stats.drops[static_cast<size_t>(DROP_REASON::BUFFER_FULL)] =
+        packetBufferInterface.rejected() - _rejectedAtReset;
+
+    return _stats;
+}
+
+void RnpNetworkManager::resetStats() {
+    // Zero the counters, keeping an entry for every interface
+    _stats.interfaces.assign(_stats.interfaces.size(), RnpInterfaceStats{});
+    _stats.serviceDeliveries.fill(0);
+    _stats.drops.fill(0);
+
+    // Rebase the packet buffer count
+    _rejectedAtReset = packetBufferInterface.rejected();
+}
+
+void RnpNetworkManager::hopLimitReached(const RnpHeader &header) {
+    // Count the dropped packet
+    countDrop(DROP_REASON::LOOP);
+
+    // Log the dropped packet
+    log<LOG_LEVEL::ERR>("Hop limit reached, packet from Node ", header.source,
+                        " to Node ", header.destination, " dropped");
+
+    // Do not notify about notifications, which could loop themselves
+    if (!_config.hopLimitNotify ||
+        ((header.destination_service ==
+          static_cast<uint8_t>(DEFAULT_SERVICES::NETMAN)) &&
+         (header.type == static_cast<uint8_t>(NETMAN_TYPES::HOP_LIMIT)))) {
+        return;
+    }
+
+    // Notify the network manager of the source
+    HopLimitPacket notification(header.destination);
+    notification.header.uid = header.uid;
+    notification.header.source_service =
+        static_cast<uint8_t>(DEFAULT_SERVICES::NETMAN);
+    notification.header.source = _config.currentAddress;
+    notification.header.destination = header.source;
+
+    // Send notification
+    sendPacket(notification);
+}
+
+void RnpNetworkManager::forwardPacket(RnpPacketSerialized &packet) {
     // Check if the packet is from debug and has no address
     if (packet.header.source == static_cast<uint8_t>(DEFAULT_ADDRESS::DEBUG) &&
         packet.header.source_service ==
@@ -623,46 +928,32 @@ void RnpNetworkManager::forwardPacket(RnpPacket &packet) {
         return;
     };
 
-    // Send the packet
-    sendPacket(packet);
-}
-
-void RnpNetworkManager::log(const std::string &msg) {
-    // Do nothing if logging is disabled
-    if (!_loggingEnabled) {
+    // Drop the packet if forwarding it would exceed the hop limit
+    if ((_config.maxHops != 0) && (packet.header.hops >= _config.maxHops)) {
+        hopLimitReached(packet.header);
         return;
     }
 
-    // Use default logging if no logging callback is set
-    if (!_logcb) {
-#if defined(ARDUINO)
-        // Print log message to serial
-        Serial.println(msg.c_str());
-#else
-        // Print log message to standard output
-        std::cout << msg << "\n";
-#endif
-        return;
-    }
+    // Increment the number of hops of the packet
+    packet.header.hops += 1;
 
-    // Log via the logging callback
-    _logcb(msg);
-};
+    // Patch the changed header fields into the received bytes, rather than
+    // re-serializing the header
+    packet.patchForwardingHeader();
 
+    // Send the received bytes as they are
+    const RnpWireBuffer wire(RnpBufferView(packet.packet));
+    dispatchPacket(packet, &wire);
+}
 
 bool RnpNetworkManager::validPacket(const RnpPacket& packet)
 {
     // verify expected protocl
     if (packet.header.start_byte != RnpVersionID)
     {
-        std::stringstream logstring; 
-        logstring << "[E] header protocol mismatch, expected: 0x" 
-                  << std::hex << static_cast<int>(RnpVersionID) 
-                  << ", decoded: 0x" 
-                  << std::hex << static_cast<int>(packet.header.start_byte)
-                  << "!";
-
-        log(logstring.str());
+        log<LOG_LEVEL::ERR>("header protocol mismatch, expected: 0x",
+                            RnpLogHex{RnpVersionID}, ", decoded: 0x",
+                            RnpLogHex{packet.header.start_byte}, "!");
 
         return false;
     }
@@ -671,7 +962,8 @@ bool RnpNetworkManager::validPacket(const RnpPacket& packet)
     if (packet.header.source == static_cast<uint8_t>(DEFAULT_ADDRESS::NOADDRESS) && 
         packet.header.destination == static_cast<uint8_t>(DEFAULT_ADDRESS::NOADDRESS) )
     {
-        log("[E] Invalid addressing, both source and destination is 0!");
+        log<LOG_LEVEL::ERR>(
+            "Invalid addressing, both source and destination is 0!");
         return false;
     }
     
@@ -12,22 +12,71 @@
 #include "rnp_interface.h"
 #include "rnp_packet.h"
 #include "rnp_routingtable.h"
+#include "rnp_circularbuffer.h"
+#include "rnp_duplicatefilter.h"
+#include "rnp_logger.h"
+#include "rnp_mpscringbuffer.h"
+#include "rnp_networkstats.h"
 #include "rnp_packetbufferinterface.h"
-
-/// @brief Packet pointer type
-using packetptr_t = std::unique_ptr<RnpPacketSerialized>;
+#include "rnp_packetpool.h"
 
 /// @brief Packet buffer type
-using packetBuffer_t = std::queue<packetptr_t>;
+using packetBuffer_t = std::queue<packetptr_t, Rnp_CircularBuffer<packetptr_t>>;
 
 /// @brief Packet Buffer Interface Type
-using packetBufferInterface_t = Rnp_PacketBufferInterface<packetptr_t>;
+using packetBufferInterface_t = Rnp_PacketBufferInterface<packetptr_t, packetBuffer_t>;
 
 /// @brief Packet callback handler type
 using PacketHandlerCb = std::function<void(packetptr_t)>;
 
-/// @brief Logging callback type
-using LogCb_t = std::function<void(const std::string &)>;
+/**
+ * @brief Non-owning, non-allocating packet handler
+ *
+ * Binds a context pointer to a plain function pointer, so it can be copied
+ * and invoked without touching the heap. The context must outlive the
+ * registration of the handler. RnpNetworkService::getHandlerRef() creates one
+ * bound to a service.
+ */
+class PacketHandlerRef {
+public:
+    /// @brief Handler function type
+    using function_t = void (*)(void *context, packetptr_t packet_ptr);
+
+    /**
+     * @brief Construct an empty handler
+     */
+    constexpr PacketHandlerRef() : _context(nullptr), _function(nullptr){};
+
+    /**
+     * @brief Construct a handler
+     *
+     * @param[in] context Context passed to the function
+     * @param[in] function Handler function
+     */
+    constexpr PacketHandlerRef(void *context, function_t function)
+        : _context(context), _function(function){};
+
+    /**
+     * @brief Check if the handler is bound to a function
+     */
+    constexpr explicit operator bool() const { return _function != nullptr; };
+
+    /**
+     * @brief Invoke the handler
+     *
+     * @param[in] packet_ptr Pointer to packet
+     */
+    void operator()(packetptr_t packet_ptr) const {
+        _function(_context, std::move(packet_ptr));
+    };
+
+private:
+    /// @brief Context passed to the function
+    void *_context;
+
+    /// @brief Handler function
+    function_t _function;
+};
 
 /**
  * @brief Enumerate for node type
@@ -65,12 +114,38 @@ enum class NOROUTE_ACTION : uint8_t {
     /**
      * @brief Broadcast the packet to the specifed interfaces
      *
-     * @warning Be careful of packet duplication: no de-duplication service has
-     * been written yet
+     * @warning Be careful of packet duplication in meshed topologies, enable
+     * the duplicate filter with RnpNetworkManager::setDuplicateFilter()
      */
     BROADCAST = 1,
 };
 
+/**
+ * @brief Enumerate for the packet buffer backing store
+ */
+enum class PACKETBUFFER_TYPE : uint8_t {
+    /**
+     * @brief Unsynchronized queue
+     *
+     * Interfaces must push packets from the same thread as the network
+     * manager.
+     */
+    QUEUE = 0,
+
+    /**
+     * @brief Bounded lock-free multi-producer/single-consumer ring buffer
+     *
+     * Interfaces may push packets from other threads or cores without a
+     * mutex. The ring is bounded, so a maxBufferSize of 0 uses a default of
+     * 256 packets.
+     *
+     * @warning The packet pool is not thread safe, so it is only used by the
+     * loopback interface. Packets received by other interfaces are heap
+     * allocated.
+     */
+    MPSC_RING = 1,
+};
+
 /**
  * @brief Enumerate for default services
  *
@@ -117,6 +192,26 @@ struct RnpNetworkManagerConfig {
 
     /// @brief Flag for route generation
     bool routeGenEnabled;
+
+    /// @brief Maximum number of hops a packet can make, packets which would
+    /// exceed it are dropped rather than forwarded. 0 for no limit, defaults
+    /// to 16.
+    uint8_t maxHops = 16;
+
+    /// @brief Flag for notifying the source of a packet dropped at the hop
+    /// limit with a NETMAN HOP_LIMIT packet
+    bool hopLimitNotify = false;
+};
+
+/**
+ * @brief Result of a network manager update
+ */
+struct RnpUpdateResult {
+    /// @brief Number of packets taken from the packet buffer and processed
+    size_t processed;
+
+    /// @brief Number of packets left in the packet buffer
+    size_t queued;
 };
 
 /// @brief Implementation of the save config function
@@ -152,11 +247,18 @@ public:
      * @param[in] address Address (default: 0)
      * @param[in] nodeType Node type (default: leaf)
      * @param[in] enableLogging Logging flag (default: false)
+     * @param[in] maxBufferSize Maximum number of queued packets, 0 is
+     * unbounded (default: 200)
+     * @param[in] packetPoolCapacity Number of preallocated packets, 0 disables
+     * the pool (default: 0)
+     * @param[in] packetBufferType Packet buffer backing store (default: queue)
      */
     RnpNetworkManager(const uint8_t address = 0,
                       const NODETYPE nodeType = NODETYPE::LEAF,
                       const bool enableLogging = false,
-                      const size_t maxBufferSize=200);
+                      const size_t maxBufferSize=200,
+                      const size_t packetPoolCapacity=0,
+                      const PACKETBUFFER_TYPE packetBufferType=PACKETBUFFER_TYPE::QUEUE);
 
     /**
      * @brief Construct a new Rnp Network Manager object
@@ -165,10 +267,17 @@ public:
      *
      * @param[in] config Network manager configuration
      * @param[in] enableLogging Logging flag (default: flase)
+     * @param[in] maxBufferSize Maximum number of queued packets, 0 is
+     * unbounded (default: 200)
+     * @param[in] packetPoolCapacity Number of preallocated packets, 0 disables
+     * the pool (default: 0)
+     * @param[in] packetBufferType Packet buffer backing store (default: queue)
      */
     RnpNetworkManager(const RnpNetworkManagerConfig config,
                       const bool enableLogging = false,
-                      const size_t maxBufferSize=200);
+                      const size_t maxBufferSize=200,
+                      const size_t packetPoolCapacity=0,
+                      const PACKETBUFFER_TYPE packetBufferType=PACKETBUFFER_TYPE::QUEUE);
 
     /**
      * @brief Reconfigure newtork manager
@@ -185,11 +294,115 @@ public:
      * @brief Update network manager
      *
      * Runs update routine on all interfaces in the iflist, and routePacket
-     * command to process any received packets
+     * command to process any received packets. The number of packets
+     * processed per call is limited by the routing budget, see
+     * setRoutingBudget(). Finally every interface is flushed, so packets
+     * batched while routing are transmitted.
      *
      * @author Kiran de Silva
+     *
+     * @return RnpUpdateResult Number of packets processed and still queued
      */
-    void update();
+    RnpUpdateResult update();
+
+    /**
+     * @brief Update network manager, only updating the given interfaces
+     *
+     * As update(), for event driven runners such as RnpEventLoop which know
+     * which interfaces have data to receive. Every interface is still
+     * flushed.
+     *
+     * @param[in] ifaceIDs Identifiers of the interfaces to update
+     * @return RnpUpdateResult Number of packets processed and still queued
+     */
+    RnpUpdateResult update(const std::vector<uint8_t> &ifaceIDs);
+
+    /**
+     * @brief Set how many packets are taken from the packet buffer per call
+     * to update()
+     *
+     * Packets are processed until either limit is reached, whichever comes
+     * first. At least one queued packet is always processed. The default of
+     * one packet and no time limit processes a single packet per update().
+     *
+     * @param[in] maxPackets Maximum number of packets per update, 0 drains the
+     * packets which were queued when the update started
+     * @param[in] maxTime_us Time budget in microseconds, 0 for no time limit
+     */
+    void setRoutingBudget(const size_t maxPackets, const uint32_t maxTime_us = 0) {
+        _routingBudgetPackets = maxPackets;
+        _routingBudgetTime = maxTime_us;
+    };
+
+    /**
+     * @brief Drop packets already routed within a time window
+     *
+     * Packets are identified by their source, uid and type. Locally originated
+     * packets sent with a uid of 0 are assigned a fresh uid each time they are
+     * sent, so a packet object can be sent again, packets with a uid of 0 are
+     * never dropped. Packets received over the loopback interface are not
+     * filtered. Disabled by default.
+     *
+     * @warning A packet object sent again with the same non-zero uid within
+     * the window is dropped as a duplicate.
+     *
+     * @param[in] window_ms Window in milliseconds, 0 disables the filter
+     * @param[in] capacity Number of packets remembered over the window
+     */
+    void setDuplicateFilter(const uint32_t window_ms,
+                            const size_t capacity = 256) {
+        _duplicateFilter.configure(window_ms, capacity);
+    };
+
+    /**
+     * @brief Get the number of packets dropped by the duplicate filter
+     *
+     * @return size_t Number of duplicate packets
+     */
+    size_t getDuplicateCount() const {
+        return _stats.dropped(DROP_REASON::DUPLICATE);
+    };
+
+    /**
+     * @brief Set the maximum number of hops a packet can make
+     *
+     * Packets which have already made this many hops are dropped instead of
+     * being forwarded, so a routing loop cannot circulate a packet forever.
+     * The limit is 16 unless set. Only nodes which forward packets, i.e hubs,
+     * count and notify hop limit drops.
+     *
+     * @param[in] maxHops Maximum number of hops, 0 for no limit
+     * @param[in] notify Send a NETMAN HOP_LIMIT packet back to the source of
+     * dropped packets
+     */
+    void setHopLimit(const uint8_t maxHops, const bool notify = false) {
+        _config.maxHops = maxHops;
+        _config.hopLimitNotify = notify;
+    };
+
+    /**
+     * @brief Get the number of packets dropped at the hop limit
+     *
+     * @return size_t Number of packets
+     */
+    size_t getHopLimitCount() const {
+        return _stats.dropped(DROP_REASON::LOOP);
+    };
+
+    /**
+     * @brief Get the traffic statistics
+     *
+     * Also available remotely with a NETMAN GET_STATS request.
+     *
+     * @return const RnpNetworkStats& Statistics, updated as packets are
+     * routed
+     */
+    const RnpNetworkStats &getStats();
+
+    /**
+     * @brief Zero the traffic statistics
+     */
+    void resetStats();
 
     /**
      * @brief Reset the networking configuration
@@ -236,8 +449,11 @@ public:
      *
      * @param[in] route Route
      * @param[in] packet Packet
+     * @param[in] wire Already serialized packet, nullptr to let the interface
+     * serialize the packet
      */
-    void sendByRoute(const Route &route, RnpPacket &packet);
+    void sendByRoute(const Route &route, RnpPacket &packet,
+                     const RnpWireBuffer *wire = nullptr);
 
     /**
      * @brief Set the address of the node
@@ -305,6 +521,16 @@ public:
      */
     std::optional<RnpInterface *> getInterface(const uint8_t ifaceID);
 
+    /**
+     * @brief Get the interface list, indexed by interface identifier
+     *
+     * @return const std::vector<RnpInterface *>& Interfaces, nullptr where
+     * no interface is added
+     */
+    const std::vector<RnpInterface *> &getInterfaces() const {
+        return ifaceList;
+    };
+
     /**
      * @brief Remove interface from the interface list
      *
@@ -357,11 +583,26 @@ public:
      * @author Kiran de Silva
      *
      * @param[in] serviceID Service identifier
-     * @param[in] packetHandler Callback handler
+     * @param[in] packetHandler Callback handler, an empty callback
+     * unregisters the service
      */
     void registerService(const uint8_t serviceID,
                          PacketHandlerCb packetHandler);
 
+    /**
+     * @brief Register a non-owning packet handler for a specified service
+     * identifier.
+     *
+     * Unlike a PacketHandlerCb, the handler is not copied into the network
+     * manager, so the object it refers to must outlive the registration.
+     *
+     * @param[in] serviceID Service identifier
+     * @param[in] packetHandler Non-owning callback handler, i.e from
+     * RnpNetworkService::getHandlerRef()
+     */
+    void registerService(const uint8_t serviceID,
+                         PacketHandlerRef packetHandler);
+
     /**
      * @brief Remove callback by service identifier.
      *
@@ -378,15 +619,31 @@ public:
      * @brief Pass a logging callback to allow logging of errors from the
      * network manager.
      *
+     * With async set, messages are queued and the callback is called from a
+     * background thread (a low priority task on the ESP-IDF), so a slow
+     * output does not stall routing. Messages are dropped when the queue is
+     * full, see getLogDropCount().
+     *
      * @author Kiran de Silva
      *
-     * @param[in] logcb Logging callback
+     * @param[in] logcb Logging callback, empty for the default output
+     * @param[in] async Call the callback from a background thread
+     * @param[in] queueSize Maximum number of queued messages when async
      */
-    void setLogCb(LogCb_t logcb) {
+    void setLogCb(LogCb_t logcb, const bool async = false,
+                  const size_t queueSize = 32) {
         // Set callback
-        _logcb = logcb;
+        _logger.setCallback(logcb, async, queueSize);
     };
 
+    /**
+     * @brief Get the number of log messages dropped as the asynchronous log
+     * queue was full
+     *
+     * @return uint32_t Dropped messages, wraps around
+     */
+    uint32_t getLogDropCount() const { return _logger.dropped(); };
+
     /**
      * @brief Set the flag for automatic route generation
      *
@@ -446,20 +703,58 @@ public:
 
 private:
     /**
-     * @brief Process any received packet
+     * @brief Route the received packets and flush every interface, ending an
+     * update
+     *
+     * @return RnpUpdateResult Number of packets processed and still queued
+     */
+    RnpUpdateResult finishUpdate();
+
+    /**
+     * @brief Process received packets within the routing budget
      *
      * @author Kiran de Silva
+     *
+     * @return size_t Number of packets processed
+     */
+    size_t routePackets();
+
+    /**
+     * @brief Process a single received packet
+     *
+     * @param[in] packet_ptr Pointer to packet
      */
-    void routePackets();
+    void routePacket(packetptr_t packet_ptr);
 
     /**
      * @brief Forward packet
      *
      * @author Kiran de Silva
      *
+     * Only the source and hops are changed, and they are patched into the
+     * received bytes in place, which are then handed to the egress interface
+     * without serializing the packet again.
+     *
      * @param[in] packet Packet
      */
-    void forwardPacket(RnpPacket &packet);
+    void forwardPacket(RnpPacketSerialized &packet);
+
+    /**
+     * @brief Count and log a packet dropped at the hop limit, notifying its
+     * source if enabled
+     *
+     * @param[in] header Header of the dropped packet
+     */
+    void hopLimitReached(const RnpHeader &header);
+
+    /**
+     * @brief Route a packet to the interface(s) it should be sent over
+     *
+     * @param[in] packet Packet
+     * @param[in] wire Already serialized packet, nullptr if the packet has not
+     * been serialized
+     */
+    void dispatchPacket(RnpPacket &packet, const RnpWireBuffer *wire);
 
     /**
      * @brief Internal network management packet handler
@@ -483,14 +778,43 @@ private:
      */
     bool validPacket(const RnpPacket& packet);
 
+    /// @brief Packet pool, declared before the buffer so it outlives any
+    /// queued packets
+    RnpPacketPool packetPool;
+
     /// @brief Packet buffer
     packetBuffer_t packetBuffer;
 
+    /// @brief Lock-free packet buffer, used instead of packetBuffer if
+    /// selected at construction
+    Rnp_MPSCRingBuffer<packetptr_t> packetRing;
+
     /// @brief Packet Buffer Interface
     packetBufferInterface_t packetBufferInterface;
 
-    /// @brief Service lookup
-    std::vector<PacketHandlerCb> serviceLookup;
+    /**
+     * @brief Service lookup, indexed directly by service identifier
+     *
+     * Handlers registered as a PacketHandlerCb are owned by
+     * _serviceCallbacks, and the lookup entry refers to them.
+     */
+    std::array<PacketHandlerRef, 256> serviceLookup;
+
+    /// @brief Owned service callbacks, by service identifier
+    std::vector<std::pair<uint8_t, std::unique_ptr<PacketHandlerCb>>>
+        _serviceCallbacks;
+
+    /// @brief Unregistered or replaced service callbacks. Kept alive until
+    /// routing returns, so a handler can safely unregister or replace any
+    /// service, including its own.
+    std::vector<std::unique_ptr<PacketHandlerCb>> _retiredServiceCallbacks;
+
+    /**
+     * @brief Release the owned callback for a service identifier, if any
+     *
+     * @param[in] serviceID Service identifier
+     */
+    void releaseServiceCallback(const uint8_t serviceID);
 
     /// @brief Loopback (owned by the network manager by default)
     Loopback lo;
@@ -514,18 +838,93 @@ private:
     /// @brief Copy of the initial routing table
     RoutingTable _basetable;
 
+    /// @brief Buffer for packets serialized once for several interfaces
+    std::shared_ptr<std::vector<uint8_t>> _wireBuffer;
+
+    /**
+     * @brief Serialize a packet into a shared wire buffer
+     *
+     * The buffer is reused for the next packet unless an interface retained a
+     * copy of the wire buffer.
+     *
+     * @param[in] packet Packet
+     * @return RnpWireBuffer Serialized packet
+     */
+    RnpWireBuffer serializeShared(RnpPacket &packet);
+
+    /// @brief Maximum number of packets routed per update, 0 drains the
+    /// packets queued at the start of the update
+    size_t _routingBudgetPackets = 1;
+
+    /// @brief Maximum time spent routing per update in microseconds, 0 for no
+    /// limit
+    uint32_t _routingBudgetTime = 0;
+
+    /// @brief Filter for packets already routed
+    RnpDuplicateFilter _duplicateFilter;
+
+    /// @brief Traffic statistics
+    RnpNetworkStats _stats;
+
+    /// @brief Packet buffer rejections when the statistics were reset
+    uint32_t _rejectedAtReset = 0;
+
+    /**
+     * @brief Count a dropped packet
+     *
+     * @param[in] reason Drop reason
+     */
+    void countDrop(const DROP_REASON reason) {
+        _stats.drops[static_cast<size_t>(reason)]++;
+    };
+
+    /**
+     * @brief Decode a network management packet, logging and counting it as
+     * invalid if it is malformed
+     *
+     * @tparam PACKET Packet type, providing tryDecode()
+     * @param[in] packet Serialized packet
+     * @return RnpDecodeResult<PACKET> Decoded packet, or the decode error
+     */
+    template <class PACKET>
+    RnpDecodeResult<PACKET> decodeNetMan(const RnpPacketSerialized &packet) {
+        RnpDecodeResult<PACKET> result = PACKET::tryDecode(packet);
+
+        // Drop malformed packets rather than throwing from the handler
+        if (!result) {
+            log<LOG_LEVEL::ERR>("Malformed NetMan packet of type ",
+                                packet.header.type, " dropped: ",
+                                rnpDecodeErrorString(result.error()));
+            countDrop(DROP_REASON::INVALID);
+        }
+        return result;
+    }
+
+    /// @brief Next uid assigned to locally originated packets
+    uint16_t _nextUid;
+
     /// @brief Logging flag
     const bool _loggingEnabled;
 
-    /// @brief Logging function callback
-    LogCb_t _logcb;
+    /// @brief Logger
+    RnpLogger _logger;
 
     /**
      * @brief Log message
      *
-     * @author Kiran de Silva
-     *
-     * @param[in] msg Message
-     */
-    void log(const std::string &msg);
+     * Messages above RNP_LOG_LEVEL are compiled out along with their
+     * arguments, other messages are only formatted if logging is enabled.
+     *
+     * @tparam LEVEL Log level
+     * @param[in] args Message parts, concatenated
+     */
+    template <LOG_LEVEL LEVEL, typename... ARGS>
+    void log(const ARGS &...args) {
+        if constexpr (RnpLogger::compiledIn<LEVEL>()) {
+            // Do nothing if logging is disabled
+            if (_loggingEnabled) {
+                _logger.log(LEVEL, args...);
+            }
+        }
+    }
 };
@@ -36,6 +36,23 @@ public:
         };
     };
 
+    /**
+     * @brief Get a non-owning network callback bound to the current instance
+     * of the class
+     *
+     * Unlike getCallback(), invoking the handler never allocates. The service
+     * must be unregistered before it is destroyed.
+     *
+     * @return PacketHandlerRef Non-owning network callback
+     */
+    PacketHandlerRef getHandlerRef() {
+        // Return a handler calling back into this instance
+        return PacketHandlerRef(this, [](void *context, packetptr_t packetptr) {
+            static_cast<RnpNetworkService *>(context)->networkCallback(
+                std::move(packetptr));
+        });
+    };
+
     /**
      * @brief Get the service identifier
      *
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Reasons a packet is dropped by the network manager
+ */
+enum class DROP_REASON : uint8_t {
+    /// @brief Packet buffer full when an interface received the packet
+    BUFFER_FULL = 0,
+
+    /// @brief Packet failed validation
+    INVALID = 1,
+
+    /// @brief No route to the destination and the no route action is dump
+    NO_ROUTE = 2,
+
+    /// @brief No handler registered for the destination service
+    NO_SERVICE = 3,
+
+    /// @brief Hop limit reached, i.e the packet is in a routing loop
+    LOOP = 4,
+
+    /// @brief Packet already routed, dropped by the duplicate filter
+    DUPLICATE = 5,
+
+    /// @brief Forwarding would send the packet back out of the interface it
+    /// was received on
+    SAME_IFACE = 6,
+
+    /// @brief Number of drop reasons
+    COUNT = 7,
+};
+
+/**
+ * @brief Traffic counters for an interface
+ *
+ * Counters are 32 bit and wrap, so rates should be calculated from the
+ * difference between two readings.
+ */
+struct RnpInterfaceStats {
+    /// @brief Packets received and routed
+    uint32_t rxPackets = 0;
+
+    /// @brief Bytes received and routed
+    uint32_t rxBytes = 0;
+
+    /// @brief Packets sent
+    uint32_t txPackets = 0;
+
+    /// @brief Bytes sent
+    uint32_t txBytes = 0;
+};
+
+/**
+ * @brief Network manager traffic counters
+ */
+struct RnpNetworkStats {
+    /// @brief Counters per interface, indexed by interface identifier
+    std::vector<RnpInterfaceStats> interfaces;
+
+    /// @brief Packets delivered to each service, indexed by service identifier
+    std::array<uint32_t, 256> serviceDeliveries{};
+
+    /// @brief Dropped packets, indexed by DROP_REASON
+    std::array<uint32_t, static_cast<size_t>(DROP_REASON::COUNT)> drops{};
+
+    /**
+     * @brief Get the number of packets dropped for a reason
+     *
+     * @param[in] reason Drop reason
+     * @return uint32_t Number of packets
+     */
+    uint32_t dropped(const DROP_REASON reason) const {
+        return drops[static_cast<size_t>(reason)];
+    };
+};
@@ -37,6 +37,8 @@ namespace RnpNvsSave {
         pref.putUChar("nodeType", static_cast<uint8_t>(config.nodeType)) ?: error++;
         pref.putUChar("noRouteAction", static_cast<uint8_t>(config.noRouteAction)) ?: error++;
         pref.putBool("routeGen", config.routeGenEnabled) ?: error++;
+        pref.putUChar("maxHops", config.maxHops) ?: error++;
+        pref.putBool("hopNotify", config.hopLimitNotify) ?: error++;
 
         // Return error status
         return error;
@@ -69,6 +71,8 @@ namespace RnpNvsSave {
         config.nodeType = static_cast<NODETYPE>(pref.getUChar("nodeType"));
         config.noRouteAction = static_cast<NOROUTE_ACTION>(pref.getUChar("noRouteAction"));
         config.routeGenEnabled = pref.getBool("routeGen", config.routeGenEnabled);
+        config.maxHops = pref.getUChar("maxHops", config.maxHops);
+        config.hopLimitNotify = pref.getBool("hopNotify", config.hopLimitNotify);
 
         // Return unsuccessful read if the current address is illegal
         if (config.currentAddress == 0) {
@@ -103,6 +107,8 @@ namespace RnpNvsSave {
         std::cout << "nodeType:" + std::to_string(static_cast<uint8_t>(config.nodeType))<< "\n";
         std::cout << "noRouteAction:" + std::to_string(static_cast<uint8_t>(config.noRouteAction)) << "\n";
         std::cout << "routeGenEnabled:" + std::to_string(config.routeGenEnabled) << "\n";
+        std::cout << "maxHops:" + std::to_string(config.maxHops) << "\n";
+        std::cout << "hopLimitNotify:" + std::to_string(config.hopLimitNotify) << "\n";
 
         // Return successful output
         return false;
@@ -125,6 +131,8 @@ namespace RnpNvsSave {
         config.nodeType = static_cast<NODETYPE>(1);
         config.noRouteAction = static_cast<NOROUTE_ACTION>(1);
         config.routeGenEnabled = 1;
+        config.maxHops = 16;
+        config.hopLimitNotify = 0;
 
         // Return successful input
         return false;
@@ -1,6 +1,7 @@
 #include "rnp_packet.h"
 #include "rnp_header.h"
 
+#include <cstring>
 #include <vector>
 
 RnpPacket::~RnpPacket(){};
@@ -13,43 +14,109 @@ RnpPacket::RnpPacket(const RnpHeader header) : header(header){};
 
 RnpPacket::RnpPacket(const RnpPacketSerialized &serializedPacket, size_t size)
     : header(serializedPacket.header) {
-    // Throw error if header size does not match expected size
-    if (header.packet_len != size) {
-        throw std::runtime_error("Header size does not match expected size!");
+    // Fail if the header or body size does not match the expected size
+    const RnpDecodeError error = checkSize(serializedPacket, size);
+    if (error != RnpDecodeError::NONE) {
+        rnpDecodeFailed(error);
+    }
+};
+
+RnpDecodeError RnpPacket::checkSize(const RnpPacketSerialized &serializedPacket,
+                                    size_t size) {
+    // Check header size matches expected size
+    if (serializedPacket.header.packet_len != size) {
+        return RnpDecodeError::LENGTH_MISMATCH;
     }
 
-    // Throw error if body size does not match expected size
+    // Check body size matches expected size
     if (serializedPacket.getBodySize() != size) {
-        throw std::runtime_error("Buffer len does not match expected size!");
+        return RnpDecodeError::BODY_SIZE_MISMATCH;
     }
-};
+
+    return RnpDecodeError::NONE;
+}
 
 void RnpPacket::serialize(std::vector<uint8_t> &buf) {
     // Serialize the header to the buffer
     header.serialize(buf);
 }
 
+size_t RnpPacket::serialize(uint8_t *buf, size_t capacity) {
+    // Fall back on the vector overload for packets which do not implement
+    // in place serialization
+    std::vector<uint8_t> serialized;
+    serialize(serialized);
+
+    // Check the packet fits
+    if (capacity < serialized.size()) {
+        return 0;
+    }
+
+    // Copy the serialized packet to the output buffer
+    std::memcpy(buf, serialized.data(), serialized.size());
+
+    // Return bytes written
+    return serialized.size();
+}
+
 RnpPacketSerialized::~RnpPacketSerialized(){};
 
 RnpPacketSerialized::RnpPacketSerialized(const std::vector<uint8_t> &bytes)
     : RnpPacket(RnpHeader(bytes)), packet(bytes){};
 
-void RnpPacketSerialized::reserializeHeader() {
-    // Declare serialized header bytes buffer
-    std::vector<uint8_t> header_serialized;
+RnpPacketSerialized::RnpPacketSerialized(const RnpBufferView bytes)
+    : RnpPacket(RnpHeader(bytes)), packet(bytes.begin(), bytes.end()){};
+
+RnpPacketSerialized::RnpPacketSerialized() : RnpPacket(RnpHeader()){};
 
-    // Serialize header to the buffer
-    header.serialize(header_serialized);
+RnpDecodeResult<RnpPacketSerialized>
+RnpPacketSerialized::tryDecode(const RnpBufferView bytes) {
+    // Check the bytes contain a header, the only way decoding can fail
+    if (bytes.size() < RnpHeader::size()) {
+        return RnpDecodeError::HEADER_TOO_SHORT;
+    }
+
+    return RnpDecodeResult<RnpPacketSerialized>(std::in_place, bytes);
+}
+
+void RnpPacketSerialized::load(const RnpBufferView bytes) {
+    // Fail if the bytes do not contain a header
+    const RnpDecodeError error = tryLoad(bytes);
+    if (error != RnpDecodeError::NONE) {
+        rnpDecodeFailed(error);
+    }
+}
+
+RnpDecodeError RnpPacketSerialized::tryLoad(const RnpBufferView bytes) {
+    // Decode the header first so the packet is untouched if this fails
+    RnpDecodeResult<RnpHeader> decoded = RnpHeader::tryDecode(bytes);
+    if (!decoded) {
+        return decoded.error();
+    }
+    header = *decoded;
 
+    // Copy the packet bytes into the existing buffer
+    packet.assign(bytes.begin(), bytes.end());
+
+    return RnpDecodeError::NONE;
+}
+
+void RnpPacketSerialized::reserializeHeader() {
     // Replace original header in the serialized packet
-    std::memcpy(packet.data(), header_serialized.data(),
-                header_serialized.size());
+    header.serialize(packet.data());
 }
 
-void RnpPacketSerialized::serialize(std::vector<uint8_t> &buf) {
-    // Re-serialize header
-    reserializeHeader();
+void RnpPacketSerialized::patchForwardingHeader() {
+    // Check the offsets are within the header at compile time
+    static_assert(RnpHeader::sourceOffset() < RnpHeader::size());
+    static_assert(RnpHeader::hopsOffset() < RnpHeader::size());
+
+    // Overwrite the single byte fields in place
+    packet[RnpHeader::sourceOffset()] = header.source;
+    packet[RnpHeader::hopsOffset()] = header.hops;
+}
 
+void RnpPacketSerialized::serialize(std::vector<uint8_t> &buf) {
     // Extract buffer size
     size_t bufsize = buf.size();
 
@@ -57,7 +124,23 @@ void RnpPacketSerialized::serialize(std::vector<uint8_t> &buf) {
     buf.resize(bufsize + packet.size());
 
     // Copy the packet to the buffer
-    std::memcpy(buf.data() + bufsize, packet.data(), packet.size());
+    serialize(buf.data() + bufsize, packet.size());
+};
+
+size_t RnpPacketSerialized::serialize(uint8_t *buf, size_t capacity) {
+    // Check the packet fits
+    if (capacity < packet.size()) {
+        return 0;
+    }
+
+    // Re-serialize header
+    reserializeHeader();
+
+    // Copy the packet to the buffer
+    std::memcpy(buf, packet.data(), packet.size());
+
+    // Return bytes written
+    return packet.size();
 };
 
 std::vector<uint8_t> RnpPacketSerialized::getBody() const {
@@ -65,6 +148,11 @@ std::vector<uint8_t> RnpPacketSerialized::getBody() const {
     return std::vector<uint8_t>{packet.begin() + header.size(), packet.end()};
 }
 
+RnpBufferView RnpPacketSerialized::getBodyView() const {
+    // Return a view of the packet body
+    return RnpBufferView(packet).subview(header.size());
+}
+
 size_t RnpPacketSerialized::getBodySize() const {
     // Return the the size of the body, without returning a negative number
     return (packet.size() < header.size()) ? (0)
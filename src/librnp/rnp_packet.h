@@ -1,7 +1,11 @@
 #pragma once
 
+#include "rnp_bufferview.h"
+#include "rnp_endian.h"
 #include "rnp_header.h"
 
+#include <cstring>
+#include <string>
 #include <vector>
 
 // Forward declaration
@@ -45,8 +49,8 @@ public:
     /**
      * @brief Deserialization Constructor with size checking
      *
-     * Throws std::runtime_error if the expected size does not match the size
-     * decoded in the header or in the provided buffer
+     * Fails with rnpDecodeFailed() if the expected size does not match the
+     * size decoded in the header or in the provided buffer
      *
      * @author Kiran de Silva
      *
@@ -56,6 +60,20 @@ public:
      */
     RnpPacket(const RnpPacketSerialized &serializedPacket, size_t size);
 
+    /**
+     * @brief Check the header and body of a serialized packet match the
+     * expected body size
+     *
+     * Used by the tryDecode() factories to validate a packet once before
+     * decoding it, so the fields are then read without further checks.
+     *
+     * @param[in] serializedPacket Serialized packet
+     * @param[in] size Expected size of packet body
+     * @return RnpDecodeError NONE if the sizes match
+     */
+    static RnpDecodeError checkSize(const RnpPacketSerialized &serializedPacket,
+                                    size_t size);
+
     /**
      * @brief Serialize packet to provided buffer
      *
@@ -68,6 +86,23 @@ public:
      */
     virtual void serialize(std::vector<uint8_t> &buf);
 
+    /**
+     * @brief Serialize packet in place into a caller owned buffer (e.g. a
+     * DMA or socket buffer)
+     *
+     * Derived packets override this to write the header and body straight
+     * into buf. The default implementation falls back on the vector overload
+     * so packets which only implement that still serialize correctly.
+     *
+     * @note Derived classes overriding either overload should also override
+     * (or bring into scope) the other, otherwise it is hidden.
+     *
+     * @param[out] buf Output buffer
+     * @param[in] capacity Size of the output buffer
+     * @return size_t Number of bytes written, 0 if the packet does not fit
+     */
+    virtual size_t serialize(uint8_t *buf, size_t capacity);
+
     /// @brief Header
     RnpHeader header;
 };
@@ -93,6 +128,50 @@ public:
      */
     RnpPacketSerialized(const std::vector<uint8_t> &bytes);
 
+    /**
+     * @brief Extract header from a view of a serialized byte stream
+     *
+     * @param[in] bytes View of the serialized packet
+     */
+    RnpPacketSerialized(const RnpBufferView bytes);
+
+    /**
+     * @brief Construct an empty serialized packet
+     *
+     * Used by RnpPacketPool to preallocate packets which are later filled
+     * with load()
+     */
+    RnpPacketSerialized();
+
+    /**
+     * @brief Replace the contents of this packet with a new serialized byte
+     * stream, reusing the existing buffer capacity
+     *
+     * Fails with rnpDecodeFailed() if bytes is too small to contain a header
+     *
+     * @param[in] bytes View of the serialized packet
+     */
+    void load(const RnpBufferView bytes);
+
+    /**
+     * @brief Replace the contents of this packet without throwing
+     *
+     * The packet is left untouched if bytes is too small to contain a header.
+     *
+     * @param[in] bytes View of the serialized packet
+     * @return RnpDecodeError NONE if loaded
+     */
+    RnpDecodeError tryLoad(const RnpBufferView bytes);
+
+    /**
+     * @brief Decode a serialized packet without throwing
+     *
+     * @param[in] bytes View of the serialized packet
+     * @return RnpDecodeResult<RnpPacketSerialized> Packet, or HEADER_TOO_SHORT
+     */
+    static RnpDecodeResult<RnpPacketSerialized>
+    tryDecode(const RnpBufferView bytes);
+
     /**
      * @brief Re-serialize header back into packet. Make sure to do this if the
      * header is modified.
@@ -101,6 +180,12 @@ public:
      */
     void reserializeHeader();
 
+    /**
+     * @brief Write the header fields changed when forwarding (source and
+     * hops) into the packet in place, leaving the rest of the bytes untouched
+     */
+    void patchForwardingHeader();
+
     /**
      * @brief Copies the internally stored packet to the output buffer
      *
@@ -112,15 +197,39 @@ public:
      */
     void serialize(std::vector<uint8_t> &buf) override;
 
+    /**
+     * @brief Copies the internally stored packet into a caller owned buffer
+     *
+     * The header is automatically re-serialised
+     *
+     * @param[out] buf Output buffer
+     * @param[in] capacity Size of the output buffer
+     * @return size_t Number of bytes written, 0 if the packet does not fit
+     */
+    size_t serialize(uint8_t *buf, size_t capacity) override;
+
     /**
      * @brief Extract packet body from packet
      *
+     * Returns a copy of the body. Prefer getBodyView() when decoding, as it
+     * does not allocate.
+     *
      * @author Kiran de Silva
      *
      * @return std::vector<uint8_t> Serialized packet body
      */
     std::vector<uint8_t> getBody() const;
 
+    /**
+     * @brief Get a view of the packet body without copying it
+     *
+     * The view points into the internally stored packet, so it is invalidated
+     * by anything that modifies or destroys this object.
+     *
+     * @return RnpBufferView View of the serialized packet body
+     */
+    RnpBufferView getBodyView() const;
+
     /**
      * @brief Get the size of the packet Body
      *
@@ -173,7 +282,36 @@ public:
     BasicDataPacket(const RnpPacketSerialized &packet)
         : RnpPacket(packet, size()) {
         // Copy packet into data
-        std::memcpy(&data, packet.getBody().data(), size());
+        RnpEndian::load(data, packet.getBodyView().data());
+    };
+
+    /**
+     * @brief Deserialize a packet already validated by checkSize()
+     *
+     * @param[in] packet packet
+     */
+    BasicDataPacket(const RnpPacketSerialized &packet, RnpPrevalidated)
+        : RnpPacket(packet.header) {
+        // Copy packet into data
+        RnpEndian::load(data, packet.getBodyView().data());
+    };
+
+    /**
+     * @brief Deserialize a packet without throwing
+     *
+     * @param[in] packet packet
+     * @return RnpDecodeResult<BasicDataPacket> Packet, or the size mismatch
+     */
+    static RnpDecodeResult<BasicDataPacket>
+    tryDecode(const RnpPacketSerialized &packet) {
+        // Validate the sizes once up front
+        const RnpDecodeError error = checkSize(packet, size());
+        if (error != RnpDecodeError::NONE) {
+            return error;
+        }
+
+        return RnpDecodeResult<BasicDataPacket>(std::in_place, packet,
+                                                rnpPrevalidated);
     };
 
     /**
@@ -184,17 +322,37 @@ public:
      * @param[out] buf Output buffer
      */
     void serialize(std::vector<uint8_t> &buf) override {
-        // Serialize buffer
-        RnpPacket::serialize(buf);
-
         // Extract buffer size
         size_t bufsize = buf.size();
 
-        // Resize buffer to include packet
-        buf.resize(bufsize + size());
+        // Resize buffer to include header and packet
+        buf.resize(bufsize + header.size() + size());
+
+        // Serialize packet onto the end of the buffer
+        serialize(buf.data() + bufsize, header.size() + size());
+    };
+
+    /**
+     * @brief Serialize packet in place into a caller owned buffer
+     *
+     * @param[out] buf Output buffer
+     * @param[in] capacity Size of the output buffer
+     * @return size_t Number of bytes written, 0 if the packet does not fit
+     */
+    size_t serialize(uint8_t *buf, size_t capacity) override {
+        // Check the packet fits
+        if (capacity < header.size() + size()) {
+            return 0;
+        }
+
+        // Serialize header
+        const size_t headersize = header.serialize(buf);
+
+        // Copy packet after the header, in wire byte order
+        RnpEndian::store(buf + headersize, data);
 
-        // Copy packet to the end of the buffer
-        std::memcpy(buf.data() + bufsize, &data, size());
+        // Return bytes written
+        return headersize + size();
     };
 
     /// @brief Packet data
@@ -250,9 +408,32 @@ public:
      */
     MessagePacket_Base(const RnpPacketSerialized &packetData)
         : RnpPacket(packetData.header) {
+        // Get a view of the packet body
+        const RnpBufferView body = packetData.getBodyView();
+
         // Assign message from packet data
-        _msg.assign(packetData.packet.begin() + header.size(),
-                    packetData.packet.end());
+        _msg.assign(body.begin(), body.end());
+    };
+
+    /**
+     * @brief Deserialize a message packet without throwing
+     *
+     * Messages have no fixed size, so only the header length is checked
+     * against the received body.
+     *
+     * @param[in] packetData Serialized packet data
+     * @return RnpDecodeResult<MessagePacket_Base> Packet, or the size mismatch
+     */
+    static RnpDecodeResult<MessagePacket_Base>
+    tryDecode(const RnpPacketSerialized &packetData) {
+        // Check the header length matches the received body
+        const RnpDecodeError error =
+            checkSize(packetData, packetData.getBodySize());
+        if (error != RnpDecodeError::NONE) {
+            return error;
+        }
+
+        return RnpDecodeResult<MessagePacket_Base>(std::in_place, packetData);
     };
 
     /**
@@ -263,17 +444,37 @@ public:
      * @param[out] buf Output buffer
      */
     void serialize(std::vector<uint8_t> &buf) override {
-        // Serialize buffer
-        RnpPacket::serialize(buf);
-
         // Extract buffer size
         size_t bufsize = buf.size();
 
-        // Resize buffer to include message
-        buf.resize(bufsize + size());
+        // Resize buffer to include header and message
+        buf.resize(bufsize + header.size() + size());
+
+        // Serialize packet onto the end of the buffer
+        serialize(buf.data() + bufsize, header.size() + size());
+    };
+
+    /**
+     * @brief Serialize in place into a caller owned buffer
+     *
+     * @param[out] buf Output buffer
+     * @param[in] capacity Size of the output buffer
+     * @return size_t Number of bytes written, 0 if the packet does not fit
+     */
+    size_t serialize(uint8_t *buf, size_t capacity) override {
+        // Check the packet fits
+        if (capacity < header.size() + size()) {
+            return 0;
+        }
+
+        // Serialize header
+        const size_t headersize = header.serialize(buf);
+
+        // Copy message after the header
+        std::memcpy(buf + headersize, _msg.data(), size());
 
-        // Copy message to the end of the buffer
-        std::memcpy(buf.data() + bufsize, _msg.data(), size());
+        // Return bytes written
+        return headersize + size();
     };
 
     /// @brief Packet message
@@ -1,51 +1,135 @@
 #pragma once
 
+#include <atomic>
+#include <cstdint>
 #include <queue>
 #include <utility>
 
-template<typename ELEMENT_T>
+#include "rnp_mpscringbuffer.h"
+
+template<typename ELEMENT_T, typename QUEUE_T = std::queue<ELEMENT_T>>
 class Rnp_PacketBufferInterface
 {
     public:
 
         /**
          * @brief Construct a new Rnp_PacketBufferInterface object
-         * 
+         *
          * @param underlyingQueue reference to underlying queue
          * @param queueMaxSize maxmiuym allowable queue size, if zero, queue is unbounded
          */
-        Rnp_PacketBufferInterface(std::queue<ELEMENT_T>& underlyingQueue,const size_t queueMaxSize):
-        _underlyingQueue(underlyingQueue),
+        Rnp_PacketBufferInterface(QUEUE_T& underlyingQueue,const size_t queueMaxSize):
+        _underlyingQueue(&underlyingQueue),
+        _underlyingRing(nullptr),
+        _queueMaxSize(queueMaxSize)
+        {};
+
+        /**
+         * @brief Construct a new Rnp_PacketBufferInterface object backed by a lock-free ring buffer.
+         * push() can then be called from multiple threads/cores concurrently while the owner of the
+         * buffer consumes it.
+         *
+         * @param underlyingRing reference to underlying ring buffer
+         * @param queueMaxSize maxmiuym allowable queue size, if zero, the ring capacity is used
+         */
+        Rnp_PacketBufferInterface(Rnp_MPSCRingBuffer<ELEMENT_T>& underlyingRing,const size_t queueMaxSize):
+        _underlyingQueue(nullptr),
+        _underlyingRing(&underlyingRing),
         _queueMaxSize(queueMaxSize)
         {};
 
         /**
          * @brief Push a new element to the packet buffer with perfect forwarding. Returns false on an error.
-         * 
-         * @param arg 
-         * @return true 
-         * @return false 
+         *
+         * @param arg
+         * @return true
+         * @return false
          */
         template<typename T>
         bool push(T&& arg)
         {
             if (_queueMaxSize)
             {
-                if (_underlyingQueue.size() == _queueMaxSize)
+                if (size() >= _queueMaxSize)
                 {
+                    _rejected.fetch_add(1, std::memory_order_relaxed);
                     return false;
                 }
             }
-            _underlyingQueue.push(std::forward<T>(arg));
+
+            if (_underlyingRing != nullptr)
+            {
+                if (!_underlyingRing->push(std::forward<T>(arg)))
+                {
+                    _rejected.fetch_add(1, std::memory_order_relaxed);
+                    return false;
+                }
+                return true;
+            }
+
+            _underlyingQueue->push(std::forward<T>(arg));
+            return true;
+        }
+
+        /**
+         * @brief Pop the oldest element from the packet buffer. Only to be called by the owner of the buffer.
+         *
+         * @param out popped element
+         * @return true
+         * @return false buffer empty
+         */
+        bool pop(ELEMENT_T& out)
+        {
+            if (_underlyingRing != nullptr)
+            {
+                return _underlyingRing->pop(out);
+            }
+
+            if (_underlyingQueue->empty())
+            {
+                return false;
+            }
+            out = std::move(_underlyingQueue->front());
+            _underlyingQueue->pop();
             return true;
         };
 
+        /**
+         * @brief Number of elements in the packet buffer, approximate if backed by a ring buffer which is
+         * being pushed to concurrently.
+         *
+         * @return size_t
+         */
+        size_t size() const
+        {
+            return (_underlyingRing != nullptr) ? _underlyingRing->size() : _underlyingQueue->size();
+        };
+
+        bool empty() const
+        {
+            return size() == 0;
+        };
+
+        /**
+         * @brief Number of elements rejected because the packet buffer was full. Wraps around.
+         *
+         * @return uint32_t
+         */
+        uint32_t rejected() const
+        {
+            return _rejected.load(std::memory_order_relaxed);
+        };
+
 
     private:
-        std::queue<ELEMENT_T>& _underlyingQueue;
+        QUEUE_T* _underlyingQueue;
+
+        Rnp_MPSCRingBuffer<ELEMENT_T>* _underlyingRing;
 
         const size_t _queueMaxSize;
 
+        std::atomic<uint32_t> _rejected{0};
+
 
 
-};
\ No newline at end of file
+};
@@ -0,0 +1,93 @@
+#include "rnp_packetpool.h"
+
+#include <memory>
+#include <variant>
+#include <vector>
+
+#include "rnp_bufferview.h"
+#include "rnp_header.h"
+#include "rnp_packet.h"
+
+void RnpPacketDeleter::operator()(RnpPacketSerialized *packet) const {
+    // Hand pooled packets back to their pool
+    if (pool != nullptr) {
+        pool->release(packet);
+        return;
+    }
+
+    // Otherwise the packet was heap allocated
+    delete packet;
+}
+
+RnpPacketPool::RnpPacketPool(const size_t capacity, const size_t slotSize)
+    : _slots(capacity), _slotSize(slotSize) {
+    // Reserve the free list so releasing never allocates
+    _free.reserve(capacity);
+
+    // Reserve each packet buffer and add it to the free list
+    for (auto &slot : _slots) {
+        slot.packet.reserve(_slotSize);
+        _free.push_back(&slot);
+    }
+}
+
+packetptr_t RnpPacketPool::acquire(const RnpBufferView bytes) {
+    // Reject buffers which cannot contain a header
+    if (bytes.size() < RnpHeader::size()) {
+        return nullptr;
+    }
+
+    // Fall back on the heap if the pool is exhausted
+    if (_free.empty()) {
+        return packetptr_t(new RnpPacketSerialized(bytes));
+    }
+
+    // Take a packet from the free list
+    RnpPacketSerialized *packet = _free.back();
+    _free.pop_back();
+
+    // Copy in the packet bytes and decode the header
+    packet->load(bytes);
+
+    return packetptr_t(packet, RnpPacketDeleter(this));
+}
+
+void RnpPacketPool::reserveSlotSize(const size_t slotSize) {
+    if (slotSize <= _slotSize) {
+        return;
+    }
+
+    _slotSize = slotSize;
+
+    // Packets currently in use are grown when they are released
+    for (auto packet : _free) {
+        packet->packet.reserve(_slotSize);
+    }
+}
+
+packetptr_t RnpPacketPool::allocate(RnpPacketPool *pool,
+                                    const RnpBufferView bytes) {
+    // Use the pool if one is provided
+    if (pool != nullptr) {
+        return pool->acquire(bytes);
+    }
+
+    // Reject buffers which cannot contain a header
+    if (bytes.size() < RnpHeader::size()) {
+        return nullptr;
+    }
+
+    return packetptr_t(new RnpPacketSerialized(bytes));
+}
+
+void RnpPacketPool::release(RnpPacketSerialized *packet) {
+    // Drop any link layer address and the packet bytes, keeping the capacity
+    packet->header.lladdress = RnpLinkAddress();
+    packet->packet.clear();
+
+    // Grow the buffer if the slot size has been increased since it was taken
+    packet->packet.reserve(_slotSize);
+
+    // Return the packet to the free list
+    _free.push_back(packet);
+}
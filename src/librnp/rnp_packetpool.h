@@ -0,0 +1,148 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "rnp_bufferview.h"
+#include "rnp_packet.h"
+
+// Forward declaration
+class RnpPacketPool;
+
+/**
+ * @brief Deleter for pooled packets
+ *
+ * Packets taken from a pool are handed back to the pool on destruction,
+ * packets allocated on the heap are deleted as usual.
+ */
+struct RnpPacketDeleter {
+    /**
+     * @brief Construct a deleter for heap allocated packets
+     */
+    constexpr RnpPacketDeleter() : pool(nullptr){};
+
+    /**
+     * @brief Construct a deleter which returns packets to a pool
+     *
+     * @param[in] packetPool Owning pool
+     */
+    constexpr RnpPacketDeleter(RnpPacketPool *packetPool) : pool(packetPool){};
+
+    /**
+     * @brief Allows std::unique_ptr<RnpPacketSerialized> (i.e from
+     * std::make_unique) to be converted into a packetptr_t
+     */
+    constexpr RnpPacketDeleter(const std::default_delete<RnpPacketSerialized> &)
+        : pool(nullptr){};
+
+    /**
+     * @brief Return the packet to its pool, or delete it if it was heap
+     * allocated
+     *
+     * @param[in] packet Packet
+     */
+    void operator()(RnpPacketSerialized *packet) const;
+
+    /// @brief Owning pool, nullptr if the packet was heap allocated
+    RnpPacketPool *pool;
+};
+
+/// @brief Packet pointer type
+using packetptr_t = std::unique_ptr<RnpPacketSerialized, RnpPacketDeleter>;
+
+/**
+ * @brief Fixed size pool of serialized packets
+ *
+ * All packet objects and their byte buffers are allocated up front, so taking
+ * a packet from the pool and returning it does not touch the heap. Each slot
+ * reserves slotSize bytes, which should cover the largest MTU of the attached
+ * interfaces. A packet larger than the slot grows that slot once, after which
+ * it is reused. If the pool is exhausted, packets fall back on the heap.
+ *
+ * @warning Not thread safe. Packets must be acquired and released from the
+ * same thread as the network manager, and the pool must outlive every packet
+ * taken from it.
+ */
+class RnpPacketPool {
+public:
+    /**
+     * @brief Construct a new packet pool
+     *
+     * @param[in] capacity Number of packets in the pool, if zero all packets
+     * are heap allocated
+     * @param[in] slotSize Number of bytes reserved per packet
+     */
+    RnpPacketPool(const size_t capacity = 0, const size_t slotSize = 256);
+
+    RnpPacketPool(const RnpPacketPool &) = delete;
+    RnpPacketPool &operator=(const RnpPacketPool &) = delete;
+
+    /**
+     * @brief Take a packet from the pool, copying in the serialized bytes and
+     * decoding the header
+     *
+     * @param[in] bytes Serialized packet (header and body)
+     * @return packetptr_t Packet, or nullptr if bytes is too small to contain
+     * a header
+     */
+    packetptr_t acquire(const RnpBufferView bytes);
+
+    /**
+     * @brief Grow the number of bytes reserved per packet, i.e to cover the
+     * MTU of a new interface
+     *
+     * @param[in] slotSize Number of bytes reserved per packet
+     */
+    void reserveSlotSize(const size_t slotSize);
+
+    /**
+     * @brief Get the number of packets in the pool
+     *
+     * @return size_t Pool capacity
+     */
+    size_t capacity() const { return _slots.size(); };
+
+    /**
+     * @brief Get the number of packets currently available
+     *
+     * @return size_t Free packets
+     */
+    size_t available() const { return _free.size(); };
+
+    /**
+     * @brief Get the number of bytes reserved per packet
+     *
+     * @return size_t Slot size
+     */
+    size_t slotSize() const { return _slotSize; };
+
+    /**
+     * @brief Allocate a packet from a pool if one is provided, otherwise from
+     * the heap
+     *
+     * @param[in] pool Pool, may be nullptr
+     * @param[in] bytes Serialized packet (header and body)
+     * @return packetptr_t Packet, or nullptr if bytes is too small to contain
+     * a header
+     */
+    static packetptr_t allocate(RnpPacketPool *pool, const RnpBufferView bytes);
+
+private:
+    friend struct RnpPacketDeleter;
+
+    /**
+     * @brief Return a packet to the pool
+     *
+     * @param[in] packet Packet
+     */
+    void release(RnpPacketSerialized *packet);
+
+    /// @brief Pool storage
+    std::vector<RnpPacketSerialized> _slots;
+
+    /// @brief Free list
+    std::vector<RnpPacketSerialized *> _free;
+
+    /// @brief Bytes reserved per packet
+    size_t _slotSize;
+};
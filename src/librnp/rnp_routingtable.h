@@ -1,12 +1,14 @@
 #pragma once
 
+#include <array>
+#include <bitset>
+#include <cstdint>
 #include <iostream>
 #include <optional>
 #include <sstream>
 #include <string>
-#include <utility>
-#include <variant>
-#include <vector>
+
+#include "rnp_linkaddress.h"
 
 /**
  * @brief Structure for network routes
@@ -21,16 +23,23 @@ struct Route {
     uint8_t metric;
 
     /// @brief Address
-    std::variant<std::monostate, std::string> address;
+    RnpLinkAddress address;
 };
 
 /**
  * @brief Class for a routing table
  *
+ * Routes are stored in a fixed table indexed directly by destination, with a
+ * bitmap marking which destinations have a route, so lookups are a single
+ * index and never copy or allocate.
+ *
  * @author Kiran de Silva
  */
 class RoutingTable {
 public:
+    /// @brief Number of destinations
+    static constexpr size_t maxDestinations = 256;
+
     /**
      * @brief Construct a new Routing Table object
      *
@@ -43,20 +52,27 @@ public:
      *
      * @author Kiran de Silva
      *
-     * @param[in] destinations Route destinations
+     * @param[in] destinations Route destinations (unused, the table always
+     * covers every destination)
      */
-    RoutingTable(int destinations) : _table(destinations){};
+    RoutingTable([[maybe_unused]] int destinations){};
 
     /**
      * @brief Return routing table size
      *
      * @author Kiran de Silva
      *
-     * @return size_t Routing table size
+     * @return size_t One past the highest destination with a route
      */
-    size_t size() {
-        // Return routing table size
-        return _table.size();
+    size_t size() const {
+        // Find the highest destination with a route
+        for (size_t i = maxDestinations; i > 0; i--) {
+            if (_valid.test(i - 1)) {
+                return i;
+            }
+        }
+
+        return 0;
     };
 
     /**
@@ -71,13 +87,20 @@ public:
      * @param[in] entry
      */
     void setRoute(const uint8_t destination, const Route &entry) {
-        // Resize the table if the destination exceeds the table size
-        if (destination >= _table.size()) {
-            _table.resize(destination + 1);
-        }
-
         // Set route for the given destination
-        _table.at(destination) = {true, entry};
+        _table[destination] = entry;
+        _valid.set(destination);
+    };
+
+    /**
+     * @brief Find the route for a given destination
+     *
+     * @param[in] destination Destination
+     * @return const Route* Route, nullptr if no route exists. Invalidated
+     * when the route is changed.
+     */
+    const Route *findRoute(const uint8_t destination) const {
+        return _valid.test(destination) ? &_table[destination] : nullptr;
     };
 
     /**
@@ -88,22 +111,17 @@ public:
      * @param[in] destination Destination
      * @return std::optional<Route> Route
      */
-    std::optional<Route> getRoute(const uint8_t destination) {
-        // Return a blank route if the destination is out of bounds
-        if (destination >= _table.size()) {
-            return {};
-        }
+    std::optional<Route> getRoute(const uint8_t destination) const {
+        // Look up the route
+        const Route *route = findRoute(destination);
 
-        // Extract route from routing table
-        std::pair<bool, Route> result = _table.at(destination);
-
-        // Return a blank route if there is no data at index
-        if (!std::get<bool>(result)) {
+        // Return a blank route if there is no route
+        if (route == nullptr) {
             return {};
         }
 
         // Return the route
-        return {std::get<Route>(result)};
+        return {*route};
     };
 
     /**
@@ -114,19 +132,9 @@ public:
      * @param[in] destination Destination
      */
     void deleteRoute(const uint8_t destination) {
-        // Return if no route for the given destination
-        if (destination >= _table.size()) {
-            return;
-        }
-
-        // Fully erase route if it is the last destination
-        if (destination == (_table.size() - 1)) {
-            _table.erase(_table.end());
-            return;
-        }
-
         // Set blank route
-        _table.at(destination) = {false, Route()};
+        _table[destination] = Route();
+        _valid.reset(destination);
     }
 
     /**
@@ -134,7 +142,10 @@ public:
      *
      * @author Kiran de Silva
      */
-    void clearTable() { _table.clear(); }
+    void clearTable() {
+        _table.fill(Route());
+        _valid.reset();
+    }
 
     /**
      * @brief Load routing table from JSON
@@ -157,7 +168,7 @@ public:
      *
      * @return std::stringstream Routing table string stream
      */
-    std::stringstream printTable() {
+    std::stringstream printTable() const {
         // Declare string stream
         std::stringstream sout;
 
@@ -167,42 +178,33 @@ public:
         sout << "|destination|iface|metric|link layer address|"
              << "\n";
 
-        // Iterate through elements
-        for (size_t i = 0; i < _table.size(); i++) {
-            // Extract element
-            auto elem = _table.at(i);
-
+        // Iterate through destinations up to the highest route
+        const size_t tableSize = size();
+        for (size_t i = 0; i < tableSize; i++) {
             // Print element number
             sout << "| " << i;
 
             // Check if there is no route
-            if (!std::get<bool>(elem)) {
+            if (!_valid.test(i)) {
                 // Print no route
                 sout << " | - NO ROUTE - "
                      << "\n";
+                continue;
+            }
+
+            // Extract route
+            const Route &r = _table[i];
+
+            // Output interface and metric
+            sout << " | " << (int)r.iface << " | " << (int)r.metric << " | ";
+
+            // Check for address
+            if (r.address.empty()) {
+                // Output lack of address
+                sout << " - NO ADDRESS - |";
             } else {
-                // Extract route
-                Route r = std::get<Route>(elem);
-
-                // Output interface and metric
-                sout << " | " << (int)r.iface << " | " << (int)r.metric
-                     << " | ";
-
-                // Check for address
-                if (std::holds_alternative<std::monostate>(r.address)) {
-                    // cant visit the variant as
-                    // std::monostate does not have a ostream
-                    // operator defined
-
-                    // Output lack of address
-                    sout << " - NO ADDRESS - |";
-                } else if (std::holds_alternative<std::string>(r.address)) {
-                    // Output address
-                    sout << std::get<std::string>(r.address) << " |";
-                } else {
-                    // Output invalid address
-                    sout << " INVALID ADDRESS TYPE |";
-                }
+                // Output address
+                sout << r.address.str() << " |";
             }
 
             // Output newline
@@ -214,6 +216,9 @@ public:
     }
 
 private:
-    /// @brief Routing table
-    std::vector<std::pair<bool, Route>> _table;
+    /// @brief Routing table, indexed by destination
+    std::array<Route, maxDestinations> _table{};
+
+    /// @brief Destinations with a valid route
+    std::bitset<maxDestinations> _valid;
 };
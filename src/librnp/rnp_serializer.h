@@ -1,13 +1,269 @@
 #pragma once
 
-#include <cassert>
+#include <array>
+#include <charconv>
+#include <cstdio>
 #include <cstring>
+#include <iterator>
+#include <limits>
 #include <string>
 #include <sstream>
 #include <string>
 #include <tuple>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
+#include "rnp_boundedbuffer.h"
+#include "rnp_bufferview.h"
+#include "rnp_endian.h"
+
+/// @brief Force inlining of the serializer's copy paths, so the member
+/// pointers are constants where the layout is analysed
+#if defined(__GNUC__)
+#define RNP_SERIALIZER_INLINE inline __attribute__((always_inline))
+#else
+#define RNP_SERIALIZER_INLINE inline
+#endif
+
+/**
+ * @brief Enumerate for the kind of value held by a serialized element
+ */
+enum class ELEMENT_TYPE : uint8_t {
+    /// @brief Unsigned integer
+    UNSIGNED = 0,
+
+    /// @brief Signed integer
+    SIGNED = 1,
+
+    /// @brief IEEE floating point
+    FLOAT = 2,
+
+    /// @brief Boolean
+    BOOL = 3,
+
+    /// @brief Anything else, i.e enums or arrays
+    OTHER = 4,
+};
+
+/**
+ * @brief Get the element type describing a C++ type
+ *
+ * @tparam T Type
+ * @return constexpr ELEMENT_TYPE Element type
+ */
+template <class T>
+constexpr ELEMENT_TYPE element_type_of() {
+    if constexpr (std::is_same_v<T, bool>) {
+        return ELEMENT_TYPE::BOOL;
+    } else if constexpr (std::is_floating_point_v<T>) {
+        return ELEMENT_TYPE::FLOAT;
+    } else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+        return ELEMENT_TYPE::SIGNED;
+    } else if constexpr (std::is_integral_v<T>) {
+        return ELEMENT_TYPE::UNSIGNED;
+    } else {
+        return ELEMENT_TYPE::OTHER;
+    }
+}
+
+/**
+ * @brief Check if a type describes its members with a getSerializer()
+ *
+ * @tparam T Type
+ */
+template <class T, class = void>
+struct rnp_has_serializer : std::false_type {};
+
+template <class T>
+struct rnp_has_serializer<T, std::void_t<decltype(T::getSerializer())>>
+    : std::true_type {};
+
+/**
+ * @brief Serialization of a single value
+ *
+ * The default copies the value's bytes, so covers arithmetic types, enums
+ * and other trivially copyable types. Arithmetic types and enums are written
+ * little endian, see RnpEndian.
+ *
+ * Each specialization provides:
+ * - fixed: the serialized size does not depend on the value
+ * - raw: the serialized bytes are the bytes of the object, so contiguous raw
+ *   values can be copied together. False for values which are byte swapped
+ * - max_size: the serialized size, or its maximum if not fixed
+ * - size(), serialize() and deserialize(), the latter returning 0 if too few
+ *   bytes are available
+ *
+ * @tparam T Value type
+ */
+template <class T, class = void>
+struct RnpSerialTraits {
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "Type cannot be serialized by copying its bytes");
+
+    static constexpr bool fixed = true;
+
+    static constexpr bool raw = !RnpEndian::swapped<T>;
+
+    static constexpr size_t max_size = sizeof(T);
+
+    static size_t size(const T &) { return sizeof(T); }
+
+    static size_t serialize(const T &value, uint8_t *dst) {
+        RnpEndian::store(dst, value);
+        return sizeof(T);
+    }
+
+    static size_t deserialize(T &value, const uint8_t *src,
+                              const size_t available) {
+        if (available < sizeof(T)) {
+            return 0;
+        }
+        RnpEndian::load(value, src);
+        return sizeof(T);
+    }
+};
+
+/**
+ * @brief Serialization of a std::array, element by element unless the
+ * elements are raw, in which case the array is copied as one block
+ *
+ * Arrays of values which are byte swapped are swapped in one vectorizable
+ * pass rather than value by value.
+ *
+ * @tparam E Element type
+ * @tparam N Number of elements
+ */
+template <class E, size_t N>
+struct RnpSerialTraits<std::array<E, N>> {
+    using element_traits = RnpSerialTraits<E>;
+
+    static constexpr bool fixed = element_traits::fixed;
+
+    static constexpr bool raw =
+        element_traits::raw && (sizeof(std::array<E, N>) == N * sizeof(E));
+
+    static constexpr size_t max_size = N * element_traits::max_size;
+
+    static size_t size(const std::array<E, N> &value) {
+        if constexpr (fixed) {
+            return max_size;
+        } else {
+            size_t total = 0;
+            for (const E &element : value) {
+                total += element_traits::size(element);
+            }
+            return total;
+        }
+    }
+
+    static size_t serialize(const std::array<E, N> &value, uint8_t *dst) {
+        if constexpr (raw) {
+            std::memcpy(dst, value.data(), max_size);
+            return max_size;
+        } else if constexpr (RnpEndian::swapped<E>) {
+            RnpEndian::storeArray(dst, value.data(), N);
+            return max_size;
+        } else {
+            size_t pos = 0;
+            for (const E &element : value) {
+                pos += element_traits::serialize(element, dst + pos);
+            }
+            return pos;
+        }
+    }
+
+    static size_t deserialize(std::array<E, N> &value, const uint8_t *src,
+                              const size_t available) {
+        if constexpr (raw) {
+            if (available < max_size) {
+                return 0;
+            }
+            std::memcpy(value.data(), src, max_size);
+            return max_size;
+        } else if constexpr (RnpEndian::swapped<E>) {
+            if (available < max_size) {
+                return 0;
+            }
+            RnpEndian::loadArray(value.data(), src, N);
+            return max_size;
+        } else {
+            size_t pos = 0;
+            for (E &element : value) {
+                const size_t read = element_traits::deserialize(
+                    element, src + pos, available - pos);
+                if (read == 0) {
+                    return 0;
+                }
+                pos += read;
+            }
+            return pos;
+        }
+    }
+};
+
+/**
+ * @brief Serialization of a bounded buffer, as a length prefix followed by
+ * the bytes
+ *
+ * @tparam N Capacity
+ * @tparam PADDED Always serialize the full capacity
+ */
+template <size_t N, bool PADDED>
+struct RnpSerialTraits<RnpBoundedBuffer<N, PADDED>> {
+    using buffer_t = RnpBoundedBuffer<N, PADDED>;
+
+    static constexpr bool fixed = PADDED;
+
+    static constexpr bool raw = false;
+
+    static constexpr size_t max_size = buffer_t::max_serialized_size();
+
+    static size_t size(const buffer_t &value) {
+        return value.serialized_size();
+    }
+
+    static size_t serialize(const buffer_t &value, uint8_t *dst) {
+        return value.serializeInto(dst);
+    }
+
+    static size_t deserialize(buffer_t &value, const uint8_t *src,
+                              const size_t available) {
+        return value.deserializeFrom(src, available);
+    }
+};
+
+/**
+ * @brief Serialization of a nested struct described by its own
+ * getSerializer(), which must be accessible
+ *
+ * @tparam T Struct type
+ */
+template <class T>
+struct RnpSerialTraits<T, std::enable_if_t<rnp_has_serializer<T>::value>> {
+    using serializer_t = decltype(T::getSerializer());
+
+    static constexpr bool fixed = serializer_t::fixed_size();
+
+    static constexpr bool raw = false;
+
+    static constexpr size_t max_size = serializer_t::member_size();
+
+    static size_t size(const T &value) {
+        return T::getSerializer().serialized_size(value);
+    }
+
+    static size_t serialize(const T &value, uint8_t *dst) {
+        return T::getSerializer().serializeInto(value, dst);
+    }
+
+    static size_t deserialize(T &value, const uint8_t *src,
+                              const size_t available) {
+        return T::getSerializer().deserializeFrom(
+            value, RnpBufferView(src, available));
+    }
+};
+
 /**
  * @brief Class for a Serialisable Element
  *
@@ -20,10 +276,13 @@ template <class C, class T>
 class RnpSerializableElement {
 
 private:
+    /// @brief Serialization of the element's type
+    using traits = RnpSerialTraits<T>;
+
     /**
-     * @brief Element size
+     * @brief Element size, the maximum if the size varies
      */
-    static constexpr size_t size = sizeof(T);
+    static constexpr size_t size = traits::max_size;
 
     /**
      * @brief Member variable pointer
@@ -43,6 +302,83 @@ public:
      */
     constexpr RnpSerializableElement(T C::*elem) : ptr(elem) {} // constructor
 
+    /**
+     * @brief Get the serialized size of the element
+     *
+     * @return constexpr size_t Element size, the maximum if the size varies
+     */
+    static constexpr size_t element_size() { return size; }
+
+    /**
+     * @brief Check if the element always has the same serialized size
+     *
+     * @return true if the size is fixed
+     */
+    static constexpr bool fixed_size() { return traits::fixed; }
+
+    /**
+     * @brief Check if the element is serialized as the bytes of the member,
+     * so it can be copied together with adjacent raw elements
+     *
+     * @return true if the element is raw
+     */
+    static constexpr bool raw() { return traits::raw; }
+
+    /**
+     * @brief Get the address of the member's bytes
+     *
+     * @param[in] owner Reference to the container
+     * @return const uint8_t* Member bytes
+     */
+    RNP_SERIALIZER_INLINE const uint8_t *address(const C &owner) const {
+        return reinterpret_cast<const uint8_t *>(&(owner.*ptr));
+    }
+
+    /**
+     * @brief Get the address of the member's bytes
+     *
+     * @param[in] owner Reference to the container
+     * @return uint8_t* Member bytes
+     */
+    RNP_SERIALIZER_INLINE uint8_t *address(C &owner) const {
+        return reinterpret_cast<uint8_t *>(&(owner.*ptr));
+    }
+
+    /**
+     * @brief Get the serialized size of the element's current value
+     *
+     * @param[in] owner Reference to the container
+     * @return size_t Element size
+     */
+    size_t serialized_size(const C &owner) const {
+        return traits::size(owner.*ptr);
+    }
+
+    /**
+     * @brief Get the kind of value held by the element
+     *
+     * @return constexpr ELEMENT_TYPE Element type
+     */
+    static constexpr ELEMENT_TYPE element_type() {
+        return element_type_of<T>();
+    }
+
+    /**
+     * @brief Check if the element refers to a given member
+     *
+     * @tparam M Member type
+     * @param[in] member Member variable pointer
+     * @return true if the element (de)serializes the member
+     */
+    template <class M>
+    constexpr bool refers_to(M C::*member) const {
+        if constexpr (std::is_same_v<M, T>) {
+            return ptr == member;
+        } else {
+            return false;
+        }
+    }
+
     /**
      * @brief Serialize the element
      *
@@ -58,8 +394,40 @@ public:
         // Resize buffer to add space for the new element
         buffer.resize(bufSize + size);
 
-        // Copy new element onto the end of the buffer
-        std::memcpy(buffer.data() + bufSize, &(owner.*ptr), size);
+        // Copy new element onto the end of the buffer, trimming any unused
+        // space if the size varies
+        buffer.resize(bufSize + serializeInto(owner, buffer.data() + bufSize));
+    }
+
+    /**
+     * @brief Serialize the element directly into a caller owned buffer
+     *
+     * The caller must ensure there is space for at least size bytes at dst.
+     *
+     * @param[in] owner Reference to the container
+     * @param[out] dst Output location
+     * @return size_t Number of bytes written
+     */
+    size_t serializeInto(const C &owner, uint8_t *dst) const {
+        // Write element to the output location, returning its size
+        return traits::serialize(owner.*ptr, dst);
+    }
+
+    /**
+     * @brief Serialize the element, keeping arithmetic values in host byte
+     * order
+     *
+     * @param[in] owner Reference to the container
+     * @param[out] dst Output location
+     * @return size_t Number of bytes written
+     */
+    size_t serializeHostOrder(const C &owner, uint8_t *dst) const {
+        if constexpr (RnpEndian::ordered<T>) {
+            std::memcpy(dst, address(owner), sizeof(T));
+            return sizeof(T);
+        } else {
+            return serializeInto(owner, dst);
+        }
     }
 
     /**
@@ -68,21 +436,21 @@ public:
      * @author Kiran de Silva
      *
      * @param[out] owner Reference to the container
-     * @param[in] buffer Input buffer
+     * @param[in] buffer View of the input buffer
      * @param[in] offset Offset in the buffer for the element
-     * @return size_t Size of the element
+     * @return size_t Size of the element, 0 if the buffer is too short
      */
-    size_t deserialize(C &owner, const std::vector<uint8_t> &buffer,
+    size_t deserialize(C &owner, const RnpBufferView buffer,
                        const size_t offset) const {
-        // Check that the size of the buffer is not exceeded
-        /// @todo Dump packet instead?
-        assert(offset + size <= buffer.size());
-
-        // Copy the element from the buffer
-        std::memcpy(&(owner.*ptr), buffer.data() + offset, size);
+        // Read the element, bounded by the end of the buffer
+        const size_t available =
+            (offset < buffer.size()) ? buffer.size() - offset : 0;
+        const size_t read =
+            traits::deserialize(owner.*ptr, buffer.data() + offset, available);
 
-        // Return the size of the element
-        return size;
+        // Return the size of the element, a short buffer is reported to the
+        // caller rather than asserted on as packets are validated up front
+        return read;
     }
 
     /**
@@ -97,6 +465,70 @@ public:
         buffer << std::to_string(owner.*ptr) << ',';
     }
 
+    /**
+     * @brief Get the maximum number of characters written by stringifyInto,
+     * including the separator
+     *
+     * @return constexpr size_t Maximum number of characters
+     */
+    static constexpr size_t max_string_size() {
+        if constexpr (std::is_floating_point_v<T>) {
+            // Sign, significant digits, point and exponent
+            return std::numeric_limits<T>::max_digits10 + 8 + 1;
+        } else {
+            // Sign and digits, digits10 rounds down
+            return std::numeric_limits<T>::digits10 + 3 + 1;
+        }
+    }
+
+    /**
+     * @brief Convert element to a string directly into a caller owned buffer
+     *
+     * Integers are written as std::to_string would, floating point values in
+     * the shortest form which reads back to the same value. Without floating
+     * point std::to_chars, or with RNP_NO_FLOAT_TO_CHARS defined, floating
+     * point values are written by snprintf with max_digits10 significant
+     * digits, which also reads back to the same value. The caller must ensure
+     * there is space for at least max_string_size() characters at dst.
+     *
+     * @param[in] owner Reference to the container
+     * @param[out] dst Output location
+     * @return size_t Number of characters written
+     */
+    size_t stringifyInto(const C &owner, char *dst) const {
+        const T &value = owner.*ptr;
+
+        // Leave space for the separator
+        char *const last = dst + max_string_size() - 1;
+        char *end = dst;
+
+        if constexpr (std::is_same_v<T, bool>) {
+            *end++ = value ? '1' : '0';
+        } else if constexpr (std::is_floating_point_v<T>) {
+#if defined(__cpp_lib_to_chars) && !defined(RNP_NO_FLOAT_TO_CHARS)
+            end = std::to_chars(dst, last, value).ptr;
+#else
+            // Format through a temporary, as snprintf null terminates
+            char temp[max_string_size() + 1];
+            const int length =
+                std::snprintf(temp, sizeof(temp), "%.*g",
+                              std::numeric_limits<T>::max_digits10,
+                              static_cast<double>(value));
+            std::memcpy(dst, temp, length);
+            end = dst + length;
+            (void)last;
+#endif
+        } else {
+            end = std::to_chars(dst, last, value).ptr;
+        }
+
+        // Separate from the next element
+        *end++ = ',';
+
+        // Return the number of characters written
+        return end - dst;
+    }
+
 };
 
 /**
@@ -110,6 +542,10 @@ public:
 template <class C, class... T> // variadic template
 class RnpSerializer {
 
+public:
+    /// @brief Container type
+    using container_t = C;
+
 private:
     /**
      * @brief Elements for (de)serialization
@@ -125,20 +561,260 @@ private:
      *
      * @tparam I Element iteration
      * @param[out] owner Reference to the container
-     * @param[in] buffer Input buffer
+     * @param[in] buffer View of the input buffer
      * @param[in] pos Element position
+     * @return size_t Position after the last element, 0 if the buffer is too
+     * short
      */
     template <size_t I>
-    void deserialize_impl(C &owner, const std::vector<uint8_t> &buffer,
-                          [[maybe_unused]] const size_t pos) const {
+    size_t deserialize_impl(C &owner, const RnpBufferView buffer,
+                            const size_t pos) const {
         // Check that iteration is within the size of the buffer
         if constexpr (I < sizeof...(T)) {
             // Get the I-th element from the elements tuple and deserialize
             auto element_size =
                 std::get<I>(elements).deserialize(owner, buffer, pos);
 
+            // Stop if the element did not fit
+            if (element_size == 0) {
+                return 0;
+            }
+
             // Recurse by calling the deserialisation of the next element
-            deserialize_impl<I + 1>(owner, buffer, pos + element_size);
+            return deserialize_impl<I + 1>(owner, buffer, pos + element_size);
+        } else {
+            return pos;
+        }
+    }
+
+    /**
+     * @brief Shortest span of consecutive raw elements which is serialized
+     * in runs
+     *
+     * Shorter spans, i.e a packet header, are copied element by element. A
+     * wide load straddling a field written just before, such as the uid set
+     * as a packet is sent, stalls store forwarding for longer than the
+     * separate copies take. Deserialization always copies runs, as its input
+     * is not written just before.
+     */
+    static constexpr size_t minRunSpan = 32;
+
+    /**
+     * @brief Get the total size of the consecutive raw elements around an
+     * element, which bounds the runs it can be part of
+     *
+     * @param[in] index Element index
+     * @return constexpr size_t Span size in bytes, 0 if the element is not raw
+     */
+    static constexpr size_t raw_span(const size_t index) {
+        constexpr std::array<bool, sizeof...(T)> raw{
+            RnpSerialTraits<T>::raw...};
+        constexpr std::array<size_t, sizeof...(T)> sizes = element_sizes();
+
+        if (!raw[index]) {
+            return 0;
+        }
+
+        // Find the start of the span, then sum its sizes
+        size_t first = index;
+        while ((first > 0) && raw[first - 1]) {
+            first--;
+        }
+        size_t span = 0;
+        for (size_t i = first; (i < sizeof...(T)) && raw[i]; i++) {
+            span += sizes[i];
+        }
+        return span;
+    }
+
+    /**
+     * @brief Check if an element is copied as part of a run, decided at
+     * compile time from the element types
+     *
+     * @param[in] index Element index
+     * @return true if the element is raw and its span is long enough
+     */
+    static constexpr bool in_run(const size_t index) {
+        return raw_span(index) >= minRunSpan;
+    }
+
+    /**
+     * @brief Check if a member's bytes directly follow a run in memory
+     *
+     * The member pointers are constants, so with optimisation this folds
+     * away, leaving only the copies of the resulting runs.
+     *
+     * @param[in] runEnd End of the run
+     * @param[in] member Start of the member
+     * @return true if the member extends the run
+     */
+    RNP_SERIALIZER_INLINE static bool adjacent(const uint8_t *runEnd,
+                                               const uint8_t *member) {
+        return runEnd == member;
+    }
+
+    /**
+     * @brief Run of raw members not yet copied
+     *
+     * @tparam PTR Member byte pointer type
+     */
+    template <typename PTR>
+    struct Run {
+        /// @brief Position in the serialized bytes
+        size_t pos;
+        /// @brief Start of the run in the container
+        PTR start;
+        /// @brief Length of the run
+        size_t length;
+    };
+
+    /**
+     * @brief Serialize one element, extending the current run if the member
+     * directly follows it
+     *
+     * @tparam I Element index
+     * @param[in] owner Reference to the container
+     * @param[out] dst Output location
+     * @param[in,out] run Current run
+     */
+    template <size_t I>
+    RNP_SERIALIZER_INLINE void serialize_step(const C &owner, uint8_t *dst,
+                                              Run<const uint8_t *> &run) const {
+        using element_t = std::tuple_element_t<I, decltype(elements)>;
+        const element_t &element = std::get<I>(elements);
+
+        if constexpr (in_run(I)) {
+            const uint8_t *src = element.address(owner);
+
+            // Extend the run if the member directly follows it
+            if (run.length != 0 && adjacent(run.start + run.length, src)) {
+                run.length += element_t::element_size();
+                return;
+            }
+
+            // Otherwise copy the run and start a new one at the member
+            copyRun(dst + run.pos, run.start, run.length);
+            run = {run.pos + run.length, src, element_t::element_size()};
+        } else {
+            // Copy the run, then serialize the element on its own
+            copyRun(dst + run.pos, run.start, run.length);
+            const size_t pos = run.pos + run.length;
+            run = {pos + element.serializeInto(owner, dst + pos), nullptr, 0};
+        }
+    }
+
+    /**
+     * @brief Serialize the elements, copying runs of raw elements which are
+     * adjacent in memory with a single memcpy
+     *
+     * @tparam I Element indices
+     * @param[in] owner Reference to the container
+     * @param[out] dst Output location
+     * @return size_t Number of bytes written
+     */
+    template <size_t... I>
+    RNP_SERIALIZER_INLINE size_t
+    serialize_runs(const C &owner, uint8_t *dst,
+                   std::index_sequence<I...>) const {
+        Run<const uint8_t *> run{0, nullptr, 0};
+        (serialize_step<I>(owner, dst, run), ...);
+
+        // Copy the final run
+        copyRun(dst + run.pos, run.start, run.length);
+        return run.pos + run.length;
+    }
+
+    /**
+     * @brief Deserialize one element of a fixed size serializer, extending
+     * the current run if the member directly follows it
+     *
+     * @tparam I Element index
+     * @param[out] owner Reference to the container
+     * @param[in] src Input bytes
+     * @param[in,out] run Current run
+     */
+    template <size_t I>
+    RNP_SERIALIZER_INLINE void deserialize_step(C &owner, const uint8_t *src,
+                                                Run<uint8_t *> &run) const {
+        using element_t = std::tuple_element_t<I, decltype(elements)>;
+        const element_t &element = std::get<I>(elements);
+
+        if constexpr (element_t::raw()) {
+            uint8_t *member = element.address(owner);
+
+            // Extend the run if the member directly follows it
+            if (run.length != 0 && adjacent(run.start + run.length, member)) {
+                run.length += element_t::element_size();
+                return;
+            }
+
+            // Otherwise copy the run and start a new one at the member
+            copyRun(run.start, src + run.pos, run.length);
+            run = {run.pos + run.length, member, element_t::element_size()};
+        } else {
+            // Copy the run, then deserialize the element on its own
+            copyRun(run.start, src + run.pos, run.length);
+            const size_t pos = run.pos + run.length;
+            element.deserialize(
+                owner, RnpBufferView(src + pos, element_t::element_size()), 0);
+            run = {pos + element_t::element_size(), nullptr, 0};
+        }
+    }
+
+    /**
+     * @brief Deserialize the elements of a fixed size serializer, copying
+     * runs of raw elements which are adjacent in memory with a single memcpy
+     *
+     * The caller must check the buffer holds member_size() bytes.
+     *
+     * @tparam I Element indices
+     * @param[out] owner Reference to the container
+     * @param[in] src Input bytes
+     */
+    template <size_t... I>
+    RNP_SERIALIZER_INLINE void
+    deserialize_runs(C &owner, const uint8_t *src,
+                     std::index_sequence<I...>) const {
+        Run<uint8_t *> run{0, nullptr, 0};
+        (deserialize_step<I>(owner, src, run), ...);
+
+        // Copy the final run
+        copyRun(run.start, src + run.pos, run.length);
+    }
+
+    /**
+     * @brief Deserialize the buffer, checking its size once and copying runs
+     * of adjacent members if every element has a fixed size
+     *
+     * @param[out] owner Reference to the container
+     * @param[in] buffer View of the input buffer
+     * @return size_t Number of bytes read, 0 if the buffer is too short
+     */
+    RNP_SERIALIZER_INLINE size_t
+    deserialize_dispatch(C &owner, const RnpBufferView buffer) const {
+        if constexpr (fixed_size()) {
+            if (buffer.size() >= member_size()) {
+                deserialize_runs(owner, buffer.data(),
+                                 std::index_sequence_for<T...>{});
+                return member_size();
+            }
+        }
+
+        // Fall back to deserializing element by element
+        return deserialize_impl<0>(owner, buffer, 0);
+    }
+
+    /**
+     * @brief Copy a run of bytes
+     *
+     * @param[out] dst Output location
+     * @param[in] src Input location
+     * @param[in] length Number of bytes, may be 0
+     */
+    RNP_SERIALIZER_INLINE static void copyRun(uint8_t *dst, const uint8_t *src,
+                                              const size_t length) {
+        if (length != 0) {
+            std::memcpy(dst, src, length);
         }
     }
 
@@ -158,11 +834,101 @@ public:
      *
      * @author Kiran de Silva
      *
-     * @return constexpr size_t Size of all member elements
+     * @return constexpr size_t Size of all member elements, the maximum if
+     * any element's size varies
      */
     static constexpr size_t member_size() {
         // Return the sum of all member sizes
-        return (0 + ... + sizeof(T));
+        return (0 + ... + RnpSerialTraits<T>::max_size);
+    }
+
+    /**
+     * @brief Check if every element always has the same serialized size
+     *
+     * @return true if member_size() is the exact serialized size
+     */
+    static constexpr bool fixed_size() {
+        return (true && ... && RnpSerialTraits<T>::fixed);
+    }
+
+    /**
+     * @brief Calculate the serialized size of the current member values
+     *
+     * @param[in] owner Reference to the container
+     * @return size_t Serialized size
+     */
+    size_t serialized_size(const C &owner) const {
+        if constexpr (fixed_size()) {
+            return member_size();
+        } else {
+            return std::apply(
+                [&](auto &&...args) {
+                    return (size_t(0) + ... + args.serialized_size(owner));
+                },
+                elements);
+        }
+    }
+
+    /**
+     * @brief Get the number of elements
+     *
+     * @return constexpr size_t Number of elements
+     */
+    static constexpr size_t element_count() { return sizeof...(T); }
+
+    /**
+     * @brief Get the size of each element, in serialization order
+     *
+     * @return constexpr std::array<size_t, element_count()> Element sizes
+     */
+    static constexpr std::array<size_t, sizeof...(T)> element_sizes() {
+        return {RnpSerialTraits<T>::max_size...};
+    }
+
+    /**
+     * @brief Get the kind of value held by each element, in serialization
+     * order
+     *
+     * @return constexpr std::array<ELEMENT_TYPE, element_count()> Element
+     * types
+     */
+    static constexpr std::array<ELEMENT_TYPE, sizeof...(T)> element_types() {
+        return {element_type_of<T>()...};
+    }
+
+    /**
+     * @brief Calculate the offset of a member in the serialized bytes
+     *
+     * Usable in constant expressions, so fields can be read or patched in
+     * serialized bytes without (de)serializing everything else. Only members
+     * up to and including the first element whose size varies (i.e an
+     * unpadded RnpBoundedBuffer) have a fixed offset.
+     *
+     * @tparam M Member type
+     * @param[in] member Member variable pointer
+     * @return constexpr size_t Offset of the member, member_size() if the
+     * member is not serialized or follows an element whose size varies
+     */
+    template <class M>
+    constexpr size_t member_offset(M C::*member) const {
+        // Running offset, whether the member has been reached and whether an
+        // element whose size varies comes before it
+        size_t offset = 0;
+        bool found = false;
+        bool variable = false;
+
+        // Sum the sizes of the elements before the member
+        std::apply(
+            [&](auto &&...args) {
+                (..., (found = found || args.refers_to(member),
+                       offset += found ? 0 : args.element_size(),
+                       variable = variable ||
+                                  (!found && !args.fixed_size())));
+            },
+            elements);
+
+        // Return the offset, if it does not depend on the values
+        return (found && !variable) ? offset : member_size();
     }
 
     /**
@@ -177,18 +943,58 @@ public:
         // Declare buffer for the serialized objects
         std::vector<uint8_t> ret;
 
-        // Allocate memory but do not change the size so we can easily get the
-        // end of buffer in serialize
-        ret.reserve(member_size());
-
-        // Apply serialise to all of the elements
-        std::apply([&](auto &&...args) { (..., args.serialize(owner, ret)); },
-                   elements);
+        // Allocate memory for the largest size, then trim to what was
+        // written
+        ret.resize(member_size());
+        ret.resize(serializeInto(owner, ret.data()));
 
         // Return the serialized bytes
         return ret;
     }
 
+    /**
+     * @brief Serialize the elements directly into a caller owned buffer
+     *
+     * No intermediate buffers are used. Raw members which are adjacent in
+     * memory without padding are copied together if their elements span at
+     * least minRunSpan bytes, on big endian hosts only single byte members
+     * are raw. The caller must ensure there is space for at least
+     * member_size() bytes at dst.
+     *
+     * @param[in] owner Reference to the container
+     * @param[out] dst Output location
+     * @return size_t Number of bytes written
+     */
+    RNP_SERIALIZER_INLINE size_t serializeInto(const C &owner,
+                                               uint8_t *dst) const {
+        // Serialize, starting with an empty run
+        return serialize_runs(owner, dst, std::index_sequence_for<T...>{});
+    }
+
+    /**
+     * @brief Serialize each element to its own output location
+     *
+     * Used to write elements into separate columns rather than one record.
+     * Arithmetic values are kept in host byte order so columns can be read
+     * in place. The caller must ensure there is space for the element at each
+     * location.
+     *
+     * @param[in] owner Reference to the container
+     * @param[out] columns Output location of each element, in serialization
+     * order
+     */
+    void serializeColumns(const C &owner, uint8_t *const *columns) const {
+        // Running element index
+        size_t index = 0;
+
+        // Apply serializeInto to each element with its own location
+        std::apply(
+            [&](auto &&...args) {
+                (..., args.serializeHostOrder(owner, columns[index++]));
+            },
+            elements);
+    }
+
     /**
      * @brief Create string-based csv from member values
      * 
@@ -209,6 +1015,98 @@ public:
         return ss.str(); // return string bytes
     }
 
+    /**
+     * @brief Calculate the maximum length of the csv from stringifyInto
+     *
+     * @return constexpr size_t Maximum number of characters
+     */
+    static constexpr size_t max_string_size() {
+        // Return the sum of all element maximums
+        return (0 + ... + RnpSerializableElement<C, T>::max_string_size());
+    }
+
+    /**
+     * @brief Create csv from member values directly into a caller owned
+     * buffer
+     *
+     * Numbers are formatted with std::to_chars, floating point values in the
+     * shortest form which reads back to the same value rather than the fixed
+     * six decimals of stringify(). Nothing is allocated.
+     *
+     * @param[in] owner Reference to the container
+     * @param[out] buf Output buffer
+     * @param[in] capacity Size of the output buffer
+     * @return size_t Number of characters written, 0 if capacity is less than
+     * max_string_size()
+     */
+    size_t stringifyInto(const C &owner, char *buf,
+                         const size_t capacity) const {
+        // Check the worst case fits
+        if (capacity < max_string_size()) {
+            return 0;
+        }
+
+        // Running write position
+        size_t pos = 0;
+
+        // Apply stringifyInto to all of the elements in order
+        std::apply(
+            [&](auto &&...args) {
+                (..., (pos += args.stringifyInto(owner, buf + pos)));
+            },
+            elements);
+
+        // Return the number of characters written
+        return pos;
+    }
+
+    /**
+     * @brief Append csv from member values to a reusable string
+     *
+     * As stringifyInto(), nothing is allocated once the string has grown to
+     * max_string_size() past its contents.
+     *
+     * @param[in] owner Reference to the container
+     * @param[in,out] out Output string, appended to
+     */
+    void stringify(const C &owner, std::string &out) const {
+        // Make space for the worst case, then trim to what was written
+        const size_t pos = out.size();
+        out.resize(pos + max_string_size());
+        out.resize(pos + stringifyInto(owner, out.data() + pos,
+                                       max_string_size()));
+    }
+
+    /**
+     * @brief Append csv lines for a range of containers to a reusable string
+     *
+     * The string is grown once for the whole range, so the lines are written
+     * into a single block.
+     *
+     * @tparam IT Forward iterator over containers
+     * @param[in] first Start of the range
+     * @param[in] last End of the range
+     * @param[in,out] out Output string, appended to
+     * @param[in] terminator Character ending each line
+     */
+    template <class IT>
+    void stringify_batch(IT first, IT last, std::string &out,
+                         const char terminator = '\n') const {
+        // Make space for the worst case of every line
+        const size_t count = std::distance(first, last);
+        size_t pos = out.size();
+        out.resize(pos + count * (max_string_size() + 1));
+
+        // Write each line after the previous one
+        for (; first != last; ++first) {
+            pos += stringifyInto(*first, out.data() + pos, max_string_size());
+            out[pos++] = terminator;
+        }
+
+        // Trim to what was written
+        out.resize(pos);
+    }
+
     /**
      * @brief Deserialize the elements
      *
@@ -217,8 +1115,51 @@ public:
      * @param[out] owner Reference to container
      * @param[in] buffer Input buffer
      */
-    void deserialize(C &owner, const std::vector<uint8_t> &buffer) const {
+    RNP_SERIALIZER_INLINE void
+    deserialize(C &owner, const std::vector<uint8_t> &buffer) const {
+        // Deserialize the buffer
+        deserialize_dispatch(owner, RnpBufferView(buffer));
+    }
+
+    /**
+     * @brief Deserialize the elements directly from a view of a buffer
+     *
+     * No copy of the buffer is made, so this can be used to decode straight
+     * out of a received packet.
+     *
+     * @param[out] owner Reference to container
+     * @param[in] buffer View of the input buffer
+     */
+    RNP_SERIALIZER_INLINE void deserialize(C &owner,
+                                           const RnpBufferView buffer) const {
+        // Deserialize the buffer
+        deserialize_dispatch(owner, buffer);
+    }
+
+    /**
+     * @brief Deserialize the elements from a raw pointer and length
+     *
+     * @param[out] owner Reference to container
+     * @param[in] data Pointer to the input bytes
+     * @param[in] len Number of input bytes
+     */
+    RNP_SERIALIZER_INLINE void deserialize(C &owner, const uint8_t *data,
+                                           const size_t len) const {
+        // Deserialize the buffer
+        deserialize_dispatch(owner, RnpBufferView(data, len));
+    }
+
+    /**
+     * @brief Deserialize the elements from the start of a buffer, which may
+     * hold more data afterwards
+     *
+     * @param[out] owner Reference to container
+     * @param[in] buffer View of the input buffer
+     * @return size_t Number of bytes read, 0 if the buffer is too short
+     */
+    RNP_SERIALIZER_INLINE size_t
+    deserializeFrom(C &owner, const RnpBufferView buffer) const {
         // Deserialize the buffer
-        deserialize_impl<0>(owner, buffer, 0);
+        return deserialize_dispatch(owner, buffer);
     }
 };
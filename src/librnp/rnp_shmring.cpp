@@ -0,0 +1,215 @@
+#include "rnp_shmring.h"
+
+#if defined(__linux__)
+
+#include <climits>
+
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+/// @brief Smallest ring, so any record fits
+static constexpr size_t minCapacity = 1 << 17;
+
+/**
+ * @brief Futex operation on a word in shared memory. The private flag is not
+ * used, as waiters and wakers are in different processes.
+ *
+ * @param[in] word Futex word
+ * @param[in] op FUTEX_WAIT or FUTEX_WAKE
+ * @param[in] value Expected value, or number of waiters to wake
+ * @return long System call result
+ */
+static long futex(std::atomic<uint32_t> &word, const int op,
+                  const uint32_t value) {
+    return ::syscall(SYS_futex, reinterpret_cast<uint32_t *>(&word), op,
+                     value, nullptr, nullptr, 0);
+}
+
+bool RnpShmRing::create(const std::string &name, const size_t capacity) {
+    close();
+
+    // Round the capacity up to a power of two
+    size_t rounded = minCapacity;
+    while (rounded < capacity) {
+        rounded <<= 1;
+    }
+
+    // Replace a ring left behind by a consumer which did not close it
+    ::shm_unlink(name.c_str());
+    const int fd =
+        ::shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR | O_CLOEXEC, 0600);
+    if (fd < 0) {
+        return false;
+    }
+
+    // The object is zero filled, so every record reads as unpublished
+    const size_t size = dataOffset + rounded;
+    if ((::ftruncate(fd, static_cast<off_t>(size)) != 0) || !map(fd, size)) {
+        ::close(fd);
+        ::shm_unlink(name.c_str());
+        return false;
+    }
+    ::close(fd);
+
+    _owner = true;
+    _name = name;
+    _capacity = rounded;
+
+    // Publish the layout last, so producers never see a partial header
+    _header->version = ringVersion;
+    _header->capacity = rounded;
+    _header->magic.store(ringMagic, std::memory_order_release);
+    return true;
+};
+
+bool RnpShmRing::open(const std::string &name) {
+    close();
+
+    const int fd = ::shm_open(name.c_str(), O_RDWR | O_CLOEXEC, 0);
+    if (fd < 0) {
+        return false;
+    }
+
+    // Map the whole object, which may still be being sized by the consumer
+    struct stat status;
+    if ((::fstat(fd, &status) != 0) ||
+        (static_cast<size_t>(status.st_size) <= dataOffset) ||
+        !map(fd, static_cast<size_t>(status.st_size))) {
+        ::close(fd);
+        return false;
+    }
+    ::close(fd);
+
+    // Check the ring is initialised and matches the mapping
+    if ((_header->magic.load(std::memory_order_acquire) != ringMagic) ||
+        (_header->version != ringVersion) ||
+        (dataOffset + _header->capacity != _mapSize) ||
+        closed()) {
+        close();
+        return false;
+    }
+
+    _name = name;
+    _capacity = _header->capacity;
+    return true;
+};
+
+bool RnpShmRing::map(const int fd, const size_t size) {
+    void *address =
+        ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (address == MAP_FAILED) {
+        return false;
+    }
+
+    _header = static_cast<RingHeader *>(address);
+    _data = static_cast<uint8_t *>(address) + dataOffset;
+    _mapSize = size;
+    return true;
+};
+
+void RnpShmRing::close() {
+    if (_header == nullptr) {
+        return;
+    }
+
+    // Tell producers to reopen, and stop anything waiting on the ring
+    if (_owner) {
+        _header->closed.store(1, std::memory_order_release);
+        wakeAll();
+        ::shm_unlink(_name.c_str());
+    }
+
+    ::munmap(_header, _mapSize);
+    _header = nullptr;
+    _data = nullptr;
+    _capacity = 0;
+    _mapSize = 0;
+    _owner = false;
+    _corrupt = false;
+    _name.clear();
+};
+
+bool RnpShmRing::write(const RnpBufferView sender,
+                       const RnpBufferView payload) {
+    if ((sender.size() > maxSenderLength) ||
+        (payload.size() > maxPayloadLength)) {
+        return false;
+    }
+
+    const uint64_t capacity = _capacity;
+    const uint64_t size =
+        (sizeof(RecordHeader) + sender.size() + payload.size() +
+         recordAlignment - 1) &
+        ~static_cast<uint64_t>(recordAlignment - 1);
+
+    // Reserve the record, with padding in front of it if it would cross the
+    // end of the ring
+    uint64_t position = _header->reserve.load(std::memory_order_relaxed);
+    uint64_t padding;
+    do {
+        const uint64_t toEnd = capacity - (position & (capacity - 1));
+        padding = (toEnd < size) ? toEnd : 0;
+        if (position + padding + size -
+                _header->read.load(std::memory_order_acquire) >
+            capacity) {
+            return false;
+        }
+    } while (!_header->reserve.compare_exchange_weak(
+        position, position + padding + size, std::memory_order_relaxed));
+
+    // Publish the padding
+    if (padding != 0) {
+        recordAt(position)->size.store(
+            static_cast<uint32_t>(padding) | paddingFlag,
+            std::memory_order_release);
+        position += padding;
+    }
+
+    // Copy the record in and publish it
+    RecordHeader *record = recordAt(position);
+    record->payloadLength = static_cast<uint16_t>(payload.size());
+    record->senderLength = static_cast<uint8_t>(sender.size());
+    uint8_t *bytes = reinterpret_cast<uint8_t *>(record + 1);
+    std::memcpy(bytes, sender.data(), sender.size());
+    std::memcpy(bytes + sender.size(), payload.data(), payload.size());
+    record->size.store(static_cast<uint32_t>(size), std::memory_order_release);
+
+    // Wake the consumer if it is idle, only the first producer to see it
+    // idle makes the system call. The fence pairs with idle(), so either the
+    // consumer sees the record or this sees the consumer idle.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if ((_header->sleeping.load(std::memory_order_relaxed) != 0) &&
+        (_header->sleeping.exchange(0, std::memory_order_seq_cst) != 0)) {
+        wakeAll();
+    }
+    return true;
+};
+
+bool RnpShmRing::idle() {
+    // Flag the consumer as idle, then check no record was published before
+    // the flag was seen
+    _header->sleeping.store(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!empty()) {
+        _header->sleeping.store(0, std::memory_order_relaxed);
+        return false;
+    }
+    return true;
+};
+
+void RnpShmRing::waitWake(const uint32_t sequence) {
+    // Returns straight away if the sequence has already changed, and is
+    // retried by the caller after a signal
+    futex(_header->wakeSequence, FUTEX_WAIT, sequence);
+};
+
+void RnpShmRing::wakeAll() {
+    _header->wakeSequence.fetch_add(1, std::memory_order_release);
+    futex(_header->wakeSequence, FUTEX_WAKE, INT_MAX);
+};
+
+#endif
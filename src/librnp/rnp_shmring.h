@@ -0,0 +1,330 @@
+#pragma once
+
+#if defined(__linux__)
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#include "rnp_bufferview.h"
+
+/**
+ * @brief Multi-producer/single-consumer ring of variable length records in
+ * POSIX shared memory (Linux only)
+ *
+ * The consumer creates the ring, and any number of producers in other
+ * processes (or threads) open it by name. Each record holds a short sender
+ * name and a payload. Producers reserve space with a single compare-exchange
+ * of the reserve position, copy the record in and publish it by storing its
+ * size in the record header. The consumer reads published records in place,
+ * so payloads are never copied out of shared memory, and zeroes the space
+ * before handing it back to producers. A record which would cross the end of
+ * the ring is preceded by a padding record, so every record is contiguous.
+ *
+ * An idle consumer may ask to be woken: the next producer to publish a
+ * record then bumps a futex in the shared header and wakes any thread
+ * waiting on it, one system call per idle period rather than per record.
+ *
+ * A producer which dies between reserving and publishing a record stalls
+ * the ring, as the consumer cannot skip an unpublished record. The consumer
+ * checks every record header against the ring before using it, and stops
+ * reading at the first corrupt record, as nothing after it can be trusted.
+ * The ring must then be created again.
+ */
+class RnpShmRing {
+public:
+    /**
+     * @brief Construct a closed ring
+     */
+    RnpShmRing()
+        : _header(nullptr), _data(nullptr), _capacity(0), _mapSize(0),
+          _owner(false), _corrupt(false){};
+
+    RnpShmRing(const RnpShmRing &) = delete;
+    RnpShmRing &operator=(const RnpShmRing &) = delete;
+
+    /**
+     * @brief Destroy the ring object, closing the ring
+     */
+    ~RnpShmRing() { close(); };
+
+    /**
+     * @brief Create a ring as its consumer, replacing any stale ring with the
+     * same name
+     *
+     * @param[in] name Shared memory object name, starting with '/'
+     * @param[in] capacity Ring size in bytes, rounded up to a power of two
+     * @return true Ring created
+     * @return false The shared memory could not be created or mapped
+     */
+    bool create(const std::string &name, const size_t capacity);
+
+    /**
+     * @brief Open an existing ring as a producer
+     *
+     * @param[in] name Shared memory object name, starting with '/'
+     * @return true Ring opened
+     * @return false No ring with this name, or it is not yet initialised
+     */
+    bool open(const std::string &name);
+
+    /**
+     * @brief Unmap the ring. The consumer marks the ring closed, wakes any
+     * waiter and removes its name.
+     */
+    void close();
+
+    /**
+     * @brief Check the ring is mapped
+     */
+    bool isOpen() const { return _header != nullptr; };
+
+    /**
+     * @brief Check if the consumer has closed the ring, so a producer should
+     * open it again
+     */
+    bool closed() const {
+        return _header->closed.load(std::memory_order_acquire) != 0;
+    };
+
+    /**
+     * @brief Write a record, waking the consumer if it is idle
+     *
+     * @param[in] sender Sender name, at most maxSenderLength bytes
+     * @param[in] payload Payload, at most maxPayloadLength bytes
+     * @return true Record written
+     * @return false The ring is full, or the record is too large
+     */
+    bool write(const RnpBufferView sender, const RnpBufferView payload);
+
+    /**
+     * @brief Read the published records in order
+     *
+     * Stops at a corrupt record, leaving it in the ring and marking the ring
+     * corrupt, after which nothing more is read.
+     *
+     * @tparam F Callable taking the sender name and payload as RnpBufferView
+     * and returning false to stop before consuming the record
+     * @param[in] onRecord Called with each record, the views point into
+     * shared memory and are only valid for the duration of the call
+     * @return size_t Number of records consumed
+     */
+    template <typename F>
+    size_t read(F &&onRecord) {
+        if (_corrupt) {
+            return 0;
+        }
+
+        uint64_t position = _header->read.load(std::memory_order_relaxed);
+        size_t count = 0;
+
+        for (;;) {
+            RecordHeader *record = recordAt(position);
+            const uint32_t size = record->size.load(std::memory_order_acquire);
+
+            // Nothing more published
+            if (size == 0) {
+                break;
+            }
+
+            // The record must be aligned and end within the ring, as written
+            // by write()
+            const uint32_t length = size & ~paddingFlag;
+            if ((length == 0) || ((length & (recordAlignment - 1)) != 0) ||
+                (length > _capacity - (position & (_capacity - 1)))) {
+                _corrupt = true;
+                break;
+            }
+
+            // Skip padding at the end of the ring
+            if ((size & paddingFlag) == 0) {
+                // Copy the lengths, so they cannot change once checked
+                const size_t senderLength = record->senderLength;
+                const size_t payloadLength = record->payloadLength;
+                if (sizeof(RecordHeader) + senderLength + payloadLength >
+                    length) {
+                    _corrupt = true;
+                    break;
+                }
+
+                const uint8_t *bytes =
+                    reinterpret_cast<const uint8_t *>(record + 1);
+                if (!onRecord(RnpBufferView(bytes, senderLength),
+                              RnpBufferView(bytes + senderLength,
+                                            payloadLength))) {
+                    break;
+                }
+                count++;
+            }
+
+            // Zero the record, so the space reads as unpublished on the next
+            // lap whatever record header lands on it
+            std::memset(static_cast<void *>(record), 0, length);
+            position += length;
+        }
+
+        // Hand the space back to the producers
+        _header->read.store(position, std::memory_order_release);
+        return count;
+    }
+
+    /**
+     * @brief Check if read() found a corrupt record, so the consumer must
+     * create the ring again
+     */
+    bool corrupt() const { return _corrupt; };
+
+    /**
+     * @brief Check if there are no published records
+     */
+    bool empty() const {
+        return recordAt(_header->read.load(std::memory_order_relaxed))
+                   ->size.load(std::memory_order_acquire) == 0;
+    };
+
+    /**
+     * @brief Ask to be woken by the next record, as the consumer
+     *
+     * @return true The consumer will be woken
+     * @return false Records arrived meanwhile, read them instead
+     */
+    bool idle();
+
+    /**
+     * @brief Get the wake sequence, which changes each time the consumer is
+     * woken
+     */
+    uint32_t wakeSequence() const {
+        return _header->wakeSequence.load(std::memory_order_acquire);
+    };
+
+    /**
+     * @brief Block until the wake sequence differs from a previous value
+     *
+     * @param[in] sequence Previously read wake sequence
+     */
+    void waitWake(const uint32_t sequence);
+
+    /**
+     * @brief Change the wake sequence and wake every waiter, i.e to stop a
+     * waiting thread
+     */
+    void wakeAll();
+
+    /// @brief Largest sender name in bytes
+    static constexpr size_t maxSenderLength = 255;
+
+    /// @brief Largest payload in bytes
+    static constexpr size_t maxPayloadLength = 65535;
+
+private:
+    /// @brief Set in the size of a padding record
+    static constexpr uint32_t paddingFlag = 0x80000000;
+
+    /// @brief Alignment of every record
+    static constexpr uint32_t recordAlignment = 8;
+
+    /// @brief Identifies an initialised ring
+    static constexpr uint32_t ringMagic = 0x524E5052;
+
+    /// @brief Layout version
+    static constexpr uint32_t ringVersion = 1;
+
+    /// @brief Record header, followed by the sender name and payload
+    struct RecordHeader {
+        /// @brief Record size in bytes including the header and alignment,
+        /// 0 until published
+        std::atomic<uint32_t> size;
+
+        /// @brief Payload size in bytes
+        uint16_t payloadLength;
+
+        /// @brief Sender name size in bytes
+        uint8_t senderLength;
+
+        /// @brief Unused
+        uint8_t reserved;
+    };
+
+    /// @brief Shared ring header, followed by the records
+    struct RingHeader {
+        /// @brief ringMagic once initialised
+        std::atomic<uint32_t> magic;
+
+        /// @brief Layout version
+        uint32_t version;
+
+        /// @brief Record space in bytes, a power of two
+        uint64_t capacity;
+
+        /// @brief Set when the consumer closes the ring
+        std::atomic<uint32_t> closed;
+
+        /// @brief Next byte to be reserved by a producer
+        alignas(64) std::atomic<uint64_t> reserve;
+
+        /// @brief Next byte to be read by the consumer
+        alignas(64) std::atomic<uint64_t> read;
+
+        /// @brief Set while the consumer wants to be woken
+        alignas(64) std::atomic<uint32_t> sleeping;
+
+        /// @brief Futex word, changed whenever the consumer is woken
+        std::atomic<uint32_t> wakeSequence;
+    };
+
+    static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t) &&
+                      std::atomic<uint32_t>::is_always_lock_free &&
+                      std::atomic<uint64_t>::is_always_lock_free,
+                  "ring atomics must be address free");
+
+    /// @brief Offset of the records from the start of the mapping
+    static constexpr size_t dataOffset = (sizeof(RingHeader) + 63) & ~63;
+
+    /**
+     * @brief Get the record header at a ring position
+     *
+     * @param[in] position Ring position in bytes
+     * @return RecordHeader* Record header
+     */
+    RecordHeader *recordAt(const uint64_t position) const {
+        return reinterpret_cast<RecordHeader *>(
+            _data + (position & (_capacity - 1)));
+    };
+
+    /**
+     * @brief Map a shared memory object
+     *
+     * @param[in] fd Shared memory file descriptor
+     * @param[in] size Mapping size
+     * @return true Mapped
+     * @return false Mapping failed
+     */
+    bool map(const int fd, const size_t size);
+
+    /// @brief Mapped ring header, nullptr if closed
+    RingHeader *_header;
+
+    /// @brief Mapped records
+    uint8_t *_data;
+
+    /// @brief Record space in bytes, copied from the ring header when mapped
+    /// so a producer cannot move records outside the mapping
+    uint64_t _capacity;
+
+    /// @brief Size of the mapping
+    size_t _mapSize;
+
+    /// @brief The ring was created by this object, as the consumer
+    bool _owner;
+
+    /// @brief read() found a corrupt record
+    bool _corrupt;
+
+    /// @brief Shared memory object name
+    std::string _name;
+};
+
+#endif
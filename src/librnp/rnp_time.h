@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+
+#if defined(ARDUINO)
+#include <Arduino.h>
+#else
+#include <chrono>
+#endif
+
+namespace RnpTime {
+
+    /**
+     * @brief Get a monotonic timestamp in microseconds
+     *
+     * Wraps around, so only differences between timestamps are meaningful.
+     *
+     * @return uint32_t Microseconds
+     */
+    inline uint32_t micros() {
+#if defined(ARDUINO)
+        return ::micros();
+#else
+        return static_cast<uint32_t>(
+            std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now().time_since_epoch())
+                .count());
+#endif
+    }
+
+    /**
+     * @brief Get a monotonic timestamp in milliseconds
+     *
+     * Wraps around, so only differences between timestamps are meaningful.
+     *
+     * @return uint32_t Milliseconds
+     */
+    inline uint32_t millis() {
+#if defined(ARDUINO)
+        return ::millis();
+#else
+        return static_cast<uint32_t>(
+            std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now().time_since_epoch())
+                .count());
+#endif
+    }
+
+} // namespace RnpTime
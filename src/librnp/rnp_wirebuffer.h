@@ -0,0 +1,107 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "rnp_bufferview.h"
+
+/**
+ * @brief Immutable serialized packet, either shared or borrowed
+ *
+ * Holds the wire bytes of a packet so they can be produced once and handed to
+ * interfaces without serializing the packet again.
+ *
+ * A shared wire buffer is reference counted, i.e when broadcasting, and copies
+ * share the same bytes. A borrowed wire buffer refers to bytes owned by
+ * someone else, i.e a packet being forwarded, and is only valid for the
+ * duration of the call it is passed to. An interface which needs the bytes
+ * afterwards (i.e to transmit later) should keep retain() instead.
+ */
+class RnpWireBuffer {
+public:
+    /**
+     * @brief Construct an empty wire buffer
+     */
+    RnpWireBuffer() : _data(nullptr), _size(0){};
+
+    /**
+     * @brief Construct a wire buffer sharing serialized bytes
+     *
+     * @param[in] bytes Serialized packet, must not be modified afterwards
+     */
+    explicit RnpWireBuffer(std::shared_ptr<const std::vector<uint8_t>> bytes)
+        : _bytes(std::move(bytes)),
+          _data((_bytes != nullptr) ? _bytes->data() : nullptr),
+          _size((_bytes != nullptr) ? _bytes->size() : 0){};
+
+    /**
+     * @brief Construct a wire buffer taking ownership of serialized bytes
+     *
+     * @param[in] bytes Serialized packet
+     */
+    explicit RnpWireBuffer(std::vector<uint8_t> &&bytes)
+        : RnpWireBuffer(
+              std::make_shared<const std::vector<uint8_t>>(std::move(bytes))){};
+
+    /**
+     * @brief Construct a wire buffer borrowing serialized bytes
+     *
+     * @param[in] bytes Serialized packet, must outlive the wire buffer
+     */
+    explicit RnpWireBuffer(const RnpBufferView bytes)
+        : _data(bytes.data()), _size(bytes.size()){};
+
+    /**
+     * @brief Get a pointer to the serialized bytes
+     */
+    const uint8_t *data() const { return _data; };
+
+    /**
+     * @brief Get the number of serialized bytes
+     */
+    size_t size() const { return _size; };
+
+    /**
+     * @brief Check if the wire buffer is empty
+     */
+    bool empty() const { return _size == 0; };
+
+    /**
+     * @brief Check if the bytes are borrowed rather than shared
+     */
+    bool borrowed() const { return (_bytes == nullptr) && (_data != nullptr); };
+
+    /**
+     * @brief Get a view of the serialized bytes
+     *
+     * @return RnpBufferView View, valid while the bytes are
+     */
+    RnpBufferView view() const { return RnpBufferView(_data, _size); };
+
+    /**
+     * @brief Get a wire buffer which can be kept beyond the current call
+     *
+     * Shared bytes are shared again, borrowed bytes are copied.
+     *
+     * @return RnpWireBuffer Shared wire buffer
+     */
+    RnpWireBuffer retain() const {
+        if (!borrowed()) {
+            return *this;
+        }
+        return RnpWireBuffer(std::vector<uint8_t>(_data, _data + _size));
+    };
+
+private:
+    /// @brief Shared serialized bytes, nullptr if borrowed
+    std::shared_ptr<const std::vector<uint8_t>> _bytes;
+
+    /// @brief Serialized bytes
+    const uint8_t *_data;
+
+    /// @brief Number of serialized bytes
+    size_t _size;
+};
@@ -0,0 +1,261 @@
+#include "shminterface.h"
+
+#if defined(__linux__)
+
+#include <string_view>
+
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include "rnp_time.h"
+
+ShmInterface::ShmInterface(const uint8_t id, const std::string address,
+                           const std::string name, const size_t capacity,
+                           const size_t mtu)
+    : RnpInterface(id, name), _address(address), _capacity(capacity),
+      _serialized(mtu), _wakeFd(-1), _stopWait(false) {
+    // Set the MTU, which sizes the pooled packets
+    info.MTU = mtu;
+};
+
+ShmInterface::~ShmInterface() {
+    // Stop the wait thread before the ring is unmapped
+    if (_waitThread.joinable()) {
+        _stopWait.store(true, std::memory_order_release);
+        _ring.wakeAll();
+        _waitThread.join();
+    }
+    if (_wakeFd >= 0) {
+        ::close(_wakeFd);
+    }
+
+    // Remove the receive ring
+    _ring.close();
+};
+
+void ShmInterface::setup() {
+    // Do nothing if the ring is already created
+    if (_ring.isOpen()) {
+        return;
+    }
+
+    // The address must fit in a record and be a valid object name
+    if (_address.empty() ||
+        (_address.size() > RnpShmRing::maxSenderLength) ||
+        (_address.find('/') != std::string::npos) ||
+        !_ring.create(ringName(_address), _capacity)) {
+        info.error = true;
+        return;
+    }
+
+    info.state = true;
+    info.error = false;
+};
+
+void ShmInterface::update() {
+    // Return if the ring is not created or no buffer is present
+    if (!_ring.isOpen() || (_packetBuffer == nullptr)) {
+        return;
+    }
+
+    // Clear the wake signal
+    if (_wakeFd >= 0) {
+        uint64_t value;
+        if (::read(_wakeFd, &value, sizeof(value)) == sizeof(value)) {
+            info.wakeups++;
+        }
+    }
+
+    // Create the packets straight from the records in shared memory
+    bool full = false;
+    _ring.read([this, &full](const RnpBufferView sender,
+                             const RnpBufferView payload) {
+        // Create the packet, dumping it if it is too short
+        packetptr_t packet_ptr = createPacket(payload);
+        if (!packet_ptr) {
+            info.rxDropped++;
+            return true;
+        }
+
+        // Update packet source interface and link layer address
+        packet_ptr->header.src_iface = getID();
+        packet_ptr->header.lladdress = senderAddress(sender);
+
+        // Stop reading once the packet buffer is full, leaving the remaining
+        // records in the ring
+        if (!_packetBuffer->push(std::move(packet_ptr))) {
+            full = true;
+            return false;
+        }
+        return true;
+    });
+
+    // Nothing after a corrupt record can be trusted, so start a new ring
+    if (_ring.corrupt()) {
+        resetRing();
+        if (!_ring.isOpen()) {
+            return;
+        }
+    }
+
+    // Ask to be woken by the next record, or come back straight away if
+    // records are left in the ring
+    if ((_wakeFd >= 0) && (full || !_ring.idle())) {
+        signal();
+    }
+};
+
+void ShmInterface::sendPacket(RnpPacket &data) {
+    // Serialize the packet, dumping it if it is larger than the MTU
+    const size_t length =
+        data.serialize(_serialized.data(), _serialized.size());
+    if (length == 0) {
+        info.txDropped++;
+        return;
+    }
+
+    transmit(data.header.lladdress,
+             RnpBufferView(_serialized.data(), length));
+};
+
+void ShmInterface::sendPacket(RnpPacket &data, const RnpWireBuffer &wire) {
+    // Dump packets larger than the MTU
+    if (wire.size() > info.MTU) {
+        info.txDropped++;
+        return;
+    }
+
+    transmit(data.header.lladdress, wire.view());
+};
+
+int ShmInterface::getPollFd() {
+    // Nothing to wait on before setup
+    if (!_ring.isOpen()) {
+        return -1;
+    }
+
+    // Start waiting on the ring the first time an event loop asks
+    if (_wakeFd < 0) {
+        _wakeFd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (_wakeFd < 0) {
+            return -1;
+        }
+        _waitThread =
+            std::thread(&ShmInterface::waitLoop, this, _ring.wakeSequence());
+
+        // Update once, so records already in the ring are read and the
+        // interface goes idle
+        signal();
+    }
+
+    return _wakeFd;
+};
+
+void ShmInterface::transmit(const RnpLinkAddress &address,
+                            const RnpBufferView bytes) {
+    // Send to the default peer if the route has no link layer address
+    RnpShmRing *ring = resolve(address.empty() ? _defaultPeer : address);
+
+    // Dump the packet if the peer cannot be reached or its ring is full
+    if ((ring == nullptr) || !_ring.isOpen() ||
+        !ring->write(RnpBufferView(
+                         reinterpret_cast<const uint8_t *>(_address.data()),
+                         _address.size()),
+                     bytes)) {
+        info.txDropped++;
+    }
+};
+
+RnpShmRing *ShmInterface::resolve(const RnpLinkAddress &address) {
+    // No address to resolve
+    if (address.empty()) {
+        return nullptr;
+    }
+
+    // Use the ring while its consumer keeps it open. Close every ring once
+    // the table is full, so it stays bounded whatever addresses are routed to.
+    auto it = _peers.find(address);
+    if (it == _peers.end()) {
+        if (_peers.size() >= maxPeers) {
+            _peers.clear();
+        }
+        it = _peers.emplace(address, std::make_unique<Peer>()).first;
+    }
+    std::unique_ptr<Peer> &peer = it->second;
+    if (peer->ring.isOpen() && !peer->ring.closed()) {
+        return &peer->ring;
+    }
+
+    // Open the ring, limiting the rate of attempts while the peer is down
+    const uint32_t now = RnpTime::millis();
+    if (peer->attempted &&
+        (static_cast<uint32_t>(now - peer->lastAttempt) < reopenInterval)) {
+        return nullptr;
+    }
+    peer->attempted = true;
+    peer->lastAttempt = now;
+
+    return peer->ring.open(ringName(address.str())) ? &peer->ring : nullptr;
+};
+
+void ShmInterface::resetRing() {
+    info.ringResets++;
+
+    // Stop waiting on the ring before it is unmapped
+    const bool waiting = _waitThread.joinable();
+    if (waiting) {
+        _stopWait.store(true, std::memory_order_release);
+        _ring.wakeAll();
+        _waitThread.join();
+        _stopWait.store(false, std::memory_order_relaxed);
+    }
+
+    // Replace the ring, producers see the old one closed and reopen it
+    if (!_ring.create(ringName(_address), _capacity)) {
+        info.state = false;
+        info.error = true;
+        return;
+    }
+
+    if (waiting) {
+        _waitThread =
+            std::thread(&ShmInterface::waitLoop, this, _ring.wakeSequence());
+    }
+};
+
+RnpLinkAddress ShmInterface::senderAddress(const RnpBufferView sender) {
+    const std::string_view name(reinterpret_cast<const char *>(sender.data()),
+                                sender.size());
+
+    // Intern the address of a new sender. Only the last sender is held here,
+    // and the interned table drops an address with its last reference.
+    if (name != _lastSender) {
+        _lastSender.assign(name);
+        _lastSenderAddress = RnpLinkAddress(name);
+    }
+
+    return _lastSenderAddress;
+};
+
+void ShmInterface::signal() {
+    // A write can only fail if the counter would overflow, in which case the
+    // event loop is already signalled
+    const uint64_t value = 1;
+    (void)!::write(_wakeFd, &value, sizeof(value));
+};
+
+void ShmInterface::waitLoop(uint32_t sequence) {
+    while (!_stopWait.load(std::memory_order_acquire)) {
+        // Wait for a peer, or the ring closing
+        _ring.waitWake(sequence);
+
+        // Signal the event loop if woken
+        const uint32_t current = _ring.wakeSequence();
+        if (current != sequence) {
+            sequence = current;
+            signal();
+        }
+    }
+};
+
+#endif
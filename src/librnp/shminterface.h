@@ -0,0 +1,249 @@
+#pragma once
+
+#if defined(__linux__)
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "rnp_interface.h"
+#include "rnp_linkaddress.h"
+#include "rnp_shmring.h"
+
+/**
+ * @brief Shared Memory Interface Information structure
+ */
+struct ShmInterfaceInfo : public RnpInterfaceInfo {
+    /// @brief Packets dropped on receipt, i.e too short
+    uint32_t rxDropped = 0;
+
+    /// @brief Packets dropped on transmission, i.e too large, without a
+    /// reachable peer or with the peer's ring full
+    uint32_t txDropped = 0;
+
+    /// @brief Number of times the event loop was woken by a peer
+    uint32_t wakeups = 0;
+
+    /// @brief Number of times the receive ring was created again after a
+    /// corrupt record, dropping the records left in it
+    uint32_t ringResets = 0;
+};
+
+/**
+ * @brief Shared memory interface between processes on the same host (Linux
+ * only)
+ *
+ * Each interface receives from its own RnpShmRing, created in setup() as
+ * "/rnp.<address>" under /dev/shm, which any number of other processes write
+ * to. Link layer addresses are the address of the destination interface, and
+ * a packet is sent to the link layer address of its route or to the default
+ * peer if the route has no address (i.e when broadcasting). Received packets
+ * carry the address of the sender, so automatically generated routes reply to
+ * it.
+ *
+ * Received packets are created straight from the record in shared memory, so
+ * with a packet pool no memory is allocated per packet. If a peer corrupts the
+ * ring, it is created again and the peers reopen it. Peers' rings are opened
+ * on the first packet sent to them, and reopened if the peer restarts. At
+ * most maxPeers rings are kept open, all being closed when full.
+ *
+ * When used with RnpEventLoop, getPollFd() starts a thread which waits on the
+ * ring's futex and signals an eventfd, so the loop sleeps until a peer
+ * writes. A peer only makes a wake up system call for the first packet after
+ * the interface goes idle.
+ */
+class ShmInterface : public RnpInterface {
+public:
+    /**
+     * @brief Construct a new Shared Memory Interface object
+     *
+     * @param[in] id Interface identifier
+     * @param[in] address Address peers send to, without '/'
+     * @param[in] name Interface name
+     * @param[in] capacity Receive ring size in bytes
+     * @param[in] mtu Largest packet sent or received, in bytes
+     */
+    ShmInterface(const uint8_t id, const std::string address,
+                 const std::string name = "SHM",
+                 const size_t capacity = 1 << 20, const size_t mtu = 1024);
+
+    ShmInterface(const ShmInterface &) = delete;
+    ShmInterface &operator=(const ShmInterface &) = delete;
+
+    /**
+     * @brief Create the receive ring
+     *
+     * Sets info.state if the ring is ready, otherwise info.error.
+     */
+    void setup() override;
+
+    /**
+     * @brief Push the packets waiting in the receive ring onto the packet
+     * buffer
+     */
+    void update() override;
+
+    /**
+     * @brief Write a packet into the ring of its destination
+     *
+     * @param[in] data Packet
+     */
+    void sendPacket(RnpPacket &data) override;
+
+    /**
+     * @brief Write an already serialized packet into the ring of its
+     * destination
+     *
+     * @param[in] data Packet, for the link layer address
+     * @param[in] wire Serialized packet
+     */
+    void sendPacket(RnpPacket &data, const RnpWireBuffer &wire) override;
+
+    /**
+     * @brief Get an eventfd signalled when peers write to the ring, starting
+     * the thread which waits on the ring the first time it is called
+     *
+     * @return int eventfd, -1 before setup
+     */
+    int getPollFd() override;
+
+    /**
+     * @brief Get Shared Memory Interface information
+     *
+     * @return const RnpInterfaceInfo* Shared Memory Interface information
+     */
+    const RnpInterfaceInfo *getInfo() override {
+        // Return Shared Memory Interface information
+        return &info;
+    };
+
+    /**
+     * @brief Set the peer for packets whose route has no link layer address
+     *
+     * @param[in] address Peer address, empty for none
+     */
+    void setDefaultPeer(const RnpLinkAddress address) {
+        _defaultPeer = address;
+    };
+
+    /**
+     * @brief Destroy the Shared Memory Interface object, stopping the wait
+     * thread and removing the receive ring
+     */
+    ~ShmInterface();
+
+private:
+    /// @brief A peer's ring
+    struct Peer {
+        /// @brief Ring, open once the peer has been reached
+        RnpShmRing ring;
+
+        /// @brief Time of the last attempt to open the ring in milliseconds
+        uint32_t lastAttempt = 0;
+
+        /// @brief The ring has been opened before
+        bool attempted = false;
+    };
+
+    /**
+     * @brief Get the shared memory name of an address
+     *
+     * @param[in] address Interface address
+     * @return std::string Shared memory object name
+     */
+    static std::string ringName(const std::string &address) {
+        return "/rnp." + address;
+    };
+
+    /**
+     * @brief Write serialized bytes to the ring of a link layer address
+     *
+     * @param[in] address Link layer address, the default peer if empty
+     * @param[in] bytes Serialized packet
+     */
+    void transmit(const RnpLinkAddress &address, const RnpBufferView bytes);
+
+    /**
+     * @brief Get the open ring of a peer, opening it if needed
+     *
+     * @param[in] address Peer address
+     * @return RnpShmRing* Ring, nullptr if the peer cannot be reached
+     */
+    RnpShmRing *resolve(const RnpLinkAddress &address);
+
+    /**
+     * @brief Create the receive ring again after a corrupt record, restarting
+     * the wait thread around it
+     */
+    void resetRing();
+
+    /**
+     * @brief Get the interned address of a sender, caching the last sender
+     *
+     * @param[in] sender Sender address
+     * @return RnpLinkAddress Interned address
+     */
+    RnpLinkAddress senderAddress(const RnpBufferView sender);
+
+    /**
+     * @brief Signal the eventfd, so the event loop updates the interface
+     */
+    void signal();
+
+    /**
+     * @brief Wait thread, signalling the eventfd each time the ring's wake
+     * sequence changes
+     *
+     * @param[in] sequence Wake sequence when the thread was started
+     */
+    void waitLoop(uint32_t sequence);
+
+    /// @brief Shared Memory Interface information
+    ShmInterfaceInfo info;
+
+    /// @brief Address peers send to
+    const std::string _address;
+
+    /// @brief Receive ring size in bytes
+    const size_t _capacity;
+
+    /// @brief Receive ring
+    RnpShmRing _ring;
+
+    /// @brief Serialization buffer, reused between packets
+    std::vector<uint8_t> _serialized;
+
+    /// @brief Peer for packets without a link layer address
+    RnpLinkAddress _defaultPeer;
+
+    /// @brief Peers' rings, by interned link layer address
+    std::unordered_map<RnpLinkAddress, std::unique_ptr<Peer>> _peers;
+
+    /// @brief Address of the last sender
+    std::string _lastSender;
+
+    /// @brief Interned address of the last sender
+    RnpLinkAddress _lastSenderAddress;
+
+    /// @brief eventfd signalled by the wait thread, -1 until it is started
+    int _wakeFd;
+
+    /// @brief Set to stop the wait thread
+    std::atomic<bool> _stopWait;
+
+    /// @brief Wait thread
+    std::thread _waitThread;
+
+    /// @brief Time between attempts to open a peer's ring in milliseconds
+    static constexpr uint32_t reopenInterval = 1000;
+
+    /// @brief Most peers' rings kept open, all are closed when full
+    static constexpr size_t maxPeers = 256;
+};
+
+#endif
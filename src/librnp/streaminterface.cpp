@@ -0,0 +1,242 @@
+#include "streaminterface.h"
+
+#if defined(__linux__)
+
+#include <algorithm>
+#include <cerrno>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+/// @brief Size of each read from the stream
+static constexpr size_t readSize = 4096;
+
+StreamInterface::StreamInterface(const uint8_t id, const std::string name,
+                                 const size_t mtu, const size_t maxPending)
+    : RnpInterface(id, name), _fd(-1), _isSocket(false),
+      _maxPending(maxPending), _deframer(mtu), _rxChunk(readSize),
+      _serialized(mtu), _txPendingOffset(0) {
+    // Set the MTU, which sizes the pooled packets
+    info.MTU = mtu;
+};
+
+StreamInterface::~StreamInterface() { detach(); };
+
+void StreamInterface::attach(const int fd) {
+    // Close any previous stream
+    detach();
+
+    // Make the stream non-blocking, so update() and flush() never wait
+    const int flags = ::fcntl(fd, F_GETFL);
+    ::fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+
+    // Sockets are written with sendmsg(), so a closed peer does not raise
+    // SIGPIPE
+    struct stat status;
+    _isSocket = (::fstat(fd, &status) == 0) && S_ISSOCK(status.st_mode);
+
+    _fd = fd;
+    info.state = true;
+};
+
+void StreamInterface::detach() {
+    // Close the stream
+    if (_fd >= 0) {
+        ::close(_fd);
+        _fd = -1;
+    }
+    info.state = false;
+
+    // Drop partial frames in both directions
+    _deframer.reset();
+    _txBuffer.clear();
+    _txPending.clear();
+    _txPendingOffset = 0;
+};
+
+void StreamInterface::streamClosed(const int error) {
+    (void)error;
+    detach();
+};
+
+void StreamInterface::update() {
+    // Accept or reconnect
+    poll();
+
+    // Return if there is no stream or no buffer is present
+    if ((_fd < 0) || (_packetBuffer == nullptr)) {
+        return;
+    }
+
+    // Set if the packet buffer rejects a packet
+    bool full = false;
+
+    // Decode each packet straight from the read buffer
+    auto receive = [this, &full](const RnpBufferView payload) {
+        // Create the packet, dumping it if it is too short
+        packetptr_t packet_ptr = createPacket(payload);
+        if (!packet_ptr) {
+            info.rxDropped++;
+            return;
+        }
+
+        // Update packet source interface
+        packet_ptr->header.src_iface = getID();
+
+        // Push packet on to interface packet buffer
+        if (!_packetBuffer->push(std::move(packet_ptr))) {
+            full = true;
+        }
+    };
+
+    // Read until the stream is drained, or the packet buffer is full so the
+    // peer is held back by the stream's flow control
+    while (!full) {
+        const ssize_t received = ::read(_fd, _rxChunk.data(), _rxChunk.size());
+
+        if (received < 0) {
+            // Retry if interrupted
+            if (errno == EINTR) {
+                continue;
+            }
+
+            // Report errors, other than having nothing to read
+            if ((errno != EAGAIN) && (errno != EWOULDBLOCK)) {
+                streamClosed(errno);
+            }
+            return;
+        }
+
+        // End of stream
+        if (received == 0) {
+            streamClosed(0);
+            return;
+        }
+
+        // Decode the chunk, counting dropped frames
+        const uint32_t errors = _deframer.errors();
+        _deframer.feed(
+            RnpBufferView(_rxChunk.data(), static_cast<size_t>(received)),
+            receive);
+        info.rxDropped += _deframer.errors() - errors;
+
+        // A short read means the stream is drained
+        if (static_cast<size_t>(received) < _rxChunk.size()) {
+            return;
+        }
+    }
+};
+
+void StreamInterface::sendPacket(RnpPacket &data) {
+    // Dump the packet if there is no stream
+    if (_fd < 0) {
+        info.txDropped++;
+        return;
+    }
+
+    // Serialize the packet, dumping it if it is larger than the MTU
+    const size_t length =
+        data.serialize(_serialized.data(), _serialized.size());
+    if (length == 0) {
+        info.txDropped++;
+        return;
+    }
+
+    queue(RnpBufferView(_serialized.data(), length));
+};
+
+void StreamInterface::sendPacket(RnpPacket &data, const RnpWireBuffer &wire) {
+    (void)data;
+
+    // Dump the packet if there is no stream or it is larger than the MTU
+    if ((_fd < 0) || (wire.size() > info.MTU)) {
+        info.txDropped++;
+        return;
+    }
+
+    queue(wire.view());
+};
+
+void StreamInterface::queue(const RnpBufferView bytes) {
+    // Dump the packet if the peer is too far behind
+    const size_t pending = (_txPending.size() - _txPendingOffset) +
+                           _txBuffer.size() +
+                           RnpFraming::maxEncodedSize(bytes.size());
+    if (pending > _maxPending) {
+        info.txDropped++;
+        return;
+    }
+
+    // Frame the packet onto the transmit buffer
+    RnpFraming::encode(bytes, _txBuffer);
+};
+
+void StreamInterface::flush() {
+    // Return if there is no stream
+    if (_fd < 0) {
+        return;
+    }
+
+    // Return if there is nothing to write
+    const size_t pendingSize = _txPending.size() - _txPendingOffset;
+    if ((pendingSize == 0) && _txBuffer.empty()) {
+        return;
+    }
+
+    // Write the leftover bytes and the new frames in one call
+    iovec iov[2] = {{_txPending.data() + _txPendingOffset, pendingSize},
+                    {_txBuffer.data(), _txBuffer.size()}};
+    ssize_t written;
+    do {
+        if (_isSocket) {
+            msghdr message{};
+            message.msg_iov = iov;
+            message.msg_iovlen = 2;
+            written = ::sendmsg(_fd, &message, MSG_NOSIGNAL | MSG_DONTWAIT);
+        } else {
+            written = ::writev(_fd, iov, 2);
+        }
+    } while ((written < 0) && (errno == EINTR));
+
+    if (written < 0) {
+        // Report errors, other than the stream being full
+        if ((errno != EAGAIN) && (errno != EWOULDBLOCK)) {
+            _txBuffer.clear();
+            streamClosed(errno);
+            return;
+        }
+        written = 0;
+    } else {
+        info.txWrites++;
+    }
+
+    // Consume the leftover bytes first
+    size_t remaining = static_cast<size_t>(written);
+    const size_t fromPending = std::min(remaining, pendingSize);
+    _txPendingOffset += fromPending;
+    remaining -= fromPending;
+
+    if (_txPendingOffset == _txPending.size()) {
+        // All leftover bytes were written, keep the unwritten new frames
+        _txPending.clear();
+        _txPendingOffset = 0;
+        if (remaining < _txBuffer.size()) {
+            std::swap(_txPending, _txBuffer);
+            _txPendingOffset = remaining;
+        }
+    } else {
+        // None of the new frames were written, move them behind the leftover
+        _txPending.erase(_txPending.begin(),
+                         _txPending.begin() + _txPendingOffset);
+        _txPendingOffset = 0;
+        _txPending.insert(_txPending.end(), _txBuffer.begin(),
+                          _txBuffer.end());
+    }
+    _txBuffer.clear();
+};
+
+#endif
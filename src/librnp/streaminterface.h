@@ -0,0 +1,189 @@
+#pragma once
+
+#if defined(__linux__)
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "rnp_framing.h"
+#include "rnp_interface.h"
+
+/**
+ * @brief Stream Interface Information structure
+ */
+struct StreamInterfaceInfo : public RnpInterfaceInfo {
+    /// @brief Frames dropped on receipt, i.e corrupted or too large
+    uint32_t rxDropped = 0;
+
+    /// @brief Packets dropped on transmission, i.e too large, disconnected or
+    /// the peer not keeping up
+    uint32_t txDropped = 0;
+
+    /// @brief Number of writes to the stream
+    uint32_t txWrites = 0;
+};
+
+/**
+ * @brief Base class for interfaces over a byte stream file descriptor
+ * (Linux only), i.e TCP sockets and serial ports
+ *
+ * Packets are framed with RnpFraming and decoded incrementally, so the stream
+ * may be read in chunks of any size and resynchronizes after corruption.
+ * Packets sent while routing are framed into a transmit buffer and written
+ * with one writev() when the interface is flushed (sendmsg() for sockets, so
+ * a closed peer does not raise SIGPIPE). Bytes the stream could not take are
+ * kept and gathered in front of the new frames on the next flush.
+ *
+ * Derived classes open the stream and hand it over with attach().
+ */
+class StreamInterface : public RnpInterface {
+public:
+    /**
+     * @brief Construct a new Stream Interface object
+     *
+     * @param[in] id Interface identifier
+     * @param[in] name Interface name
+     * @param[in] mtu Largest packet sent or received, in bytes
+     * @param[in] maxPending Largest number of unwritten bytes held for a slow
+     * peer before packets are dropped
+     */
+    StreamInterface(const uint8_t id, const std::string name,
+                    const size_t mtu = 1024, const size_t maxPending = 65536);
+
+    StreamInterface(const StreamInterface &) = delete;
+    StreamInterface &operator=(const StreamInterface &) = delete;
+
+    /**
+     * @brief Read all available bytes and push decoded packets onto the
+     * packet buffer
+     */
+    void update() override;
+
+    /**
+     * @brief Frame a packet into the transmit buffer
+     *
+     * @param[in] data Packet
+     */
+    void sendPacket(RnpPacket &data) override;
+
+    /**
+     * @brief Frame an already serialized packet into the transmit buffer
+     *
+     * @param[in] data Packet
+     * @param[in] wire Serialized packet
+     */
+    void sendPacket(RnpPacket &data, const RnpWireBuffer &wire) override;
+
+    /**
+     * @brief Write the framed packets to the stream
+     */
+    void flush() override;
+
+    /**
+     * @brief Get the stream, readable when bytes are waiting
+     *
+     * @return int Stream file descriptor, -1 if not attached
+     */
+    int getPollFd() override { return _fd; };
+
+    /**
+     * @brief Poll while there is nothing to wait on, or while bytes are left
+     * over from a partial write, so they are retried without waiting for
+     * the stream to become writable
+     *
+     * @return true No file descriptor or transmission pending
+     * @return false Only needs updating when readable
+     */
+    bool requiresPolling() override {
+        return (getPollFd() < 0) || !_txPending.empty();
+    };
+
+    /**
+     * @brief Get Stream Interface information
+     *
+     * @return const RnpInterfaceInfo* Stream Interface information
+     */
+    const RnpInterfaceInfo *getInfo() override {
+        // Return Stream Interface information
+        return &info;
+    };
+
+    /**
+     * @brief Check if a stream is attached
+     */
+    bool connected() const { return _fd >= 0; };
+
+    /**
+     * @brief Destroy the Stream Interface object, closing the stream
+     */
+    ~StreamInterface();
+
+protected:
+    /**
+     * @brief Start using an open stream, which is made non-blocking. The
+     * interface closes it when done.
+     *
+     * @param[in] fd Stream file descriptor
+     */
+    void attach(const int fd);
+
+    /**
+     * @brief Close the stream, dropping any partial frames
+     */
+    void detach();
+
+    /**
+     * @brief Called at the start of every update, i.e to accept or reconnect
+     */
+    virtual void poll(){};
+
+    /**
+     * @brief Called when the stream reports end of file or an error. The
+     * default implementation detaches the stream.
+     *
+     * @param[in] error errno, 0 for end of file
+     */
+    virtual void streamClosed(const int error);
+
+    /// @brief Stream Interface information
+    StreamInterfaceInfo info;
+
+private:
+    /**
+     * @brief Frame serialized bytes into the transmit buffer
+     *
+     * @param[in] bytes Serialized packet
+     */
+    void queue(const RnpBufferView bytes);
+
+    /// @brief Stream file descriptor, -1 if detached
+    int _fd;
+
+    /// @brief The stream is a socket, written with sendmsg()
+    bool _isSocket;
+
+    /// @brief Largest number of unwritten bytes held
+    const size_t _maxPending;
+
+    /// @brief Incremental frame decoder
+    RnpDeframer _deframer;
+
+    /// @brief Read buffer
+    std::vector<uint8_t> _rxChunk;
+
+    /// @brief Serialization buffer, reused between packets
+    std::vector<uint8_t> _serialized;
+
+    /// @brief Frames queued since the last flush
+    std::vector<uint8_t> _txBuffer;
+
+    /// @brief Bytes left over from a previous flush
+    std::vector<uint8_t> _txPending;
+
+    /// @brief Bytes of _txPending already written
+    size_t _txPendingOffset;
+};
+
+#endif
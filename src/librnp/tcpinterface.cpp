@@ -0,0 +1,163 @@
+#include "tcpinterface.h"
+
+#if defined(__linux__)
+
+#include <cerrno>
+
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "rnp_inetaddress.h"
+#include "rnp_time.h"
+
+/**
+ * @brief Disable Nagle's algorithm, packets are already batched per flush
+ *
+ * @param[in] fd Socket
+ */
+static void setNoDelay(const int fd) {
+    const int enable = 1;
+    ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+}
+
+TcpInterface::TcpInterface(const uint8_t id, const std::string address,
+                           const TCP_MODE mode, const std::string name,
+                           const size_t mtu)
+    : StreamInterface(id, name, mtu), _address(address), _mode(mode),
+      _listenFd(-1), _started(false), _lastConnect(0){};
+
+TcpInterface::~TcpInterface() {
+    // Close the listening socket, the connection is closed by the base class
+    if (_listenFd >= 0) {
+        ::close(_listenFd);
+    }
+};
+
+void TcpInterface::setup() {
+    // Parse the server address
+    sockaddr_in server{};
+    if (!RnpInetAddress::parse(_address, server)) {
+        info.error = true;
+        return;
+    }
+
+    _started = true;
+
+    // Connect straight away as a client
+    if (_mode == TCP_MODE::CLIENT) {
+        connect();
+        return;
+    }
+
+    // Do nothing if already listening
+    if (_listenFd >= 0) {
+        return;
+    }
+
+    // Open a non-blocking listening socket, so poll() never waits for a
+    // client
+    _listenFd =
+        ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (_listenFd < 0) {
+        info.error = true;
+        return;
+    }
+
+    // Allow restarting the server on the same port straight away
+    const int enable = 1;
+    ::setsockopt(_listenFd, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+
+    if ((::bind(_listenFd, reinterpret_cast<const sockaddr *>(&server),
+                sizeof(server)) != 0) ||
+        (::listen(_listenFd, 1) != 0)) {
+        ::close(_listenFd);
+        _listenFd = -1;
+        info.error = true;
+        return;
+    }
+
+    info.error = false;
+};
+
+void TcpInterface::poll() {
+    // Nothing to do while connected or before set up
+    if (connected() || !_started) {
+        return;
+    }
+
+    if (_mode == TCP_MODE::SERVER) {
+        // Accept the next waiting client
+        if (_listenFd < 0) {
+            return;
+        }
+        const int fd = ::accept4(_listenFd, nullptr, nullptr,
+                                 SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd >= 0) {
+            setNoDelay(fd);
+            attach(fd);
+        }
+        return;
+    }
+
+    // Reconnect to the server, limiting the rate of attempts
+    if (static_cast<uint32_t>(RnpTime::millis() - _lastConnect) >=
+        reconnectInterval) {
+        connect();
+    }
+};
+
+void TcpInterface::connect() {
+    _lastConnect = RnpTime::millis();
+
+    sockaddr_in server{};
+    if (!RnpInetAddress::parse(_address, server)) {
+        return;
+    }
+
+    // Start a non-blocking connection, a failure is reported when the
+    // connection is first read
+    const int fd =
+        ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return;
+    }
+    if ((::connect(fd, reinterpret_cast<const sockaddr *>(&server),
+                   sizeof(server)) != 0) &&
+        (errno != EINPROGRESS)) {
+        ::close(fd);
+        return;
+    }
+
+    setNoDelay(fd);
+    attach(fd);
+};
+
+int TcpInterface::getPollFd() {
+    // Wait on the listening socket until a client is accepted
+    if ((_mode == TCP_MODE::SERVER) && !connected()) {
+        return _listenFd;
+    }
+
+    return StreamInterface::getPollFd();
+};
+
+uint16_t TcpInterface::getPort() const {
+    // Return 0 if not listening
+    if (_listenFd < 0) {
+        return 0;
+    }
+
+    // Get the bound address
+    sockaddr_in local{};
+    socklen_t length = sizeof(local);
+    if (::getsockname(_listenFd, reinterpret_cast<sockaddr *>(&local),
+                      &length) != 0) {
+        return 0;
+    }
+
+    return ntohs(local.sin_port);
+};
+
+#endif
@@ -0,0 +1,103 @@
+#pragma once
+
+#if defined(__linux__)
+
+#include <cstdint>
+#include <string>
+
+#include "streaminterface.h"
+
+/**
+ * @brief TCP Interface mode
+ */
+enum class TCP_MODE : uint8_t {
+    /// @brief Connect to a server, reconnecting if the connection is lost
+    CLIENT = 0,
+
+    /// @brief Listen for a client, accepting one connection at a time
+    SERVER = 1,
+};
+
+/**
+ * @brief TCP stream interface (Linux only)
+ *
+ * Carries framed packets over a single TCP connection, see StreamInterface.
+ * A server accepts the next waiting client once the current one disconnects.
+ */
+class TcpInterface : public StreamInterface {
+public:
+    /**
+     * @brief Construct a new TCP Interface object
+     *
+     * @param[in] id Interface identifier
+     * @param[in] address Server "ip:port" to connect to, or to listen on.
+     * Listening on port 0 picks a free port.
+     * @param[in] mode Client or server
+     * @param[in] name Interface name
+     * @param[in] mtu Largest packet sent or received, in bytes
+     */
+    TcpInterface(const uint8_t id, const std::string address,
+                 const TCP_MODE mode, const std::string name = "TCP",
+                 const size_t mtu = 1024);
+
+    /**
+     * @brief Start listening, or connecting to the server
+     *
+     * Sets info.error if the address is malformed or the server cannot
+     * listen.
+     */
+    void setup() override;
+
+    /**
+     * @brief Get the port the server is listening on, i.e after listening
+     * on port 0
+     *
+     * @return uint16_t Local port, 0 if not listening
+     */
+    uint16_t getPort() const;
+
+    /**
+     * @brief Get the connection, or the listening socket while a server is
+     * waiting for a client, as it becomes readable when one connects
+     *
+     * @return int File descriptor, -1 while a client is disconnected
+     */
+    int getPollFd() override;
+
+    /**
+     * @brief Destroy the TCP Interface object, closing the sockets
+     */
+    ~TcpInterface();
+
+protected:
+    /**
+     * @brief Accept a client, or reconnect to the server
+     */
+    void poll() override;
+
+private:
+    /**
+     * @brief Start a non-blocking connection to the server
+     */
+    void connect();
+
+    /// @brief Server address
+    const std::string _address;
+
+    /// @brief Client or server
+    const TCP_MODE _mode;
+
+    /// @brief Listening socket, -1 if not listening
+    int _listenFd;
+
+    /// @brief Set up has been called
+    bool _started;
+
+    /// @brief Time of the last connection attempt in milliseconds
+    uint32_t _lastConnect;
+
+    /// @brief Time between connection attempts in milliseconds
+    static constexpr uint32_t reconnectInterval = 1000;
+};
+
+#endif
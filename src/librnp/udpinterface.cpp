@@ -0,0 +1,317 @@
+#include "udpinterface.h"
+
+#if defined(__linux__)
+
+#include <cerrno>
+#include <cstring>
+#include <string_view>
+
+#include <arpa/inet.h>
+#include <unistd.h>
+
+#include "rnp_inetaddress.h"
+
+UdpInterface::UdpInterface(const uint8_t id, const std::string bindAddress,
+                           const std::string name, const size_t batchSize,
+                           const size_t mtu)
+    : RnpInterface(id, name), _bindAddress(bindAddress),
+      _batchSize((batchSize != 0) ? batchSize : 1), _fd(-1), _txCount(0) {
+    // Set the MTU, which sizes the pooled packets
+    info.MTU = mtu;
+
+    // Allocate the batch buffers up front, they are never resized so the
+    // message descriptors can point into them
+    _rxBuffer.resize(_batchSize * mtu);
+    _rxMessages.resize(_batchSize);
+    _rxIovecs.resize(_batchSize);
+    _rxPeers.resize(_batchSize);
+    _txBuffer.resize(_batchSize * mtu);
+    _txMessages.resize(_batchSize);
+    _txIovecs.resize(_batchSize);
+    _txPeers.resize(_batchSize);
+
+    // Point each message at its slot and peer address
+    for (size_t i = 0; i < _batchSize; i++) {
+        _rxIovecs[i] = {slot(_rxBuffer, i), mtu};
+        _rxMessages[i] = {};
+        _rxMessages[i].msg_hdr.msg_name = &_rxPeers[i];
+        _rxMessages[i].msg_hdr.msg_iov = &_rxIovecs[i];
+        _rxMessages[i].msg_hdr.msg_iovlen = 1;
+
+        _txIovecs[i] = {slot(_txBuffer, i), 0};
+        _txMessages[i] = {};
+        _txMessages[i].msg_hdr.msg_name = &_txPeers[i];
+        _txMessages[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+        _txMessages[i].msg_hdr.msg_iov = &_txIovecs[i];
+        _txMessages[i].msg_hdr.msg_iovlen = 1;
+    }
+};
+
+UdpInterface::~UdpInterface() {
+    // Close the socket
+    if (_fd >= 0) {
+        ::close(_fd);
+    }
+};
+
+void UdpInterface::setup() {
+    // Do nothing if the socket is already open
+    if (_fd >= 0) {
+        return;
+    }
+
+    // Parse the local address
+    sockaddr_in local{};
+    if (!parseAddress(_bindAddress, local)) {
+        info.error = true;
+        return;
+    }
+
+    // Open a non-blocking socket, so update() never waits for datagrams
+    _fd = ::socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (_fd < 0) {
+        info.error = true;
+        return;
+    }
+
+    // Bind to the local address
+    if (::bind(_fd, reinterpret_cast<const sockaddr *>(&local),
+               sizeof(local)) != 0) {
+        ::close(_fd);
+        _fd = -1;
+        info.error = true;
+        return;
+    }
+
+    info.state = true;
+    info.error = false;
+};
+
+void UdpInterface::update() {
+    // Return if the socket is closed or no buffer is present
+    if ((_fd < 0) || (_packetBuffer == nullptr)) {
+        return;
+    }
+
+    // Receive batches until the socket is drained
+    for (;;) {
+        // Reset the fields recvmmsg() overwrites
+        for (size_t i = 0; i < _batchSize; i++) {
+            _rxMessages[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+            _rxMessages[i].msg_hdr.msg_flags = 0;
+        }
+
+        const int received = ::recvmmsg(_fd, _rxMessages.data(), _batchSize,
+                                        MSG_DONTWAIT, nullptr);
+        if (received <= 0) {
+            // Nothing waiting (EAGAIN), or an error to be retried on the
+            // next update
+            return;
+        }
+        info.rxBatches++;
+
+        // Push the batch onto the packet buffer
+        for (size_t i = 0; i < static_cast<size_t>(received); i++) {
+            const mmsghdr &message = _rxMessages[i];
+
+            // Dump datagrams larger than the MTU
+            if (message.msg_hdr.msg_flags & MSG_TRUNC) {
+                info.rxDropped++;
+                continue;
+            }
+
+            // Create the packet, dumping it if it is too short
+            packetptr_t packet_ptr = createPacket(
+                RnpBufferView(slot(_rxBuffer, i), message.msg_len));
+            if (!packet_ptr) {
+                info.rxDropped++;
+                continue;
+            }
+
+            // Update packet source interface and link layer address
+            packet_ptr->header.src_iface = getID();
+            packet_ptr->header.lladdress = senderAddress(_rxPeers[i]);
+
+            // Stop once the packet buffer is full. The rest of the batch has
+            // already been taken off the socket, so it is dropped, and the
+            // rest of the socket is left for the next update.
+            if (!_packetBuffer->push(std::move(packet_ptr))) {
+                info.rxDropped += static_cast<size_t>(received) - i - 1;
+                return;
+            }
+        }
+
+        // A partial batch means the socket is drained
+        if (static_cast<size_t>(received) < _batchSize) {
+            return;
+        }
+    }
+};
+
+void UdpInterface::sendPacket(RnpPacket &data) {
+    // Reserve a transmit slot
+    uint8_t *buf = reserveTx(data.header.lladdress);
+    if (buf == nullptr) {
+        return;
+    }
+
+    // Serialize the packet straight into the slot
+    const size_t length = data.serialize(buf, info.MTU);
+    if (length == 0) {
+        // Dump packets larger than the MTU
+        info.txDropped++;
+        return;
+    }
+
+    commitTx(length);
+};
+
+void UdpInterface::sendPacket(RnpPacket &data, const RnpWireBuffer &wire) {
+    // Dump packets larger than the MTU
+    if (wire.size() > info.MTU) {
+        info.txDropped++;
+        return;
+    }
+
+    // Reserve a transmit slot
+    uint8_t *buf = reserveTx(data.header.lladdress);
+    if (buf == nullptr) {
+        return;
+    }
+
+    // Copy the serialized packet into the slot
+    std::memcpy(buf, wire.data(), wire.size());
+    commitTx(wire.size());
+};
+
+void UdpInterface::flush() {
+    size_t sent = 0;
+
+    // Send the queued packets, sendmmsg() may send fewer than requested
+    while (sent < _txCount) {
+        const int result = ::sendmmsg(_fd, _txMessages.data() + sent,
+                                      _txCount - sent, MSG_DONTWAIT);
+        if (result < 0) {
+            // Retry if interrupted
+            if (errno == EINTR) {
+                continue;
+            }
+
+            // Dump the rest of the batch if the socket is full, otherwise
+            // only the packet which failed
+            const bool full = (errno == EAGAIN) || (errno == EWOULDBLOCK);
+            const size_t dropped = full ? (_txCount - sent) : 1;
+            info.txDropped += dropped;
+            sent += dropped;
+            continue;
+        }
+
+        info.txBatches++;
+        sent += static_cast<size_t>(result);
+    }
+
+    // Empty the queue
+    _txCount = 0;
+};
+
+uint16_t UdpInterface::getPort() const {
+    // Return 0 if the socket is closed
+    if (_fd < 0) {
+        return 0;
+    }
+
+    // Get the bound address
+    sockaddr_in local{};
+    socklen_t length = sizeof(local);
+    if (::getsockname(_fd, reinterpret_cast<sockaddr *>(&local), &length) !=
+        0) {
+        return 0;
+    }
+
+    return ntohs(local.sin_port);
+};
+
+bool UdpInterface::parseAddress(const std::string_view address,
+                                sockaddr_in &sockaddr) {
+    return RnpInetAddress::parse(address, sockaddr);
+};
+
+uint8_t *UdpInterface::reserveTx(const RnpLinkAddress &address) {
+    // Send to the default peer if the route has no link layer address
+    const sockaddr_in *peer =
+        resolve(address.empty() ? _defaultPeer : address);
+
+    // Dump the packet if the socket is closed or there is no valid peer
+    if ((_fd < 0) || (peer == nullptr)) {
+        info.txDropped++;
+        return nullptr;
+    }
+
+    // Make room in the batch
+    if (_txCount == _batchSize) {
+        flush();
+    }
+
+    // Set the destination of the slot
+    _txPeers[_txCount] = *peer;
+    return slot(_txBuffer, _txCount);
+};
+
+void UdpInterface::commitTx(const size_t length) {
+    // Queue the slot
+    _txIovecs[_txCount].iov_len = length;
+    _txCount++;
+};
+
+const sockaddr_in *UdpInterface::resolve(const RnpLinkAddress &address) {
+    // No address to resolve
+    if (address.empty()) {
+        return nullptr;
+    }
+
+    // Parse and cache the address the first time it is seen
+    auto it = _txAddresses.find(address);
+    if (it == _txAddresses.end()) {
+        sockaddr_in peer{};
+        if (!parseAddress(address.str(), peer)) {
+            peer.sin_family = AF_UNSPEC;
+        }
+        // Forget every destination once the cache is full, so it stays
+        // bounded whatever addresses are routed to
+        if (_txAddresses.size() >= maxCachedAddresses) {
+            _txAddresses.clear();
+        }
+        it = _txAddresses.emplace(address, peer).first;
+    }
+
+    return (it->second.sin_family == AF_INET) ? &it->second : nullptr;
+};
+
+RnpLinkAddress UdpInterface::senderAddress(const sockaddr_in &sockaddr) {
+    // Look up the interned address of a known sender
+    const uint64_t key =
+        (static_cast<uint64_t>(sockaddr.sin_addr.s_addr) << 16) |
+        sockaddr.sin_port;
+    const auto it = _rxAddresses.find(key);
+    if (it != _rxAddresses.end()) {
+        return it->second;
+    }
+
+    // Format and intern the address of a new sender
+    const RnpLinkAddress address(RnpInetAddress::format(sockaddr));
+
+    // Cache both directions, so replies to the sender are not parsed. Forget
+    // every sender once a cache is full, so anyone able to reach the socket
+    // cannot grow it without bound.
+    if (_rxAddresses.size() >= maxCachedAddresses) {
+        _rxAddresses.clear();
+    }
+    if (_txAddresses.size() >= maxCachedAddresses) {
+        _txAddresses.clear();
+    }
+    _rxAddresses.emplace(key, address);
+    _txAddresses.emplace(address, sockaddr);
+    return address;
+};
+
+#endif
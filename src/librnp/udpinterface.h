@@ -0,0 +1,250 @@
+#pragma once
+
+#if defined(__linux__)
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#include "rnp_interface.h"
+#include "rnp_linkaddress.h"
+
+/**
+ * @brief UDP Interface Information structure
+ */
+struct UdpInterfaceInfo : public RnpInterfaceInfo {
+    /// @brief Number of recvmmsg() calls which returned packets
+    uint32_t rxBatches = 0;
+
+    /// @brief Number of sendmmsg() calls
+    uint32_t txBatches = 0;
+
+    /// @brief Packets dropped on receipt, i.e truncated, too short or left in
+    /// a batch when the packet buffer filled up
+    uint32_t rxDropped = 0;
+
+    /// @brief Packets dropped on transmission, i.e too large, without a
+    /// valid peer or rejected by the socket
+    uint32_t txDropped = 0;
+};
+
+/**
+ * @brief UDP socket interface (Linux only)
+ *
+ * Every datagram holds a single serialized packet. Datagrams are received in
+ * batches with recvmmsg() into reusable buffers, and each batch is pushed onto
+ * the packet buffer. Packets sent while routing are queued and transmitted in
+ * one sendmmsg() call when the network manager flushes the interface, or
+ * sooner if the batch fills up.
+ *
+ * Link layer addresses are "ip:port" strings (IPv4). A packet is sent to the
+ * link layer address of its route, or to the default peer if the route has no
+ * address (i.e when broadcasting). Received packets carry the address of the
+ * sender, so automatically generated routes reply to it. Addresses are cached
+ * in both directions, so only the first packet to or from a peer parses or
+ * interns its address. Each cache holds at most maxCachedAddresses peers, and
+ * is cleared when full.
+ */
+class UdpInterface : public RnpInterface {
+public:
+    /**
+     * @brief Construct a new UDP Interface object
+     *
+     * @param[in] id Interface identifier
+     * @param[in] bindAddress Local "ip:port" to bind to, port 0 picks a free
+     * port
+     * @param[in] name Interface name
+     * @param[in] batchSize Maximum number of datagrams per system call
+     * @param[in] mtu Largest packet sent or received, in bytes
+     */
+    UdpInterface(const uint8_t id, const std::string bindAddress = "0.0.0.0:0",
+                 const std::string name = "UDP", const size_t batchSize = 32,
+                 const size_t mtu = 1472);
+
+    UdpInterface(const UdpInterface &) = delete;
+    UdpInterface &operator=(const UdpInterface &) = delete;
+
+    /**
+     * @brief Open and bind the socket
+     *
+     * Sets info.state if the socket is ready, otherwise info.error.
+     */
+    void setup() override;
+
+    /**
+     * @brief Receive all waiting datagrams and push them onto the packet
+     * buffer
+     */
+    void update() override;
+
+    /**
+     * @brief Queue a packet for transmission, serializing it into the
+     * transmit batch
+     *
+     * @param[in] data Packet
+     */
+    void sendPacket(RnpPacket &data) override;
+
+    /**
+     * @brief Queue an already serialized packet for transmission
+     *
+     * @param[in] data Packet, for the link layer address
+     * @param[in] wire Serialized packet
+     */
+    void sendPacket(RnpPacket &data, const RnpWireBuffer &wire) override;
+
+    /**
+     * @brief Transmit the queued packets with sendmmsg()
+     */
+    void flush() override;
+
+    /**
+     * @brief Get the socket, readable when datagrams are waiting
+     *
+     * @return int Socket, -1 before setup
+     */
+    int getPollFd() override { return _fd; };
+
+    /**
+     * @brief Get UDP Interface information
+     *
+     * @return const RnpInterfaceInfo* UDP Interface information
+     */
+    const RnpInterfaceInfo *getInfo() override {
+        // Return UDP Interface information
+        return &info;
+    };
+
+    /**
+     * @brief Set the peer for packets whose route has no link layer address
+     *
+     * @param[in] address Peer "ip:port", empty for none
+     */
+    void setDefaultPeer(const RnpLinkAddress address) {
+        _defaultPeer = address;
+    };
+
+    /**
+     * @brief Get the port the socket is bound to, i.e after binding port 0
+     *
+     * @return uint16_t Local port, 0 if the socket is not open
+     */
+    uint16_t getPort() const;
+
+    /**
+     * @brief Parse an "ip:port" IPv4 address
+     *
+     * @param[in] address Address string
+     * @param[out] sockaddr Socket address
+     * @return true Address parsed
+     * @return false Malformed address
+     */
+    static bool parseAddress(const std::string_view address,
+                             sockaddr_in &sockaddr);
+
+    /**
+     * @brief Destroy the UDP Interface object, closing the socket
+     */
+    ~UdpInterface();
+
+private:
+    /// @brief UDP Interface information
+    UdpInterfaceInfo info;
+
+    /// @brief Local address to bind to
+    const std::string _bindAddress;
+
+    /// @brief Maximum number of datagrams per system call
+    const size_t _batchSize;
+
+    /// @brief Socket file descriptor, -1 if closed
+    int _fd;
+
+    /// @brief Peer for packets without a link layer address
+    RnpLinkAddress _defaultPeer;
+
+    /// @brief Receive buffers, one MTU sized slot per datagram
+    std::vector<uint8_t> _rxBuffer;
+
+    /// @brief Receive messages
+    std::vector<mmsghdr> _rxMessages;
+
+    /// @brief Receive buffer descriptors
+    std::vector<iovec> _rxIovecs;
+
+    /// @brief Sender of each received datagram
+    std::vector<sockaddr_in> _rxPeers;
+
+    /// @brief Transmit buffers, one MTU sized slot per queued packet
+    std::vector<uint8_t> _txBuffer;
+
+    /// @brief Transmit messages
+    std::vector<mmsghdr> _txMessages;
+
+    /// @brief Transmit buffer descriptors
+    std::vector<iovec> _txIovecs;
+
+    /// @brief Destination of each queued packet
+    std::vector<sockaddr_in> _txPeers;
+
+    /// @brief Number of queued packets
+    size_t _txCount;
+
+    /// @brief Parsed destinations, by interned link layer address. Malformed
+    /// addresses are cached with the AF_UNSPEC family.
+    std::unordered_map<RnpLinkAddress, sockaddr_in> _txAddresses;
+
+    /// @brief Interned sender addresses, by IPv4 address and port
+    std::unordered_map<uint64_t, RnpLinkAddress> _rxAddresses;
+
+    /// @brief Most addresses held by each cache, which is cleared when full
+    static constexpr size_t maxCachedAddresses = 256;
+
+    /**
+     * @brief Reserve the next transmit slot for a packet
+     *
+     * Flushes the queue first if it is full.
+     *
+     * @param[in] address Link layer address of the packet
+     * @return uint8_t* Slot of mtu bytes, nullptr if the packet is dropped
+     */
+    uint8_t *reserveTx(const RnpLinkAddress &address);
+
+    /**
+     * @brief Queue the reserved transmit slot
+     *
+     * @param[in] length Serialized packet length
+     */
+    void commitTx(const size_t length);
+
+    /**
+     * @brief Look up the socket address of a link layer address
+     *
+     * @param[in] address Link layer address
+     * @return const sockaddr_in* Socket address, nullptr if malformed
+     */
+    const sockaddr_in *resolve(const RnpLinkAddress &address);
+
+    /**
+     * @brief Look up the link layer address of a sender
+     *
+     * @param[in] sockaddr Sender socket address
+     * @return RnpLinkAddress Interned "ip:port" address
+     */
+    RnpLinkAddress senderAddress(const sockaddr_in &sockaddr);
+
+    /**
+     * @brief Get the MTU sized slot of a batch buffer
+     */
+    uint8_t *slot(std::vector<uint8_t> &buffer, const size_t index) {
+        return buffer.data() + (index * info.MTU);
+    };
+};
+
+#endif
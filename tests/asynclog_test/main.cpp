@@ -0,0 +1,84 @@
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include <librnp/rnp_netman_packets.h>
+#include <librnp/rnp_networkmanager.h>
+
+static constexpr uint8_t node = 10;
+static constexpr size_t pings = 20;
+static constexpr size_t queueSize = 4;
+
+/// @brief Time the log output takes per message, standing in for a slow UART
+static constexpr auto outputDelay = std::chrono::milliseconds(10);
+
+int main() {
+    RnpNetworkManager netman(node, NODETYPE::LEAF, true);
+    netman.generateDefaultRoutes();
+
+    // Slow asynchronous log output
+    std::atomic<size_t> delivered{0};
+    netman.setLogCb(
+        [&delivered](const std::string &message) {
+            std::this_thread::sleep_for(outputDelay);
+            delivered++;
+        },
+        true, queueSize);
+
+    // Ping this node over loopback, logging the sent pong and the received
+    // ping for each
+    const auto t0 = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < pings; i++) {
+        PingPacket ping(static_cast<uint32_t>(i));
+        ping.header.source = node;
+        ping.header.destination = node;
+        ping.header.source_service =
+            static_cast<uint8_t>(DEFAULT_SERVICES::NETMAN);
+        netman.sendPacket(ping);
+        netman.update();
+        netman.update();
+    }
+    const auto t1 = std::chrono::steady_clock::now();
+
+    // Stop the asynchronous output, writing out what is still queued
+    netman.setLogCb({});
+
+    const size_t logged = pings * 2;
+    const size_t dropped = netman.getLogDropCount();
+    const double elapsed_ms =
+        std::chrono::duration<double, std::milli>(t1 - t0).count();
+    const double outputTime_ms =
+        std::chrono::duration<double, std::milli>(outputDelay * logged)
+            .count();
+
+    std::cout << "routing: " << elapsed_ms << " ms, synchronous output would "
+              << "take " << outputTime_ms << " ms" << std::endl;
+    std::cout << "logged: " << logged << ", delivered: " << delivered
+              << ", dropped: " << dropped << std::endl;
+
+    bool passed = true;
+
+    // Routing must not wait for the log output
+    if (elapsed_ms >= outputTime_ms / 2) {
+        std::cout << "FAILED: routing stalled by the log output" << std::endl;
+        passed = false;
+    }
+
+    // Every message is either delivered or counted as dropped
+    if (delivered + dropped != logged) {
+        std::cout << "FAILED: messages lost without being counted"
+                  << std::endl;
+        passed = false;
+    }
+
+    // The queue is too small to keep up, so some must have been dropped
+    if (dropped == 0) {
+        std::cout << "FAILED: expected dropped messages" << std::endl;
+        passed = false;
+    }
+
+    std::cout << (passed ? "PASSED" : "FAILED") << std::endl;
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,135 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include <unistd.h>
+
+#include <librnp/rnp_columnarlog.h>
+#include <librnp/rnp_serializer.h>
+
+/**
+ * @brief Telemetry frame, as logged by the flight software
+ */
+class TelemetryFrame {
+public:
+    static constexpr auto getSerializer() {
+        auto ret = RnpSerializer(
+            &TelemetryFrame::timestamp, &TelemetryFrame::pressure,
+            &TelemetryFrame::altitude, &TelemetryFrame::state,
+            &TelemetryFrame::armed, &TelemetryFrame::temperature);
+        return ret;
+    }
+
+    uint64_t timestamp;
+    float pressure;
+    double altitude;
+    uint8_t state;
+    bool armed;
+    int16_t temperature;
+};
+
+static constexpr size_t frameCount = 10000;
+static constexpr uint32_t chunkRows = 1024;
+
+static TelemetryFrame makeFrame(const size_t i) {
+    TelemetryFrame frame;
+    frame.timestamp = 1000000 + i * 10;
+    frame.pressure = 101325.0f - static_cast<float>(i);
+    frame.altitude = static_cast<double>(i) * 0.5;
+    frame.state = static_cast<uint8_t>(i % 7);
+    frame.armed = (i % 2) == 0;
+    frame.temperature = static_cast<int16_t>(static_cast<int>(i % 100) - 50);
+    return frame;
+}
+
+int main() {
+    char path[] = "/tmp/columnarlog_test_XXXXXX";
+    const int fd = mkstemp(path);
+    if (fd < 0) {
+        std::cout << "FAILED: could not create a temporary file" << std::endl;
+        return 1;
+    }
+
+    // Write full chunks and a partial one, which the writer writes out as it
+    // is destroyed, before the file is closed
+    {
+        std::FILE *file = fdopen(fd, "wb");
+        {
+            RnpColumnarLogWriter writer(
+                file, TelemetryFrame::getSerializer(), chunkRows);
+            for (size_t i = 0; i < frameCount; i++) {
+                writer.append(makeFrame(i));
+            }
+        }
+        std::fclose(file);
+    }
+
+    // Simulate a write cut short by appending half a chunk header
+    {
+        std::FILE *file = std::fopen(path, "ab");
+        const uint8_t torn[4] = {0xFF, 0x00, 0x00, 0x00};
+        std::fwrite(torn, 1, sizeof(torn), file);
+        std::fclose(file);
+    }
+
+    bool passed = true;
+    RnpColumnarLogReader reader;
+
+    if (!reader.open(path)) {
+        std::cout << "FAILED: could not open the log" << std::endl;
+        std::remove(path);
+        return 1;
+    }
+
+    std::cout << "columns: " << reader.columnCount()
+              << ", chunks: " << reader.chunkCount()
+              << ", rows: " << reader.rowCount() << std::endl;
+
+    if (reader.columnCount() != 6 || reader.rowCount() != frameCount ||
+        reader.chunkCount() != (frameCount + chunkRows - 1) / chunkRows) {
+        std::cout << "FAILED: unexpected log shape" << std::endl;
+        passed = false;
+    }
+
+    // Check every value read back through the typed column views
+    size_t row = 0;
+    size_t mismatches = 0;
+    for (size_t chunk = 0; chunk < reader.chunkCount(); chunk++) {
+        const auto timestamp = reader.column<uint64_t>(chunk, 0);
+        const auto pressure = reader.column<float>(chunk, 1);
+        const auto altitude = reader.column<double>(chunk, 2);
+        const auto state = reader.column<uint8_t>(chunk, 3);
+        const auto armed = reader.column<bool>(chunk, 4);
+        const auto temperature = reader.column<int16_t>(chunk, 5);
+
+        for (size_t i = 0; i < reader.chunkRows(chunk); i++, row++) {
+            const TelemetryFrame expected = makeFrame(row);
+            mismatches += (timestamp[i] != expected.timestamp) ||
+                          (pressure[i] != expected.pressure) ||
+                          (altitude[i] != expected.altitude) ||
+                          (state[i] != expected.state) ||
+                          (armed[i] != expected.armed) ||
+                          (temperature[i] != expected.temperature);
+        }
+    }
+
+    if (mismatches != 0) {
+        std::cout << "FAILED: " << mismatches << " rows differ" << std::endl;
+        passed = false;
+    }
+
+    // Columns must be read with their own type
+    if (!reader.column<float>(0, 0).empty() ||
+        !reader.column<int64_t>(0, 0).empty()) {
+        std::cout << "FAILED: column read with the wrong type" << std::endl;
+        passed = false;
+    }
+
+    reader.close();
+    std::remove(path);
+
+    std::cout << (passed ? "PASSED" : "FAILED") << std::endl;
+    return passed ? 0 : 1;
+}
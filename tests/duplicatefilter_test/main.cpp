@@ -0,0 +1,231 @@
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <librnp/default_packets/simplecommandpacket.h>
+#include <librnp/rnp_duplicatefilter.h>
+#include <librnp/rnp_interface.h>
+#include <librnp/rnp_networkmanager.h>
+#include "testCheck.h"
+
+/**
+ * @brief Interface linked directly to an interface on another node
+ */
+class LinkInterface : public RnpInterface {
+public:
+    LinkInterface(const uint8_t id, const std::string name = "LinkInterface")
+        : RnpInterface(id, name), peer(nullptr){};
+
+    void setup() override{};
+
+    void update() override{};
+
+    void sendPacket(RnpPacket &data) override {
+        // Serialize packet
+        std::vector<uint8_t> serializedData;
+        data.serialize(serializedData);
+
+        // Deliver to the linked interface
+        sent++;
+        if (peer != nullptr) {
+            peer->receive(serializedData);
+        }
+    };
+
+    const RnpInterfaceInfo *getInfo() override { return &info; };
+
+    void receive(const RnpBufferView bytes) {
+        packetptr_t packet_ptr = createPacket(bytes);
+        if (_packetBuffer == nullptr || packet_ptr == nullptr) {
+            return;
+        }
+        packet_ptr->header.src_iface = getID();
+        _packetBuffer->push(std::move(packet_ptr));
+    };
+
+    /// @brief Interface on the other node
+    LinkInterface *peer;
+
+    /// @brief Number of packets sent over the link
+    size_t sent = 0;
+
+private:
+    RnpInterfaceInfo info;
+};
+
+static constexpr size_t nodeCount = 4;
+static constexpr uint8_t firstNode = 10;
+static constexpr uint8_t testService = 10;
+static constexpr uint8_t maxHops = 8;
+
+static RnpHeader makeHeader(const uint8_t source, const uint16_t uid,
+                            const uint8_t type) {
+    RnpHeader header(testService, type, 0);
+    header.source = source;
+    header.uid = uid;
+    return header;
+}
+
+static bool testFilter() {
+    bool passed = true;
+
+    // Hits and misses on each part of the identifier
+    RnpDuplicateFilter filter(100, 64);
+    passed &= check(!filter.isDuplicate(makeHeader(1, 1, 1), 0),
+                    "first packet is a duplicate");
+    passed &= check(filter.isDuplicate(makeHeader(1, 1, 1), 1),
+                    "repeated packet not a duplicate");
+    passed &= check(!filter.isDuplicate(makeHeader(2, 1, 1), 1) &&
+                        !filter.isDuplicate(makeHeader(1, 2, 1), 1) &&
+                        !filter.isDuplicate(makeHeader(1, 1, 2), 1),
+                    "different packet is a duplicate");
+
+    // Packets without a uid are never duplicates
+    passed &= check(!filter.isDuplicate(makeHeader(1, 0, 1), 1) &&
+                        !filter.isDuplicate(makeHeader(1, 0, 1), 1),
+                    "packet without a uid is a duplicate");
+
+    // Remembered until the whole window has passed
+    passed &= check(filter.isDuplicate(makeHeader(1, 1, 1), 99),
+                    "packet forgotten within the window");
+    passed &= check(!filter.isDuplicate(makeHeader(1, 1, 1), 100),
+                    "packet remembered after the window");
+
+    // Older slices are forgotten as the window moves on, newer ones kept
+    filter.clear();
+    filter.isDuplicate(makeHeader(1, 1, 1), 0);
+    filter.isDuplicate(makeHeader(1, 2, 1), 50);
+    passed &= check(filter.isDuplicate(makeHeader(1, 2, 1), 120) &&
+                        !filter.isDuplicate(makeHeader(1, 1, 1), 120),
+                    "window slices not forgotten in order");
+
+    // A full bucket moves the ring on early, forgetting the oldest bucket
+    // rather than failing to record
+    RnpDuplicateFilter small(1000, 8);
+    const size_t perBucket = 2;
+    for (uint16_t uid = 1; uid <= (perBucket * RnpDuplicateFilter::buckets);
+         uid++) {
+        small.isDuplicate(makeHeader(1, uid, 1), 0);
+    }
+    passed &= check(small.isDuplicate(makeHeader(1, 1, 1), 0),
+                    "packet forgotten before the ring is full");
+    small.isDuplicate(makeHeader(1, 100, 1), 0);
+    passed &= check(small.isDuplicate(makeHeader(1, perBucket + 1, 1), 0) &&
+                        !small.isDuplicate(makeHeader(1, 1, 1), 0),
+                    "full bucket did not rotate early");
+
+    // A disabled filter drops nothing
+    RnpDuplicateFilter disabled;
+    passed &= check(!disabled.isDuplicate(makeHeader(1, 1, 1), 0) &&
+                        !disabled.isDuplicate(makeHeader(1, 1, 1), 0),
+                    "disabled filter found a duplicate");
+
+    return passed;
+}
+
+static bool testBroadcastStorm(const bool filtered) {
+    bool passed = true;
+
+    // Fully connected hubs without routes, so packets are broadcast on every
+    // link and reach each node over several paths
+    std::vector<std::unique_ptr<RnpNetworkManager>> netmans;
+    std::vector<std::unique_ptr<LinkInterface>> links;
+    for (size_t i = 0; i < nodeCount; i++) {
+        netmans.push_back(std::make_unique<RnpNetworkManager>(
+            firstNode + i, NODETYPE::HUB, false));
+        netmans[i]->setNoRouteAction(NOROUTE_ACTION::BROADCAST, {});
+        netmans[i]->setHopLimit(maxHops);
+        if (filtered) {
+            netmans[i]->setDuplicateFilter(1000);
+        }
+    }
+
+    // Interface 2 + j on node i links to node j
+    std::vector<std::vector<LinkInterface *>> ifaces(
+        nodeCount, std::vector<LinkInterface *>(nodeCount + 2, nullptr));
+    for (size_t i = 0; i < nodeCount; i++) {
+        for (size_t j = 0; j < nodeCount; j++) {
+            if (i != j) {
+                links.push_back(
+                    std::make_unique<LinkInterface>(2 + j, "link"));
+                ifaces[i][2 + j] = links.back().get();
+                netmans[i]->addInterface(links.back().get());
+            }
+        }
+    }
+    for (size_t i = 0; i < nodeCount; i++) {
+        for (size_t j = 0; j < nodeCount; j++) {
+            if (i != j) {
+                ifaces[i][2 + j]->peer = ifaces[j][2 + i];
+            }
+        }
+    }
+
+    // Count deliveries on the last node
+    size_t delivered = 0;
+    netmans.back()->registerService(testService,
+                                    [&delivered](packetptr_t) { delivered++; });
+
+    // Send the same packet object twice from the first node
+    SimpleCommandPacket packet(1, 0);
+    packet.header.source = firstNode;
+    packet.header.destination = firstNode + nodeCount - 1;
+    packet.header.source_service = testService;
+    packet.header.destination_service = testService;
+    const size_t sends = 2;
+    for (size_t i = 0; i < sends; i++) {
+        packet.header.hops = 0;
+        netmans.front()->sendPacket(packet);
+        passed &= check(packet.header.uid == 0, "assigned uid left on packet");
+
+        // Run until the storm dies
+        for (size_t update = 0; update < 10 * maxHops; update++) {
+            size_t active = 0;
+            for (auto &netman : netmans) {
+                const RnpUpdateResult result = netman->update();
+                active += result.processed + result.queued;
+            }
+            if (active == 0) {
+                break;
+            }
+        }
+    }
+
+    size_t sent = 0;
+    for (auto &link : links) {
+        sent += link->sent;
+    }
+    size_t duplicates = 0;
+    for (auto &netman : netmans) {
+        duplicates += netman->getDuplicateCount();
+    }
+
+    std::cout << (filtered ? "filtered" : "unfiltered")
+              << " storm, sent over links: " << sent
+              << ", delivered: " << delivered
+              << ", duplicates: " << duplicates << std::endl;
+
+    if (filtered) {
+        // Each node forwards each packet once, on every link but the one it
+        // arrived on, and each send is delivered once
+        const size_t perSend =
+            (nodeCount - 1) + (nodeCount - 2) * (nodeCount - 2);
+        passed &= check(delivered == sends, "resent packet not delivered once");
+        passed &= check(duplicates > 0 && sent <= sends * perSend,
+                        "storm not contained");
+    } else {
+        passed &= check(delivered > sends && duplicates == 0,
+                        "unfiltered storm not amplified");
+    }
+
+    return passed;
+}
+
+int main() {
+    bool passed = testFilter();
+    passed &= testBroadcastStorm(false);
+    passed &= testBroadcastStorm(true);
+
+    std::cout << (passed ? "PASSED" : "FAILED") << std::endl;
+    return passed ? 0 : 1;
+}
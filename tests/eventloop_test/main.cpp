@@ -0,0 +1,132 @@
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include <librnp/default_packets/simplecommandpacket.h>
+#include <librnp/rnp_eventloop.h>
+#include <librnp/rnp_networkmanager.h>
+#include <librnp/rnp_routingtable.h>
+#include <librnp/tcpinterface.h>
+#include <librnp/udpinterface.h>
+#include "testCheck.h"
+
+static constexpr uint8_t nodeA = 10;
+static constexpr uint8_t nodeB = 11;
+static constexpr uint8_t linkID = 2;
+static constexpr uint8_t testService = 10;
+static constexpr size_t packetCount = 100;
+
+int main() {
+    bool passed = true;
+    using clock = std::chrono::steady_clock;
+
+    // An idle loop blocks without updating the network manager
+    {
+        RnpNetworkManager netman(nodeA, NODETYPE::LEAF, false, 256, 64);
+        UdpInterface udp(linkID, "127.0.0.1:0", "udp");
+        udp.setup();
+        netman.addInterface(&udp);
+        RnpEventLoop loop(netman);
+        passed &= check(loop.valid(), "event loop not created");
+
+        const auto start = clock::now();
+        const size_t events = loop.runOnce(100);
+        passed &= check(events == 0 && loop.getUpdateCount() == 0 &&
+                            clock::now() - start >=
+                                std::chrono::milliseconds(90),
+                        "idle loop did not block");
+
+        // wake() from another thread ends the wait, with an update
+        std::thread waker([&loop] {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            loop.wake();
+        });
+        passed &= check(loop.runOnce() == 1 && loop.getUpdateCount() == 1,
+                        "wake did not end the wait");
+        waker.join();
+
+        // Timers fire periodically, each with a single update
+        size_t ticks = 0;
+        loop.addTimer(5, [&] {
+            if (++ticks == 10) {
+                loop.stop();
+            }
+        });
+        loop.run();
+        passed &= check(ticks == 10 && loop.getUpdateCount() <= 12,
+                        "timer did not fire");
+    }
+
+    // Echo over TCP between two loops, the server registering the listening
+    // socket until the client connects
+    {
+        RnpNetworkManager netmanA(nodeA, NODETYPE::LEAF, false, 256, 64);
+        RnpNetworkManager netmanB(nodeB, NODETYPE::LEAF, false, 256, 64);
+        netmanA.setRoutingBudget(0);
+        netmanB.setRoutingBudget(0);
+        TcpInterface server(linkID, "127.0.0.1:0", TCP_MODE::SERVER, "server");
+        server.setup();
+        netmanB.addInterface(&server);
+        RnpEventLoop loopB(netmanB);
+
+        RoutingTable tableB;
+        tableB.setRoute(nodeA, Route{linkID, 1, {}});
+        netmanB.setRoutingTable(tableB);
+        netmanB.registerService(testService, [&](packetptr_t packet_ptr) {
+            SimpleCommandPacket reply(*packet_ptr);
+            RnpHeader::generateResponseHeader(packet_ptr->header,
+                                              reply.header);
+            netmanB.sendPacket(reply);
+        });
+        std::thread serverThread([&loopB] { loopB.run(); });
+
+        TcpInterface client(linkID,
+                            "127.0.0.1:" + std::to_string(server.getPort()),
+                            TCP_MODE::CLIENT, "client");
+        client.setup();
+        netmanA.addInterface(&client);
+        RnpEventLoop loopA(netmanA);
+
+        RoutingTable tableA;
+        tableA.setRoute(nodeB, Route{linkID, 1, {}});
+        netmanA.setRoutingTable(tableA);
+
+        size_t received = 0;
+        int32_t argSum = 0;
+        netmanA.registerService(testService, [&](packetptr_t packet_ptr) {
+            SimpleCommandPacket reply(*packet_ptr);
+            argSum += reply.arg;
+            if (++received == packetCount) {
+                loopA.stop();
+            }
+        });
+
+        // Stop if the echo does not complete
+        loopA.addTimer(5000, [&loopA] { loopA.stop(); });
+
+        int32_t expectedSum = 0;
+        for (size_t i = 0; i < packetCount; i++) {
+            SimpleCommandPacket packet(1, static_cast<int32_t>(i));
+            packet.header.source = nodeA;
+            packet.header.destination = nodeB;
+            packet.header.source_service = testService;
+            packet.header.destination_service = testService;
+            netmanA.sendPacket(packet);
+            expectedSum += static_cast<int32_t>(i);
+        }
+
+        // Packets were sent outside the loop, wake it so they are flushed
+        loopA.wake();
+        loopA.run();
+
+        loopB.stop();
+        serverThread.join();
+
+        passed &= check(received == packetCount && argSum == expectedSum,
+                        "TCP echo incomplete");
+    }
+
+    std::cout << (passed ? "PASSED" : "FAILED") << std::endl;
+    return passed ? 0 : 1;
+}
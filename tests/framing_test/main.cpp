@@ -0,0 +1,193 @@
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <librnp/default_packets/simplecommandpacket.h>
+#include <librnp/ptyinterface.h>
+#include <librnp/rnp_framing.h>
+#include <librnp/rnp_networkmanager.h>
+#include <librnp/rnp_routingtable.h>
+#include <librnp/tcpinterface.h>
+#include "testCheck.h"
+
+static constexpr uint8_t nodeA = 10;
+static constexpr uint8_t nodeB = 11;
+static constexpr uint8_t linkID = 2;
+static constexpr uint8_t testService = 10;
+static constexpr size_t packetCount = 100;
+
+// Update both nodes until a condition holds
+template <typename F>
+static bool updateUntil(RnpNetworkManager &a, RnpNetworkManager &b,
+                        F condition) {
+    for (size_t i = 0; i < 100000 && !condition(); i++) {
+        a.update();
+        b.update();
+    }
+    return condition();
+}
+
+// Send packets from A to B over the link and echo them back
+static bool exchange(RnpInterface &linkA, RnpInterface &linkB,
+                     const char *name) {
+    RnpNetworkManager netmanA(nodeA, NODETYPE::LEAF, false, 256, 64);
+    RnpNetworkManager netmanB(nodeB, NODETYPE::LEAF, false, 256, 64);
+    netmanA.addInterface(&linkA);
+    netmanB.addInterface(&linkB);
+    netmanA.setRoutingBudget(0);
+    netmanB.setRoutingBudget(0);
+
+    RoutingTable tableA;
+    tableA.setRoute(nodeB, Route{linkID, 1, {}});
+    netmanA.setRoutingTable(tableA);
+    RoutingTable tableB;
+    tableB.setRoute(nodeA, Route{linkID, 1, {}});
+    netmanB.setRoutingTable(tableB);
+
+    netmanB.registerService(testService, [&](packetptr_t packet_ptr) {
+        SimpleCommandPacket reply(*packet_ptr);
+        RnpHeader::generateResponseHeader(packet_ptr->header, reply.header);
+        netmanB.sendPacket(reply);
+    });
+
+    size_t received = 0;
+    int32_t argSum = 0;
+    netmanA.registerService(testService, [&](packetptr_t packet_ptr) {
+        SimpleCommandPacket reply(*packet_ptr);
+        received++;
+        argSum += reply.arg;
+    });
+
+    int32_t expectedSum = 0;
+    for (size_t i = 0; i < packetCount; i++) {
+        SimpleCommandPacket packet(1, static_cast<int32_t>(i));
+        packet.header.source = nodeA;
+        packet.header.destination = nodeB;
+        packet.header.source_service = testService;
+        packet.header.destination_service = testService;
+        netmanA.sendPacket(packet);
+        expectedSum += static_cast<int32_t>(i);
+    }
+
+    const bool ok =
+        updateUntil(netmanA, netmanB, [&] { return received == packetCount; });
+    if (!ok || argSum != expectedSum) {
+        std::cout << "FAILED: " << name << " exchange, received " << received
+                  << std::endl;
+        return false;
+    }
+    return true;
+}
+
+int main() {
+    bool passed = true;
+
+    // Round trip payloads around the COBS block boundaries, all zeros and
+    // all non-zero, through a deframer fed one byte at a time
+    std::vector<std::vector<uint8_t>> payloads;
+    for (const size_t size : {1, 2, 100, 252, 253, 254, 255, 508, 1000}) {
+        payloads.emplace_back(size, 0x00);
+        std::vector<uint8_t> ramp(size);
+        for (size_t i = 0; i < size; i++) {
+            ramp[i] = static_cast<uint8_t>(1 + (i % 255));
+        }
+        payloads.push_back(ramp);
+    }
+
+    std::vector<uint8_t> stream;
+    for (const auto &payload : payloads) {
+        const size_t before = stream.size();
+        RnpFraming::encode(payload, stream);
+        passed &= check(stream.size() - before <=
+                            RnpFraming::maxEncodedSize(payload.size()),
+                        "frame larger than maxEncodedSize");
+    }
+
+    RnpDeframer deframer(1024);
+    size_t decoded = 0;
+    bool match = true;
+    for (const uint8_t byte : stream) {
+        deframer.feed(RnpBufferView(&byte, 1), [&](const RnpBufferView frame) {
+            const auto &expected = payloads[decoded++];
+            match &= std::vector<uint8_t>(frame.begin(), frame.end()) ==
+                     expected;
+        });
+    }
+    passed &= check(decoded == payloads.size() && match,
+                    "byte by byte round trip mismatch");
+
+    // Random chunk sizes with a corrupted frame, the frames either side of it
+    // are still decoded
+    std::mt19937 rng(1);
+    std::vector<uint8_t> corrupted;
+    std::vector<uint8_t> payload(200);
+    for (size_t frame = 0; frame < 50; frame++) {
+        for (auto &byte : payload) {
+            byte = static_cast<uint8_t>(rng());
+        }
+        const size_t before = corrupted.size();
+        RnpFraming::encode(payload, corrupted);
+        if (frame == 20) {
+            corrupted[before + 50] ^= 0x01;
+        }
+    }
+
+    RnpDeframer chunked(1024);
+    decoded = 0;
+    size_t offset = 0;
+    while (offset < corrupted.size()) {
+        const size_t chunk = std::min<size_t>(1 + rng() % 300,
+                                              corrupted.size() - offset);
+        chunked.feed(RnpBufferView(corrupted.data() + offset, chunk),
+                     [&](const RnpBufferView) { decoded++; });
+        offset += chunk;
+    }
+    passed &= check(decoded == 49 && chunked.errors() >= 1,
+                    "corrupted frame not isolated");
+
+    // Frames larger than the deframer are dropped
+    RnpDeframer small(100);
+    std::vector<uint8_t> large;
+    RnpFraming::encode(std::vector<uint8_t>(101, 1), large);
+    RnpFraming::encode(std::vector<uint8_t>(100, 1), large);
+    decoded = 0;
+    small.feed(large, [&](const RnpBufferView) { decoded++; });
+    passed &= check(decoded == 1 && small.errors() == 1,
+                    "oversized frame not dropped");
+
+    // Known CRC-16/CCITT check value
+    const std::string checkString = "123456789";
+    passed &= check(RnpFraming::crc16(RnpBufferView(
+                        reinterpret_cast<const uint8_t *>(checkString.data()),
+                        checkString.size())) == 0x29B1,
+                    "crc16 check value mismatch");
+
+    // TCP client and server over 127.0.0.1
+    {
+        TcpInterface server(linkID, "127.0.0.1:0", TCP_MODE::SERVER, "server");
+        server.setup();
+        TcpInterface client(linkID,
+                            "127.0.0.1:" + std::to_string(server.getPort()),
+                            TCP_MODE::CLIENT, "client");
+        client.setup();
+        passed &= check(server.getPort() != 0 && client.connected(),
+                        "TCP not connected");
+        passed &= exchange(client, server, "TCP");
+    }
+
+    // Pseudo terminal, with the other end opened by a second interface
+    {
+        PtyInterface master(linkID);
+        master.setup();
+        PtyInterface slave(linkID, master.getDevicePath());
+        slave.setup();
+        passed &= check(master.connected() && slave.connected(),
+                        "PTY not opened");
+        passed &= exchange(master, slave, "PTY");
+    }
+
+    std::cout << (passed ? "PASSED" : "FAILED") << std::endl;
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,87 @@
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <librnp/rnp_linkaddress.h>
+#include <librnp/rnp_netman_packets.h>
+#include <librnp/rnp_networkmanager.h>
+#include "allocationCounter.h"
+#include "testCheck.h"
+
+static constexpr uint8_t node = 10;
+static constexpr uint8_t remote = 20;
+
+int main() {
+    bool passed = true;
+    const size_t baseline = RnpLinkAddress::internedCount();
+
+    // Copies share the interned string, which is removed with the last one
+    {
+        RnpLinkAddress first("peer");
+        RnpLinkAddress second("peer");
+        RnpLinkAddress copy = first;
+        RnpLinkAddress moved = std::move(second);
+        passed &= check(first == copy && first == moved &&
+                            first.get() == moved.get() && second.empty(),
+                        "equal addresses not shared");
+        passed &= check(RnpLinkAddress::internedCount() == baseline + 1,
+                        "address interned more than once");
+
+        first = RnpLinkAddress("other");
+        copy = RnpLinkAddress();
+        passed &= check(moved.str() == "peer", "shared address released");
+
+        // Interning an address already in the table does not copy it
+        const std::string_view longAddress =
+            "peer-with-an-address-too-long-for-small-strings";
+        RnpLinkAddress held(longAddress);
+        const size_t allocations = allocationCount;
+        RnpLinkAddress again(longAddress);
+        passed &= check(allocationCount == allocations && again == held,
+                        "interned address copied");
+    }
+    passed &= check(RnpLinkAddress::internedCount() == baseline,
+                    "released address still interned");
+
+    // A stream of routes with distinct addresses only keeps the current one
+    {
+        RnpNetworkManager netman(node);
+        for (size_t i = 0; i < 1000; i++) {
+            SetRoutePacket packet(remote,
+                                  Route{2, 1, "peer" + std::to_string(i)});
+            packet.header.source = node;
+            packet.header.destination = node;
+            netman.sendPacket(packet);
+            netman.update();
+        }
+        // Only the address of the current route is left
+        passed &= check(RnpLinkAddress::internedCount() == baseline + 1,
+                        "replaced route addresses still interned");
+    }
+    passed &= check(RnpLinkAddress::internedCount() == baseline,
+                    "routing table addresses still interned");
+
+    // Threads copying and interning the same addresses leave nothing behind
+    {
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < 4; t++) {
+            threads.emplace_back([] {
+                for (size_t i = 0; i < 20000; i++) {
+                    RnpLinkAddress address("shared" + std::to_string(i % 3));
+                    RnpLinkAddress copy = address;
+                    copy = RnpLinkAddress("shared" + std::to_string(i % 5));
+                }
+            });
+        }
+        for (std::thread &thread : threads) {
+            thread.join();
+        }
+    }
+    passed &= check(RnpLinkAddress::internedCount() == baseline,
+                    "addresses leaked by concurrent use");
+
+    std::cout << (passed ? "PASSED" : "FAILED") << std::endl;
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,122 @@
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <librnp/default_packets/simplecommandpacket.h>
+#include <librnp/rnp_logger.h>
+#include <librnp/rnp_netman_packets.h>
+#include <librnp/rnp_networkmanager.h>
+#include "allocationCounter.h"
+#include "mockInterface.h"
+#include "testCheck.h"
+
+static constexpr uint8_t node = 10;
+static constexpr uint8_t mockID = 2;
+
+// Levels up to RNP_LOG_LEVEL are compiled in, the rest are not
+static_assert(RnpLogger::compiledIn<LOG_LEVEL::ERR>());
+static_assert(RnpLogger::compiledIn<LOG_LEVEL::WARN>() ==
+              (RNP_LOG_LEVEL >= RNP_LOG_LEVEL_WARN));
+static_assert(RnpLogger::compiledIn<LOG_LEVEL::INFO>() ==
+              (RNP_LOG_LEVEL >= RNP_LOG_LEVEL_INFO));
+static_assert(!RnpLogger::compiledIn<LOG_LEVEL::DBG>() ||
+              (RNP_LOG_LEVEL >= RNP_LOG_LEVEL_DEBUG));
+
+int main() {
+    bool passed = true;
+
+    std::vector<std::string> messages;
+    RnpLogger logger;
+    logger.setCallback(
+        [&messages](const std::string &message) { messages.push_back(message); });
+
+    // Levels other than INFO are prefixed
+    logger.log(LOG_LEVEL::ERR, "error");
+    logger.log(LOG_LEVEL::WARN, "warning");
+    logger.log(LOG_LEVEL::INFO, "information");
+    logger.log(LOG_LEVEL::DBG, "debug");
+    passed &= check(messages.size() == 4 && messages[0] == "[E] error" &&
+                        messages[1] == "[W] warning" &&
+                        messages[2] == "information" &&
+                        messages[3] == "[D] debug",
+                    "level prefixes wrong");
+
+    // Arguments are formatted and concatenated
+    messages.clear();
+    logger.log(LOG_LEVEL::INFO, "s", std::string("t"), 42, -7,
+               static_cast<uint8_t>(200), 2.5, 0.1f, RnpLogHex{0xAF}, true,
+               NODETYPE::HUB);
+    passed &= check(messages.size() == 1 &&
+                        messages[0] == "st42-72002.50.1af1" +
+                                           std::to_string(static_cast<int>(
+                                               NODETYPE::HUB)),
+                    "arguments formatted wrongly");
+    passed &= check(logger.recent(0).str() == messages.back() &&
+                        logger.recent(1).str() == "[D] debug",
+                    "recent records wrong");
+
+    // Long messages are truncated at the record length, and numbers which do
+    // not fit are left out
+    messages.clear();
+    const std::string longText(RnpLogRecord::maxLength + 50, 'x');
+    logger.log(LOG_LEVEL::INFO, longText, 123);
+    const std::string almostFull(RnpLogRecord::maxLength - 2, 'y');
+    logger.log(LOG_LEVEL::INFO, almostFull, 12345, "z");
+    passed &= check(messages.size() == 2 &&
+                        messages[0] ==
+                            longText.substr(0, RnpLogRecord::maxLength) &&
+                        messages[1] == almostFull + "z",
+                    "long message not truncated");
+
+    // Nothing is allocated once the callback string has grown
+    size_t delivered = 0;
+    logger.setCallback([&delivered](const std::string &) { delivered++; });
+    logger.log(LOG_LEVEL::WARN, longText);
+    const size_t allocations = allocationCount;
+    for (size_t i = 0; i < 1000; i++) {
+        logger.log(LOG_LEVEL::WARN, "packet ", i, " dropped at ", 1.5 * i,
+                   " by ", RnpLogHex{static_cast<uint32_t>(i)});
+    }
+    passed &= check(delivered == 1001 && allocationCount == allocations,
+                    "warm logging allocated");
+
+    // The network manager only logs levels which are compiled in
+    RnpNetworkManager netman(node, NODETYPE::LEAF, true);
+    MockInterface mock(mockID, "mock");
+    netman.addInterface(&mock);
+    netman.setRoutingBudget(0);
+    messages.clear();
+    netman.setLogCb(
+        [&messages](const std::string &message) { messages.push_back(message); });
+
+    // An invalid packet is logged as an error, with the bytes in hex
+    SimpleCommandPacket packet(1, 0);
+    packet.header.source = node + 1;
+    packet.header.destination = node;
+    std::vector<uint8_t> invalid;
+    packet.serialize(invalid);
+    invalid[0] = 0xFF;
+    mock.placeOnPacketBuffer(RnpBufferView(invalid.data(), invalid.size()));
+    netman.update();
+    passed &= check(messages.size() == 1 &&
+                        messages[0] == "[E] header protocol mismatch, "
+                                       "expected: 0xaf, decoded: 0xff!",
+                    "error not logged");
+
+    // A ping is logged as information
+    messages.clear();
+    PingPacket ping(0);
+    ping.header.source = node;
+    ping.header.destination = node;
+    ping.header.source_service =
+        static_cast<uint8_t>(DEFAULT_SERVICES::NETMAN);
+    netman.sendPacket(ping);
+    netman.update();
+    passed &= check(RnpLogger::compiledIn<LOG_LEVEL::INFO>()
+                        ? !messages.empty()
+                        : messages.empty(),
+                    "information logged at the wrong level");
+
+    std::cout << (passed ? "PASSED" : "FAILED") << std::endl;
+    return passed ? 0 : 1;
+}
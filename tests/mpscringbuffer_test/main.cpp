@@ -0,0 +1,131 @@
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <librnp/rnp_mpscringbuffer.h>
+#include <librnp/rnp_packetbufferinterface.h>
+#include "testCheck.h"
+
+static constexpr size_t producerCount = 4;
+static constexpr size_t perProducer = 100000;
+static constexpr size_t ringCapacity = 1024;
+
+int main() {
+    bool passed = true;
+
+    // A full ring rejects pushes until the consumer frees a cell, and elements
+    // come out in order across laps
+    {
+        Rnp_MPSCRingBuffer<std::unique_ptr<size_t>> ring(5);
+        passed &= check(ring.capacity() == 8, "capacity not rounded");
+
+        size_t pushed = 0;
+        while (ring.push(std::make_unique<size_t>(pushed))) {
+            pushed++;
+        }
+        passed &= check(pushed == 8 && ring.size() == 8, "full ring accepted");
+
+        std::unique_ptr<size_t> out;
+        bool ordered = true;
+        for (size_t i = 0; i < 100; i++) {
+            ordered &= ring.pop(out) && out && (*out == i);
+            ordered &= ring.push(std::make_unique<size_t>(pushed++));
+        }
+        passed &= check(ordered, "elements out of order across laps");
+
+        size_t drained = 0;
+        while (ring.pop(out)) {
+            drained++;
+        }
+        passed &= check(drained == 8 && ring.empty() && !ring.pop(out),
+                        "ring not drained");
+
+        Rnp_MPSCRingBuffer<size_t> none(0);
+        passed &= check(!none.push(size_t(1)), "zero capacity ring accepted");
+    }
+
+    // The packet buffer counts pushes rejected by its size limit and by the
+    // ring being full
+    {
+        Rnp_MPSCRingBuffer<size_t> ring(8);
+        Rnp_PacketBufferInterface<size_t> limited(ring, 4);
+        size_t accepted = 0;
+        for (size_t i = 0; i < 6; i++) {
+            accepted += limited.push(i) ? 1 : 0;
+        }
+        passed &= check(accepted == 4 && limited.rejected() == 2,
+                        "size limit not counted");
+
+        size_t out;
+        while (limited.pop(out)) {
+        }
+        Rnp_PacketBufferInterface<size_t> unlimited(ring, 0);
+        accepted = 0;
+        for (size_t i = 0; i < 10; i++) {
+            accepted += unlimited.push(i) ? 1 : 0;
+        }
+        passed &= check(accepted == 8 && unlimited.rejected() == 2,
+                        "full ring not counted");
+    }
+
+    // Producers racing through a small ring lose and duplicate nothing, each
+    // producer's elements stay in order and every failed push is counted
+    {
+        Rnp_MPSCRingBuffer<uint64_t> ring(ringCapacity);
+        Rnp_PacketBufferInterface<uint64_t> buffer(ring, 0);
+        std::atomic<uint32_t> failed{0};
+
+        std::vector<std::thread> producers;
+        for (size_t p = 0; p < producerCount; p++) {
+            producers.emplace_back([&buffer, &failed, p] {
+                uint32_t retries = 0;
+                for (uint64_t i = 0; i < perProducer; i++) {
+                    // Element carries its producer and sequence number
+                    while (!buffer.push((static_cast<uint64_t>(p) << 32) |
+                                        i)) {
+                        retries++;
+                        std::this_thread::yield();
+                    }
+                }
+                failed.fetch_add(retries, std::memory_order_relaxed);
+            });
+        }
+
+        std::vector<uint64_t> next(producerCount, 0);
+        size_t received = 0;
+        bool valid = true;
+        uint64_t element;
+        while (received < producerCount * perProducer) {
+            if (!buffer.pop(element)) {
+                std::this_thread::yield();
+                continue;
+            }
+            const size_t p = static_cast<size_t>(element >> 32);
+            const uint64_t sequence = element & 0xFFFFFFFF;
+            if ((p >= producerCount) || (sequence != next[p])) {
+                valid = false;
+                break;
+            }
+            next[p]++;
+            received++;
+        }
+
+        for (std::thread &producer : producers) {
+            producer.join();
+        }
+
+        passed &= check(valid, "element lost, duplicated or out of order");
+        passed &= check(received == producerCount * perProducer &&
+                            !buffer.pop(element),
+                        "element count wrong");
+        passed &= check(buffer.rejected() ==
+                            failed.load(std::memory_order_relaxed),
+                        "rejected pushes not counted");
+    }
+
+    std::cout << (passed ? "PASSED" : "FAILED") << std::endl;
+    return passed ? 0 : 1;
+}
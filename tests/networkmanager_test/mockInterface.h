@@ -26,10 +26,10 @@ public:
     Printer(id,name)
     {};
 
-    void placeOnPacketBuffer(std::unique_ptr<RnpPacketSerialized> packet_ptr)
+    void placeOnPacketBuffer(packetptr_t packet_ptr)
     {
 
-        if (_packetBuffer == nullptr) {
+        if (_packetBuffer == nullptr || packet_ptr == nullptr) {
             return;
         }
 
@@ -40,6 +40,17 @@ public:
         _packetBuffer->push(std::move(packet_ptr));
     }
 
+    /**
+     * @brief Place serialized bytes on the packet buffer, taking the packet
+     * from the network manager's packet pool
+     *
+     * @param bytes Serialized packet
+     */
+    void placeOnPacketBuffer(const RnpBufferView bytes)
+    {
+        placeOnPacketBuffer(createPacket(bytes));
+    }
+
     /**
      * @brief Destroy the MockInterface object
      *
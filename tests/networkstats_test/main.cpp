@@ -0,0 +1,226 @@
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <librnp/default_packets/simplecommandpacket.h>
+#include <librnp/rnp_interface.h>
+#include <librnp/rnp_netman_packets.h>
+#include <librnp/rnp_networkmanager.h>
+#include <librnp/rnp_routingtable.h>
+#include "testCheck.h"
+
+/**
+ * @brief Interface linked directly to an interface on another node
+ */
+class LinkInterface : public RnpInterface {
+public:
+    LinkInterface(const uint8_t id, const std::string name = "LinkInterface")
+        : RnpInterface(id, name), peer(nullptr){};
+
+    void setup() override{};
+
+    void update() override{};
+
+    void sendPacket(RnpPacket &data) override {
+        // Serialize packet
+        std::vector<uint8_t> serializedData;
+        data.serialize(serializedData);
+
+        // Deliver to the linked interface
+        if (peer != nullptr) {
+            peer->receive(serializedData);
+        }
+    };
+
+    const RnpInterfaceInfo *getInfo() override { return &info; };
+
+    void receive(const RnpBufferView bytes) {
+        packetptr_t packet_ptr = createPacket(bytes);
+        if (_packetBuffer == nullptr || packet_ptr == nullptr) {
+            return;
+        }
+        packet_ptr->header.src_iface = getID();
+        _packetBuffer->push(std::move(packet_ptr));
+    };
+
+    /// @brief Interface on the other node
+    LinkInterface *peer;
+
+private:
+    RnpInterfaceInfo info;
+};
+
+static constexpr uint8_t nodeA = 10;
+static constexpr uint8_t nodeB = 11;
+static constexpr uint8_t nodeBeyond = 12;
+static constexpr uint8_t nodeUnknown = 99;
+static constexpr uint8_t linkID = 2;
+static constexpr uint8_t testService = 10;
+static constexpr uint8_t missingService = 50;
+static constexpr uint8_t statsService = 20;
+static constexpr size_t bufferSize = 4;
+static constexpr uint8_t hopLimit = 16;
+
+/**
+ * @brief Serialize a packet from node A, as received by node B
+ *
+ * @param[in] destination Destination node
+ * @param[in] service Destination service
+ * @param[in] hops Hops already made
+ * @return std::vector<uint8_t> Serialized packet
+ */
+static std::vector<uint8_t> makePacket(const uint8_t destination,
+                                       const uint8_t service,
+                                       const uint8_t hops = 0) {
+    SimpleCommandPacket packet(1, 0);
+    packet.header.source = nodeA;
+    packet.header.hops = hops;
+    packet.header.destination = destination;
+    packet.header.source_service = testService;
+    packet.header.destination_service = service;
+    std::vector<uint8_t> bytes;
+    packet.serialize(bytes);
+    return bytes;
+}
+
+int main() {
+    bool passed = true;
+
+    RnpNetworkManager netmanA(nodeA);
+    RnpNetworkManager netmanB(nodeB, NODETYPE::HUB, false, bufferSize);
+    LinkInterface linkA(linkID, "linkA");
+    LinkInterface linkB(linkID, "linkB");
+    linkA.peer = &linkB;
+    linkB.peer = &linkA;
+    netmanA.addInterface(&linkA);
+    netmanB.addInterface(&linkB);
+    netmanA.setNoRouteAction(NOROUTE_ACTION::DUMP);
+    netmanB.setNoRouteAction(NOROUTE_ACTION::DUMP);
+    netmanA.setRoutingBudget(0);
+    netmanB.setRoutingBudget(0);
+    netmanB.setHopLimit(hopLimit);
+
+    // Each node reaches the other over the link, B also forwards to a node
+    // beyond A, back out of the link packets from A arrive on
+    RoutingTable tableA;
+    tableA.setRoute(nodeB, Route{linkID, 1, {}});
+    netmanA.setRoutingTable(tableA);
+    RoutingTable tableB;
+    tableB.setRoute(nodeA, Route{linkID, 1, {}});
+    tableB.setRoute(nodeBeyond, Route{linkID, 2, {}});
+    netmanB.setRoutingTable(tableB);
+
+    size_t delivered = 0;
+    netmanB.registerService(testService,
+                            [&delivered](packetptr_t) { delivered++; });
+
+    const std::vector<uint8_t> valid = makePacket(nodeB, testService);
+
+    // Packets pushed onto a full buffer are dropped as BUFFER_FULL
+    for (size_t i = 0; i < bufferSize + 2; i++) {
+        linkB.receive(valid);
+    }
+    netmanB.update();
+    passed &= check(delivered == bufferSize &&
+                        netmanB.getStats().dropped(DROP_REASON::BUFFER_FULL) ==
+                            2,
+                    "buffer full not counted");
+
+    // Each drop reason counts its own packets and nothing else
+    netmanB.resetStats();
+    passed &= check(netmanB.getStats().dropped(DROP_REASON::BUFFER_FULL) == 0,
+                    "buffer full not reset");
+
+    std::vector<uint8_t> invalid = valid;
+    invalid[0] = 0xFF;
+    const std::vector<std::pair<DROP_REASON, std::vector<uint8_t>>> cases = {
+        {DROP_REASON::INVALID, invalid},
+        {DROP_REASON::NO_ROUTE, makePacket(nodeUnknown, testService)},
+        {DROP_REASON::NO_SERVICE, makePacket(nodeB, missingService)},
+        {DROP_REASON::SAME_IFACE, makePacket(nodeBeyond, testService)},
+        {DROP_REASON::LOOP, makePacket(nodeUnknown, testService, hopLimit)},
+    };
+    size_t rxBytes = 0;
+    for (const auto &entry : cases) {
+        const RnpNetworkStats before = netmanB.getStats();
+        linkB.receive(entry.second);
+        netmanB.update();
+        rxBytes += entry.second.size();
+
+        const RnpNetworkStats &after = netmanB.getStats();
+        bool counted = true;
+        for (size_t reason = 0;
+             reason < static_cast<size_t>(DROP_REASON::COUNT); reason++) {
+            const uint32_t expected =
+                before.drops[reason] +
+                ((reason == static_cast<size_t>(entry.first)) ? 1 : 0);
+            counted &= (after.drops[reason] == expected);
+        }
+        passed &= check(counted, "drop counted against the wrong reason");
+    }
+
+    // Only the hop limit counts as a hop limit drop, not a packet which
+    // would go back out of the interface it came in on
+    passed &= check(netmanB.getHopLimitCount() == 1,
+                    "same interface drop counted at the hop limit");
+
+    // Received packets are counted on their interface whether dropped or
+    // not, replies on the interface they are sent from, and deliveries on
+    // their service
+    netmanB.registerService(testService, [&](packetptr_t packet_ptr) {
+        SimpleCommandPacket reply(*packet_ptr);
+        RnpHeader::generateResponseHeader(packet_ptr->header, reply.header);
+        netmanB.sendPacket(reply);
+    });
+    linkB.receive(valid);
+    netmanB.update();
+    rxBytes += valid.size();
+
+    const RnpNetworkStats &statsB = netmanB.getStats();
+    passed &= check(statsB.interfaces.size() > linkID &&
+                        statsB.interfaces[linkID].rxPackets ==
+                            cases.size() + 1 &&
+                        statsB.interfaces[linkID].rxBytes == rxBytes,
+                    "received packets not counted");
+    passed &= check(statsB.interfaces[linkID].txPackets == 1 &&
+                        statsB.interfaces[linkID].txBytes == valid.size(),
+                    "sent packets not counted");
+    passed &= check(statsB.serviceDeliveries[testService] == 1 &&
+                        statsB.serviceDeliveries[missingService] == 0,
+                    "service deliveries not counted");
+
+    // A reads B's statistics remotely, the response counting the request
+    // but not itself
+    GetStatsPacket request(linkID | (testService << 8));
+    request.header.source = nodeA;
+    request.header.destination = nodeB;
+    request.header.source_service = statsService;
+    std::vector<uint8_t> requestBytes;
+    request.serialize(requestBytes);
+
+    netmanA.update(); // Route the reply to the echoed packet
+    const RnpInterfaceStats before = netmanB.getStats().interfaces[linkID];
+    bool reported = false;
+    netmanA.registerService(statsService, [&](packetptr_t packet_ptr) {
+        NetworkStatsPacket stats(*packet_ptr);
+        reported =
+            (packet_ptr->header.source == nodeB) &&
+            (stats.iface == linkID) && (stats.service == testService) &&
+            (stats.rxPackets == before.rxPackets + 1) &&
+            (stats.rxBytes == before.rxBytes + requestBytes.size()) &&
+            (stats.txPackets == before.txPackets) &&
+            (stats.txBytes == before.txBytes) &&
+            (stats.serviceDeliveries == 1) &&
+            (stats.dropBufferFull == 0) && (stats.dropInvalid == 1) &&
+            (stats.dropNoRoute == 1) && (stats.dropNoService == 1) &&
+            (stats.dropLoop == 1) && (stats.dropDuplicate == 0) &&
+            (stats.dropSameIface == 1);
+    });
+    netmanA.sendPacket(request);
+    netmanB.update();
+    netmanA.update();
+    passed &= check(reported, "statistics not reported");
+
+    std::cout << (passed ? "PASSED" : "FAILED") << std::endl;
+    return passed ? 0 : 1;
+}
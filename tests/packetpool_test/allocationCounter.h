@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+// Count every heap allocation made by the process, by replacing the global
+// operator new. Replacements cannot be inline, so include this header from
+// exactly one source file of an executable.
+static size_t allocationCount = 0;
+
+void *operator new(size_t size)
+{
+    allocationCount++;
+    if (void *ptr = std::malloc(size ? size : 1))
+    {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+
+void operator delete(void *ptr, size_t) noexcept { std::free(ptr); }
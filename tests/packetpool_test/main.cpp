@@ -0,0 +1,62 @@
+#include <iostream>
+#include <vector>
+
+#include <librnp/rnp_networkmanager.h>
+#include "allocationCounter.h"
+#include "mockInterface.h"
+
+static constexpr size_t packetCount = 1000000;
+static constexpr uint8_t testService = 10;
+
+RnpNetworkManager networkmanager(254, NODETYPE::LEAF, false, 200, 32);
+MockInterface mock0(1, "mock0");
+
+static size_t delivered = 0;
+
+int main()
+{
+    networkmanager.addInterface(&mock0);
+
+    // service handler just drops the packet, returning it to the pool
+    networkmanager.registerService(testService, [](packetptr_t packet_ptr) { delivered++; });
+
+    // serialize a packet addressed to this node from the debug address
+    using MessagePacket = MessagePacket_Base<testService, 10>;
+    MessagePacket msgp("Test Packet!");
+    msgp.header.source = 2;
+    msgp.header.destination = 254;
+    msgp.header.destination_service = testService;
+
+    std::vector<uint8_t> serializedData;
+    msgp.serialize(serializedData);
+
+    // warm up
+    for (size_t i = 0; i < 1000; i++)
+    {
+        mock0.placeOnPacketBuffer(serializedData);
+        networkmanager.update();
+    }
+
+    allocationCount = 0;
+    delivered = 0;
+
+    for (size_t i = 0; i < packetCount; i++)
+    {
+        mock0.placeOnPacketBuffer(serializedData);
+        networkmanager.update();
+    }
+
+    const size_t allocations = allocationCount;
+
+    std::cout << "packets delivered: " << delivered << "\n";
+    std::cout << "heap allocations: " << allocations << std::endl;
+
+    if (delivered != packetCount || allocations != 0)
+    {
+        std::cout << "FAILED" << std::endl;
+        return 1;
+    }
+
+    std::cout << "PASSED" << std::endl;
+    return 0;
+}
@@ -0,0 +1,102 @@
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+#include <librnp/default_packets/simplecommandpacket.h>
+#include <librnp/rnp_networkmanager.h>
+#include "testCheck.h"
+
+static constexpr uint8_t node = 10;
+static constexpr uint8_t testService = 10;
+static constexpr size_t packetCount = 10;
+
+/**
+ * @brief Queue packets to a service on the node itself, over loopback
+ */
+static void queuePackets(RnpNetworkManager &netman, const size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        SimpleCommandPacket packet(1, static_cast<int32_t>(i));
+        packet.header.source = node;
+        packet.header.destination = node;
+        packet.header.source_service = testService;
+        packet.header.destination_service = testService;
+        netman.sendPacket(packet);
+    }
+}
+
+int main() {
+    bool passed = true;
+    RnpNetworkManager netman(node);
+
+    size_t delivered = 0;
+    bool resend = false;
+    uint32_t handlerDelay_us = 0;
+    netman.registerService(testService, [&](packetptr_t) {
+        delivered++;
+        if (handlerDelay_us != 0) {
+            std::this_thread::sleep_for(
+                std::chrono::microseconds(handlerDelay_us));
+        }
+        if (resend) {
+            resend = false;
+            queuePackets(netman, 1);
+        }
+    });
+
+    // The default budget processes a single packet per update
+    queuePackets(netman, 2);
+    RnpUpdateResult result = netman.update();
+    passed &= check(result.processed == 1 && result.queued == 1,
+                    "default budget not one packet");
+    netman.update();
+
+    // A packet budget processes at most that many packets per update,
+    // reporting the rest as queued
+    netman.setRoutingBudget(3);
+    queuePackets(netman, packetCount);
+    delivered = 0;
+    size_t updates = 0;
+    bool counted = true;
+    do {
+        const size_t before = packetCount - delivered;
+        result = netman.update();
+        const size_t expected = (before < 3) ? before : 3;
+        counted &= (result.processed == expected) &&
+                   (result.queued == before - expected);
+        updates++;
+    } while ((result.queued != 0) && (updates < packetCount));
+    passed &= check(counted && delivered == packetCount && updates == 4,
+                    "packet budget not kept");
+
+    // No packet budget drains the packets queued when the update started,
+    // leaving those queued while routing for the next update
+    netman.setRoutingBudget(0);
+    queuePackets(netman, packetCount);
+    delivered = 0;
+    resend = true;
+    result = netman.update();
+    passed &= check(result.processed == packetCount && result.queued == 1,
+                    "packets queued while routing not left queued");
+    result = netman.update();
+    passed &= check(result.processed == 1 && result.queued == 0 &&
+                        delivered == packetCount + 1,
+                    "queued packet not drained");
+
+    // A time budget stops the drain once used up, after at least one packet
+    const uint32_t delay_us = 2000;
+    handlerDelay_us = delay_us;
+    netman.setRoutingBudget(0, delay_us * 3);
+    queuePackets(netman, packetCount);
+    result = netman.update();
+    passed &= check(result.processed >= 1 && result.processed < packetCount &&
+                        result.processed + result.queued == packetCount,
+                    "time budget not kept");
+    netman.setRoutingBudget(0, 1);
+    const size_t queued = result.queued;
+    result = netman.update();
+    passed &= check(result.processed == 1 && result.queued == queued - 1,
+                    "time budget processed no packets");
+
+    std::cout << (passed ? "PASSED" : "FAILED") << std::endl;
+    return passed ? 0 : 1;
+}
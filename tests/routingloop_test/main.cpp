@@ -0,0 +1,189 @@
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <librnp/rnp_interface.h>
+#include <librnp/rnp_networkmanager.h>
+#include <librnp/rnp_routingtable.h>
+
+/**
+ * @brief Interface linked directly to an interface on another node
+ */
+class LinkInterface : public RnpInterface {
+public:
+    LinkInterface(const uint8_t id, const std::string name = "LinkInterface")
+        : RnpInterface(id, name), peer(nullptr){};
+
+    void setup() override{};
+
+    void update() override{};
+
+    void sendPacket(RnpPacket &data) override {
+        // Serialize packet
+        std::vector<uint8_t> serializedData;
+        data.serialize(serializedData);
+
+        // Deliver to the linked interface
+        sent++;
+        if (peer != nullptr) {
+            peer->receive(serializedData);
+        }
+    };
+
+    const RnpInterfaceInfo *getInfo() override { return &info; };
+
+    void receive(const RnpBufferView bytes) {
+        packetptr_t packet_ptr = createPacket(bytes);
+        if (_packetBuffer == nullptr || packet_ptr == nullptr) {
+            return;
+        }
+        packet_ptr->header.src_iface = getID();
+        _packetBuffer->push(std::move(packet_ptr));
+    };
+
+    /// @brief Interface on the other node
+    LinkInterface *peer;
+
+    /// @brief Number of packets sent over the link
+    size_t sent = 0;
+
+private:
+    RnpInterfaceInfo info;
+};
+
+static constexpr uint8_t nodeA = 10;
+static constexpr uint8_t nodeB = 11;
+static constexpr uint8_t nodeC = 12;
+static constexpr uint8_t nodeLeaf = 13;
+static constexpr uint8_t unreachable = 50;
+static constexpr uint8_t maxHops = 8;
+
+static void link(LinkInterface &a, LinkInterface &b) {
+    a.peer = &b;
+    b.peer = &a;
+}
+
+int main() {
+    // Three hubs in a ring, each routing the unreachable node to the next
+    // one, so a packet to it goes round the ring forever without a hop limit
+    RnpNetworkManager netmanA(nodeA, NODETYPE::HUB, true);
+    RnpNetworkManager netmanB(nodeB, NODETYPE::HUB, true);
+    RnpNetworkManager netmanC(nodeC, NODETYPE::HUB, true);
+
+    // Interface 2 links to the next node, interface 3 to the previous one
+    LinkInterface nextA(2, "A->B"), prevB(3, "B->A");
+    LinkInterface nextB(2, "B->C"), prevC(3, "C->B");
+    LinkInterface nextC(2, "C->A"), prevA(3, "A->C");
+    link(nextA, prevB);
+    link(nextB, prevC);
+    link(nextC, prevA);
+
+    netmanA.addInterface(&nextA);
+    netmanA.addInterface(&prevA);
+    netmanB.addInterface(&nextB);
+    netmanB.addInterface(&prevB);
+    netmanC.addInterface(&nextC);
+    netmanC.addInterface(&prevC);
+
+    // Loop the unreachable node round the ring, and route node A directly
+    RoutingTable tableA;
+    tableA.setRoute(unreachable, Route{2, 1, {}});
+    netmanA.setRoutingTable(tableA);
+
+    RoutingTable tableB;
+    tableB.setRoute(unreachable, Route{2, 1, {}});
+    tableB.setRoute(nodeA, Route{3, 1, {}});
+    netmanB.setRoutingTable(tableB);
+
+    RoutingTable tableC;
+    tableC.setRoute(unreachable, Route{2, 1, {}});
+    tableC.setRoute(nodeA, Route{2, 1, {}});
+    netmanC.setRoutingTable(tableC);
+
+    for (RnpNetworkManager *netman : {&netmanA, &netmanB, &netmanC}) {
+        netman->setHopLimit(maxHops, true);
+    }
+
+    // Record hop limit notifications received by node A
+    size_t notifications = 0;
+    netmanA.setLogCb([&notifications](const std::string &message) {
+        if (message.find("dropped at hop limit by Node") != std::string::npos) {
+            notifications++;
+        }
+    });
+
+    // Send a packet from node A into the loop
+    BasicDataPacket<uint32_t, 1, 100> packet(1234);
+    packet.header.source = nodeA;
+    packet.header.destination = unreachable;
+    netmanA.sendPacket(packet);
+
+    // Run all nodes until the loop dies, giving up well past the limit
+    size_t updates = 0;
+    while (updates < 10 * maxHops) {
+        size_t active = 0;
+        for (RnpNetworkManager *netman : {&netmanA, &netmanB, &netmanC}) {
+            const RnpUpdateResult result = netman->update();
+            active += result.processed + result.queued;
+        }
+        updates++;
+
+        if (active == 0) {
+            break;
+        }
+    }
+
+    // Packets sent round the ring, the looping packet plus the notification
+    // sent back to node A
+    const size_t sent = nextA.sent + nextB.sent + nextC.sent;
+    const size_t dropped = netmanA.getHopLimitCount() +
+                           netmanB.getHopLimitCount() +
+                           netmanC.getHopLimitCount();
+
+    std::cout << "updates: " << updates << ", sent over links: " << sent
+              << ", dropped: " << dropped
+              << ", notifications: " << notifications << std::endl;
+
+    if (updates >= 10 * maxHops) {
+        std::cout << "FAILED: loop did not die" << std::endl;
+        return 1;
+    }
+
+    if ((dropped != 1) || (notifications != 1)) {
+        std::cout << "FAILED: expected one drop and one notification"
+                  << std::endl;
+        return 1;
+    }
+
+    if (sent > maxHops + 1) {
+        std::cout << "FAILED: packet made more than " << (int)maxHops
+                  << " hops" << std::endl;
+        return 1;
+    }
+
+    // A leaf node dumps packets for other nodes before the hop limit is
+    // checked, so it neither counts nor notifies them
+    RnpNetworkManager netmanLeaf(nodeLeaf, NODETYPE::LEAF, true);
+    LinkInterface linkLeaf(2, "leaf");
+    netmanLeaf.addInterface(&linkLeaf);
+    RoutingTable tableLeaf;
+    tableLeaf.setRoute(unreachable, Route{2, 1, {}});
+    tableLeaf.setRoute(nodeA, Route{2, 1, {}});
+    netmanLeaf.setRoutingTable(tableLeaf);
+    netmanLeaf.setHopLimit(maxHops, true);
+
+    packet.header.hops = maxHops;
+    std::vector<uint8_t> expired;
+    packet.serialize(expired);
+    linkLeaf.receive(expired);
+    netmanLeaf.update();
+
+    if ((netmanLeaf.getHopLimitCount() != 0) || (linkLeaf.sent != 0)) {
+        std::cout << "FAILED: leaf node counted a packet it does not forward"
+                  << std::endl;
+        return 1;
+    }
+
+    std::cout << "PASSED" << std::endl;
+    return 0;
+}
@@ -0,0 +1,209 @@
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <librnp/rnp_boundedbuffer.h>
+#include <librnp/rnp_endian.h>
+#include <librnp/rnp_header.h>
+#include <librnp/rnp_netman_packets.h>
+#include <librnp/rnp_routingtable.h>
+#include <librnp/rnp_serializer.h>
+#include "testCheck.h"
+
+/**
+ * @brief Nested struct, described by its own serializer
+ */
+struct Vector3 {
+    static constexpr auto getSerializer() {
+        auto ret = RnpSerializer(&Vector3::x, &Vector3::y, &Vector3::z);
+        return ret;
+    }
+
+    float x, y, z;
+};
+
+/**
+ * @brief Frame with an array, nested structs and a bounded buffer
+ */
+struct TelemetryFrame {
+    static constexpr auto getSerializer() {
+        auto ret = RnpSerializer(
+            &TelemetryFrame::timestamp, &TelemetryFrame::channels,
+            &TelemetryFrame::acceleration, &TelemetryFrame::waypoints,
+            &TelemetryFrame::status);
+        return ret;
+    }
+
+    uint32_t timestamp;
+    std::array<int16_t, 4> channels;
+    Vector3 acceleration;
+    std::array<Vector3, 2> waypoints;
+    RnpBoundedBuffer<16> status;
+};
+
+/**
+ * @brief Frame with a member after a bounded buffer, so without a fixed
+ * offset
+ */
+struct StatusFrame {
+    static constexpr auto getSerializer() {
+        auto ret = RnpSerializer(&StatusFrame::id, &StatusFrame::status,
+                                 &StatusFrame::sequence);
+        return ret;
+    }
+
+    uint8_t id;
+    RnpBoundedBuffer<16> status;
+    uint32_t sequence;
+};
+
+using FrameSerializer = decltype(TelemetryFrame::getSerializer());
+
+// Sizes are known at compile time, the status is variable length
+static_assert(decltype(Vector3::getSerializer())::fixed_size());
+static_assert(!FrameSerializer::fixed_size());
+static_assert(FrameSerializer::member_size() == 4 + 8 + 12 + 24 + 1 + 16);
+static_assert(SetRoutePacket::size() == 5 + 32);
+
+// Offsets are only fixed up to the first element whose size varies
+static_assert(TelemetryFrame::getSerializer().member_offset(
+                  &TelemetryFrame::waypoints) == 4 + 8 + 12);
+static_assert(TelemetryFrame::getSerializer().member_offset(
+                  &TelemetryFrame::status) == 4 + 8 + 12 + 24);
+static_assert(StatusFrame::getSerializer().member_offset(
+                  &StatusFrame::status) == 1);
+static_assert(StatusFrame::getSerializer().member_offset(
+                  &StatusFrame::sequence) ==
+              StatusFrame::getSerializer().member_size());
+
+int main() {
+    bool passed = true;
+
+    // Round trip a frame
+    TelemetryFrame frame{};
+    frame.timestamp = 123456;
+    frame.channels = {-1, 2, -3, 4};
+    frame.acceleration = {0.5f, -9.81f, 1.25f};
+    frame.waypoints = {Vector3{1, 2, 3}, Vector3{4, 5, 6}};
+    frame.status.assign("ARMED");
+
+    const auto serializer = TelemetryFrame::getSerializer();
+    std::vector<uint8_t> bytes = serializer.serialize(frame);
+
+    passed &= check(bytes.size() == serializer.serialized_size(frame),
+                    "serialized size mismatch");
+    passed &= check(bytes.size() == 4 + 8 + 12 + 24 + 1 + 5,
+                    "status not sent with its length only");
+
+    TelemetryFrame decoded{};
+    const size_t read = serializer.deserializeFrom(decoded, bytes);
+    passed &= check(read == bytes.size(), "deserialized size mismatch");
+    passed &= check(decoded.timestamp == frame.timestamp &&
+                        decoded.channels == frame.channels &&
+                        decoded.acceleration.y == frame.acceleration.y &&
+                        decoded.waypoints[1].z == frame.waypoints[1].z &&
+                        decoded.status.str() == "ARMED",
+                    "round trip mismatch");
+
+    // The wire format is little endian whatever the host
+    const std::vector<uint8_t> littleEndian = {0x40, 0xE2, 0x01, 0x00,
+                                               0xFF, 0xFF, 0x02, 0x00};
+    passed &= check(std::equal(littleEndian.begin(), littleEndian.end(),
+                               bytes.begin()),
+                    "frame not serialized little endian");
+
+    passed &= check(RnpEndian::byteswap<uint32_t>(0x01020304) == 0x04030201,
+                    "byteswap mismatch");
+
+    const std::array<uint8_t, 8> values = {1, 2, 3, 4, 5, 6, 7, 8};
+    std::array<uint8_t, 8> swapped{};
+    RnpEndian::copySwapped<uint16_t>(swapped.data(), values.data(), 4);
+    passed &= check(swapped == std::array<uint8_t, 8>{2, 1, 4, 3, 6, 5, 8, 7},
+                    "array byte swap mismatch");
+
+    // SetRoutePacket keeps its wire format: destination, interface, metric,
+    // address type, address length and 32 zero filled address bytes
+    const std::string address = "192.168.1.5";
+    SetRoutePacket route(7, Route{2, 3, address});
+    std::vector<uint8_t> wire;
+    route.serialize(wire);
+
+    std::vector<uint8_t> expected(route.header.size(), 0);
+    std::memcpy(expected.data(), wire.data(), route.header.size());
+    expected.insert(expected.end(), {7, 2, 3, 1,
+                                     static_cast<uint8_t>(address.size())});
+    expected.insert(expected.end(), address.begin(), address.end());
+    expected.resize(expected.size() + 32 - address.size(), 0);
+    passed &= check(wire == expected, "SetRoutePacket wire format changed");
+
+    RnpPacketSerialized serialized(wire);
+    SetRoutePacket decodedRoute(serialized);
+    const Route decodedTarget = decodedRoute.getRoute();
+    passed &= check(decodedTarget.iface == 2 && decodedTarget.metric == 3 &&
+                        decodedTarget.address.str() == address,
+                    "SetRoutePacket round trip mismatch");
+
+    // The header is padded after the start byte, so the copied runs must
+    // skip the padding and keep the packed wire layout
+    RnpHeader header(4, 5, 0x0102);
+    header.uid = 0x1234;
+    header.source_service = 3;
+    header.source = 6;
+    header.destination = 7;
+    header.hops = 8;
+    std::array<uint8_t, RnpHeader::size()> headerBytes{};
+    header.serialize(headerBytes.data());
+
+    const std::array<uint8_t, RnpHeader::size()> expectedHeader = {
+        0xAF, 0x02, 0x01, 0x34, 0x12, 3, 4, 5, 6, 7, 8};
+    passed &= check(headerBytes == expectedHeader, "header wire format changed");
+
+    RnpHeader decodedHeader(
+        RnpBufferView(headerBytes.data(), headerBytes.size()));
+    passed &= check(decodedHeader.packet_len == header.packet_len &&
+                        decodedHeader.uid == header.uid &&
+                        decodedHeader.source_service == 3 &&
+                        decodedHeader.type == header.type &&
+                        decodedHeader.hops == header.hops,
+                    "header round trip mismatch");
+
+    // A truncated buffer reports nothing read rather than asserting
+    TelemetryFrame truncated{};
+    passed &= check(serializer.deserializeFrom(
+                        truncated, RnpBufferView(bytes.data(), 10)) == 0,
+                    "truncated frame not rejected");
+
+    // tryDecode reports malformed packets instead of throwing
+    const RnpBufferView shortHeader(headerBytes.data(), 4);
+    passed &= check(RnpHeader::tryDecode(shortHeader).error() ==
+                        RnpDecodeError::HEADER_TOO_SHORT,
+                    "short header not rejected");
+    const RnpBufferView shortPacket(wire.data(), 4);
+    passed &= check(RnpPacketSerialized::tryDecode(shortPacket).error() ==
+                        RnpDecodeError::HEADER_TOO_SHORT,
+                    "short packet not rejected");
+
+    RnpDecodeResult<SetRoutePacket> tried =
+        SetRoutePacket::tryDecode(serialized);
+    passed &= check(tried.ok() && tried->destination == 7 &&
+                        tried->getRoute().address.str() == address,
+                    "SetRoutePacket tryDecode mismatch");
+
+    std::vector<uint8_t> shortWire(wire.begin(), wire.end() - 1);
+    RnpPacketSerialized shortBody(shortWire);
+    passed &= check(SetRoutePacket::tryDecode(shortBody).error() ==
+                        RnpDecodeError::BODY_SIZE_MISMATCH,
+                    "short SetRoutePacket body not rejected");
+
+    shortBody.header.packet_len = 1;
+    passed &= check(SetRoutePacket::tryDecode(shortBody).error() ==
+                        RnpDecodeError::LENGTH_MISMATCH,
+                    "SetRoutePacket length mismatch not rejected");
+
+    std::cout << (passed ? "PASSED" : "FAILED") << std::endl;
+    return passed ? 0 : 1;
+}
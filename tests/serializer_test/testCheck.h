@@ -0,0 +1,17 @@
+#pragma once
+
+#include <iostream>
+
+/**
+ * @brief Report a failed test condition
+ *
+ * @param[in] condition Condition which should hold
+ * @param[in] message Printed if the condition does not hold
+ * @return bool The condition, so results can be combined with &=
+ */
+static bool check(const bool condition, const char *message) {
+    if (!condition) {
+        std::cout << "FAILED: " << message << std::endl;
+    }
+    return condition;
+}
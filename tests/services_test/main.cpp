@@ -0,0 +1,108 @@
+#include <iostream>
+#include <memory>
+
+#include <librnp/default_packets/simplecommandpacket.h>
+#include <librnp/rnp_networkmanager.h>
+#include "testCheck.h"
+
+static constexpr uint8_t node = 10;
+static constexpr uint8_t serviceA = 10;
+static constexpr uint8_t serviceB = 11;
+
+/**
+ * @brief Captured by a handler, recording when the handler is destroyed
+ */
+struct Tracker {
+    explicit Tracker(bool &destroyed) : destroyed(destroyed){};
+    ~Tracker() { destroyed = true; };
+    bool &destroyed;
+};
+
+/**
+ * @brief Send a packet to a service on the node itself, over loopback
+ */
+static void sendToService(RnpNetworkManager &netman, const uint8_t service) {
+    SimpleCommandPacket packet(1, 0);
+    packet.header.source = node;
+    packet.header.destination = node;
+    packet.header.source_service = service;
+    packet.header.destination_service = service;
+    netman.sendPacket(packet);
+    netman.update();
+}
+
+int main() {
+    bool passed = true;
+    RnpNetworkManager netman(node);
+
+    // A handler unregisters itself and another service, then uses its
+    // captures, which must still be alive
+    bool destroyedA = false;
+    bool destroyedB = false;
+    bool aliveAfterUnregister = false;
+    size_t callsA = 0;
+    size_t callsB = 0;
+    auto trackerA = std::make_shared<Tracker>(destroyedA);
+    auto trackerB = std::make_shared<Tracker>(destroyedB);
+
+    netman.registerService(serviceB, [trackerB, &callsB](packetptr_t) {
+        callsB++;
+    });
+    netman.registerService(serviceA, [trackerA, &netman, &callsA,
+                                      &aliveAfterUnregister](packetptr_t) {
+        callsA++;
+        netman.unregisterService(serviceA);
+        netman.unregisterService(serviceB);
+        aliveAfterUnregister = !trackerA->destroyed;
+    });
+    trackerA.reset();
+    trackerB.reset();
+
+    sendToService(netman, serviceA);
+    passed &= check(callsA == 1 && aliveAfterUnregister,
+                    "handler destroyed while running");
+    passed &= check(destroyedA && destroyedB,
+                    "unregistered handlers not destroyed after routing");
+
+    // Both services are gone
+    sendToService(netman, serviceA);
+    sendToService(netman, serviceB);
+    passed &= check(callsA == 1 && callsB == 0, "unregistered service called");
+    passed &= check(netman.getStats().dropped(DROP_REASON::NO_SERVICE) == 2,
+                    "packets to unregistered services not dropped");
+
+    // A handler replaces itself twice, the final replacement handles the
+    // next packet
+    bool destroyedC = false;
+    bool aliveAfterReplace = false;
+    size_t callsReplacement = 0;
+    auto trackerC = std::make_shared<Tracker>(destroyedC);
+    netman.registerService(serviceA, [trackerC, &netman, &callsReplacement,
+                                      &aliveAfterReplace](packetptr_t) {
+        for (size_t i = 0; i < 2; i++) {
+            netman.registerService(serviceA, [&callsReplacement](packetptr_t) {
+                callsReplacement++;
+            });
+        }
+        aliveAfterReplace = !trackerC->destroyed;
+    });
+    trackerC.reset();
+
+    sendToService(netman, serviceA);
+    passed &= check(aliveAfterReplace && destroyedC,
+                    "replaced handler destroyed while running");
+    sendToService(netman, serviceA);
+    passed &= check(callsReplacement == 1, "replacement handler not called");
+
+    // An empty callback removes the handler, so packets are dropped rather
+    // than calling it
+    netman.registerService(serviceA, PacketHandlerCb{});
+    sendToService(netman, serviceA);
+    passed &= check(callsReplacement == 1 &&
+                        netman.getStats().dropped(DROP_REASON::NO_SERVICE) ==
+                            3,
+                    "packet to an empty callback not dropped");
+
+    std::cout << (passed ? "PASSED" : "FAILED") << std::endl;
+    return passed ? 0 : 1;
+}
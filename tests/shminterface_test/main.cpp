@@ -0,0 +1,308 @@
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <librnp/default_packets/simplecommandpacket.h>
+#include <librnp/rnp_eventloop.h>
+#include <librnp/rnp_networkmanager.h>
+#include <librnp/rnp_routingtable.h>
+#include <librnp/rnp_shmring.h>
+#include <librnp/shminterface.h>
+#include "testCheck.h"
+
+static constexpr uint8_t nodeA = 10;
+static constexpr uint8_t nodeB = 11;
+static constexpr uint8_t shmID = 2;
+static constexpr uint8_t testService = 10;
+static constexpr size_t packetCount = 100;
+
+/// @brief Record header layout, as written by RnpShmRing
+struct RawRecord {
+    uint32_t size;
+    uint16_t payloadLength;
+    uint8_t senderLength;
+    uint8_t reserved;
+};
+
+/**
+ * @brief Write a record and overwrite its header in shared memory, as a
+ * faulty producer would
+ *
+ * @tparam F Callable taking the RawRecord to change
+ * @param[in] name Ring name
+ * @param[in] producer Producer with the ring open
+ * @param[in] corrupt Changes the record header
+ * @return true Record written and corrupted
+ */
+template <typename F>
+static bool writeCorrupt(const std::string &name, RnpShmRing &producer,
+                         F &&corrupt) {
+    // A unique sender marks the record in the mapping
+    const std::string sender = "corruptsender";
+    const std::vector<uint8_t> payload(16, 0xAA);
+    if (!producer.write(
+            RnpBufferView(reinterpret_cast<const uint8_t *>(sender.data()),
+                          sender.size()),
+            payload)) {
+        return false;
+    }
+
+    const int fd = ::shm_open(name.c_str(), O_RDWR, 0);
+    struct stat status;
+    if ((fd < 0) || (::fstat(fd, &status) != 0)) {
+        return false;
+    }
+    void *address = ::mmap(nullptr, status.st_size, PROT_READ | PROT_WRITE,
+                           MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (address == MAP_FAILED) {
+        return false;
+    }
+
+    uint8_t *bytes = static_cast<uint8_t *>(address);
+    bool found = false;
+    for (size_t i = sizeof(RawRecord); i + sender.size() <=
+                                       static_cast<size_t>(status.st_size);
+         i++) {
+        if (std::memcmp(bytes + i, sender.data(), sender.size()) == 0) {
+            RawRecord record;
+            std::memcpy(&record, bytes + i - sizeof(record), sizeof(record));
+            corrupt(record);
+            std::memcpy(bytes + i - sizeof(record), &record, sizeof(record));
+            found = true;
+            break;
+        }
+    }
+    ::munmap(address, status.st_size);
+    return found;
+}
+
+int main() {
+    bool passed = true;
+
+    // Unique names, so concurrent runs do not share rings
+    const std::string suffix = std::to_string(::getpid());
+    const std::string addressA = "shmtestA." + suffix;
+    const std::string addressB = "shmtestB." + suffix;
+
+    // Records of every size wrap around the ring in order, and a full ring
+    // rejects writes
+    {
+        RnpShmRing consumer;
+        RnpShmRing producer;
+        passed &= check(consumer.create("/rnp.shmtestring." + suffix, 0) &&
+                            producer.open("/rnp.shmtestring." + suffix),
+                        "ring not created");
+
+        const std::string sender = "sender";
+        const RnpBufferView senderView(
+            reinterpret_cast<const uint8_t *>(sender.data()), sender.size());
+        std::vector<uint8_t> payload(3000);
+        size_t written = 0;
+        size_t read = 0;
+        bool match = true;
+        for (size_t round = 0; round < 200; round++) {
+            for (size_t i = 0; i < 10; i++) {
+                const size_t size = 1 + (written * 37) % payload.size();
+                payload.assign(size, static_cast<uint8_t>(written));
+                passed &= check(producer.write(senderView, payload),
+                                "record not written");
+                written++;
+            }
+            consumer.read([&](const RnpBufferView from,
+                              const RnpBufferView record) {
+                const size_t size = 1 + (read * 37) % payload.size();
+                match &= (from.size() == sender.size()) &&
+                         (record.size() == size) &&
+                         (record[0] == static_cast<uint8_t>(read)) &&
+                         (record[size - 1] == static_cast<uint8_t>(read));
+                read++;
+                return true;
+            });
+        }
+        passed &= check(read == written && match, "records out of order");
+
+        // Fill the ring
+        payload.assign(1000, 0);
+        size_t accepted = 0;
+        while (producer.write(senderView, payload)) {
+            accepted++;
+        }
+        passed &= check(accepted > 0 && accepted < 200, "full ring accepted");
+        passed &= check(consumer.read([](const RnpBufferView,
+                                         const RnpBufferView) {
+            return true;
+        }) == accepted, "full ring not drained");
+
+        // Producers see the consumer close the ring
+        consumer.close();
+        passed &= check(producer.closed(), "closed ring not reported");
+    }
+
+    // Corrupt records are never handed out, and stop the ring being read
+    {
+        const std::string name = "/rnp.shmtestcorrupt." + suffix;
+        const std::vector<void (*)(RawRecord &)> corruptions = {
+            // Lengths larger than the record
+            [](RawRecord &record) { record.payloadLength = 60000; },
+            // Misaligned size
+            [](RawRecord &record) { record.size = 13; },
+            // Past the end of the ring
+            [](RawRecord &record) { record.size = 0x7FFFFFF8; },
+            // Padding past the end of the ring
+            [](RawRecord &record) { record.size = 0xFFFFFFF8; },
+        };
+        for (auto corruption : corruptions) {
+            RnpShmRing consumer;
+            RnpShmRing producer;
+            passed &= check(consumer.create(name, 0) && producer.open(name),
+                            "ring not created");
+            passed &= check(writeCorrupt(name, producer, corruption),
+                            "record not corrupted");
+            size_t delivered = 0;
+            consumer.read([&delivered](const RnpBufferView,
+                                       const RnpBufferView) {
+                delivered++;
+                return true;
+            });
+            passed &= check(delivered == 0 && consumer.corrupt(),
+                            "corrupt record read");
+
+            // Creating the ring again clears it
+            passed &= check(consumer.create(name, 0) && producer.closed() &&
+                                !consumer.corrupt() && consumer.empty(),
+                            "corrupt ring not replaced");
+        }
+    }
+
+    // Echo between two nodes, B running an event loop on its own thread
+    RnpNetworkManager netmanA(nodeA, NODETYPE::LEAF, false, 256, 64);
+    RnpNetworkManager netmanB(nodeB, NODETYPE::LEAF, false, 256, 64);
+    ShmInterface shmA(shmID, addressA, "shmA");
+    ShmInterface shmB(shmID, addressB, "shmB");
+    shmA.setup();
+    shmB.setup();
+    passed &= check(shmA.getInfo()->state && shmB.getInfo()->state,
+                    "rings not created");
+    ShmInterface invalid(shmID, "a/b");
+    invalid.setup();
+    passed &= check(invalid.getInfo()->error, "invalid address accepted");
+
+    netmanA.addInterface(&shmA);
+    netmanB.addInterface(&shmB);
+    netmanA.setRoutingBudget(0);
+    netmanB.setRoutingBudget(0);
+
+    // A knows the route to B, B learns the route back from received packets
+    RoutingTable table;
+    table.setRoute(nodeB, Route{shmID, 1, addressB});
+    netmanA.setRoutingTable(table);
+    netmanB.enableAutoRouteGen(true);
+
+    std::string lastSender;
+    netmanB.registerService(testService, [&](packetptr_t packet_ptr) {
+        lastSender = packet_ptr->header.lladdress.str();
+        SimpleCommandPacket reply(*packet_ptr);
+        RnpHeader::generateResponseHeader(packet_ptr->header, reply.header);
+        netmanB.sendPacket(reply);
+    });
+    RnpEventLoop loopB(netmanB);
+    std::thread threadB([&loopB] { loopB.run(); });
+
+    size_t received = 0;
+    int32_t argSum = 0;
+    RnpEventLoop loopA(netmanA);
+    netmanA.registerService(testService, [&](packetptr_t packet_ptr) {
+        SimpleCommandPacket reply(*packet_ptr);
+        argSum += reply.arg;
+        if (++received == packetCount) {
+            loopA.stop();
+        }
+    });
+
+    // Stop if the echo does not complete
+    loopA.addTimer(5000, [&loopA] { loopA.stop(); });
+
+    int32_t expectedSum = 0;
+    for (size_t i = 0; i < packetCount; i++) {
+        SimpleCommandPacket packet(1, static_cast<int32_t>(i));
+        packet.header.source = nodeA;
+        packet.header.destination = nodeB;
+        packet.header.source_service = testService;
+        packet.header.destination_service = testService;
+        netmanA.sendPacket(packet);
+        expectedSum += static_cast<int32_t>(i);
+    }
+    loopA.run();
+
+    loopB.stop();
+    threadB.join();
+
+    passed &= check(received == packetCount && argSum == expectedSum,
+                    "echo incomplete");
+    passed &= check(lastSender == addressA, "sender address not set");
+
+    // The event loop slept between wake ups rather than polling
+    const ShmInterfaceInfo *infoB =
+        static_cast<const ShmInterfaceInfo *>(shmB.getInfo());
+    passed &= check(infoB->wakeups > 0 && loopB.getUpdateCount() < 1000,
+                    "event loop not woken by the ring");
+
+    // Packets to an unknown peer are dropped
+    table.setRoute(nodeB, Route{shmID, 1, "shmtestmissing." + suffix});
+    netmanA.setRoutingTable(table);
+    SimpleCommandPacket lost(1, 0);
+    lost.header.source = nodeA;
+    lost.header.destination = nodeB;
+    netmanA.sendPacket(lost);
+    const ShmInterfaceInfo *infoA =
+        static_cast<const ShmInterfaceInfo *>(shmA.getInfo());
+    passed &= check(infoA->txDropped == 1, "packet to unknown peer sent");
+
+    // A corrupt record makes B create its ring again, after which producers
+    // reopen it and are received
+    {
+        RnpShmRing producer;
+        passed &= check(producer.open("/rnp." + addressB) &&
+                            writeCorrupt("/rnp." + addressB, producer,
+                                         [](RawRecord &record) {
+                                             record.senderLength = 255;
+                                         }),
+                        "record not corrupted");
+        shmB.update();
+        passed &= check(infoB->ringResets == 1 && producer.closed() &&
+                            shmB.getInfo()->state,
+                        "corrupt ring not reset");
+
+        SimpleCommandPacket packet(1, 0);
+        packet.header.source = nodeA;
+        packet.header.destination = nodeB;
+        packet.header.source_service = testService;
+        packet.header.destination_service = testService;
+        std::vector<uint8_t> bytes(1024);
+        const size_t length = packet.serialize(bytes.data(), bytes.size());
+        const std::string sender = "shmtestreset";
+        lastSender.clear();
+        passed &= check(
+            producer.open("/rnp." + addressB) &&
+                producer.write(
+                    RnpBufferView(
+                        reinterpret_cast<const uint8_t *>(sender.data()),
+                        sender.size()),
+                    RnpBufferView(bytes.data(), length)),
+            "reset ring not reopened");
+        shmB.update();
+        netmanB.update();
+        passed &= check(lastSender == sender, "reset ring not received");
+    }
+
+    std::cout << (passed ? "PASSED" : "FAILED") << std::endl;
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,165 @@
+#include <charconv>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <librnp/rnp_serializer.h>
+#include "allocationCounter.h"
+#include "testCheck.h"
+
+/**
+ * @brief Frame with every kind of number stringify handles
+ */
+struct NumberFrame {
+    static constexpr auto getSerializer() {
+        auto ret = RnpSerializer(&NumberFrame::count, &NumberFrame::ratio,
+                                 &NumberFrame::precise, &NumberFrame::armed,
+                                 &NumberFrame::state, &NumberFrame::offset);
+        return ret;
+    }
+
+    int32_t count;
+    float ratio;
+    double precise;
+    bool armed;
+    uint8_t state;
+    int64_t offset;
+};
+
+using NumberSerializer = decltype(NumberFrame::getSerializer());
+
+/**
+ * @brief Format a floating point value as stringify should
+ *
+ * @tparam T Floating point type
+ * @param[in] value Value
+ * @return std::string Shortest round trip form, or the snprintf form if
+ * floating point std::to_chars is not used
+ */
+template <typename T>
+static std::string expectedFloat(const T value) {
+#if defined(__cpp_lib_to_chars) && !defined(RNP_NO_FLOAT_TO_CHARS)
+    char buf[64];
+    return std::string(buf, std::to_chars(buf, buf + sizeof(buf), value).ptr);
+#else
+    char buf[64];
+    const int length =
+        std::snprintf(buf, sizeof(buf), "%.*g",
+                      std::numeric_limits<T>::max_digits10,
+                      static_cast<double>(value));
+    return std::string(buf, length);
+#endif
+}
+
+/**
+ * @brief Split a csv line into its fields, dropping the trailing separator
+ */
+static std::vector<std::string> splitFields(const std::string &line) {
+    std::vector<std::string> fields;
+    size_t start = 0;
+    for (size_t i = 0; i < line.size(); i++) {
+        if (line[i] == ',') {
+            fields.push_back(line.substr(start, i - start));
+            start = i + 1;
+        }
+    }
+    return fields;
+}
+
+int main() {
+    bool passed = true;
+    const NumberSerializer serializer = NumberFrame::getSerializer();
+
+    NumberFrame frame;
+    frame.count = -42;
+    frame.ratio = 1.0f / 3.0f;
+    frame.precise = 0.1;
+    frame.armed = true;
+    frame.state = 255;
+    frame.offset = std::numeric_limits<int64_t>::min();
+
+    // Every element is followed by a separator, including the last
+    const std::string expected = "-42," + expectedFloat(frame.ratio) + "," +
+                                 expectedFloat(frame.precise) +
+                                 ",1,255,-9223372036854775808,";
+    std::vector<char> buf(NumberSerializer::max_string_size());
+    const size_t length = serializer.stringifyInto(frame, buf.data(), buf.size());
+    const std::string line(buf.data(), length);
+    passed &= check(line == expected, "unexpected csv");
+
+#if defined(__cpp_lib_to_chars) && !defined(RNP_NO_FLOAT_TO_CHARS)
+    passed &= check(expectedFloat(0.1f) == "0.1" && expectedFloat(2.5) == "2.5",
+                    "floating point not in shortest form");
+#else
+    passed &= check(expectedFloat(0.1f) == "0.100000001",
+                    "floating point not in snprintf form");
+#endif
+
+    // Floating point values read back to the same value
+    const std::vector<std::string> fields = splitFields(line);
+    passed &= check(fields.size() == 6 &&
+                        std::strtof(fields[1].c_str(), nullptr) ==
+                            frame.ratio &&
+                        std::strtod(fields[2].c_str(), nullptr) ==
+                            frame.precise,
+                    "floating point does not round trip");
+
+    // The worst case of every element fits
+    frame.count = std::numeric_limits<int32_t>::min();
+    frame.ratio = -std::numeric_limits<float>::denorm_min();
+    frame.precise = -std::numeric_limits<double>::min();
+    const size_t worst =
+        serializer.stringifyInto(frame, buf.data(), buf.size());
+    passed &= check(worst > 0 && worst <= buf.size() &&
+                        buf[worst - 1] == ',',
+                    "worst case does not fit");
+
+    // Too small a buffer for the worst case writes nothing
+    passed &= check(serializer.stringifyInto(frame, buf.data(),
+                                             buf.size() - 1) == 0,
+                    "short buffer written to");
+
+    // stringify() appends to the string
+    frame.count = -42;
+    frame.ratio = 1.0f / 3.0f;
+    frame.precise = 0.1;
+    frame.offset = std::numeric_limits<int64_t>::min();
+    std::string out = "header,";
+    serializer.stringify(frame, out);
+    passed &= check(out == "header," + expected, "stringify not appended");
+
+    // Batches end every line with the terminator
+    std::vector<NumberFrame> frames(3, frame);
+    out.clear();
+    serializer.stringify_batch(frames.begin(), frames.end(), out);
+    passed &= check(out == expected + "\n" + expected + "\n" + expected + "\n",
+                    "batch lines not terminated");
+    out.clear();
+    serializer.stringify_batch(frames.begin(), frames.end(), out, ';');
+    passed &= check(out == expected + ";" + expected + ";" + expected + ";",
+                    "batch terminator not used");
+    out.clear();
+    serializer.stringify_batch(frames.begin(), frames.begin(), out);
+    passed &= check(out.empty(), "empty batch wrote a line");
+
+    // Nothing is allocated once the string has grown
+    out.clear();
+    serializer.stringify_batch(frames.begin(), frames.end(), out);
+    serializer.stringify(frame, out);
+    const size_t allocations = allocationCount;
+    for (size_t i = 0; i < 1000; i++) {
+        out.clear();
+        frames[0].count = static_cast<int32_t>(i);
+        serializer.stringify_batch(frames.begin(), frames.end(), out);
+        serializer.stringify(frame, out);
+        serializer.stringifyInto(frame, buf.data(), buf.size());
+    }
+    passed &= check(allocationCount == allocations, "warm stringify allocated");
+
+    std::cout << (passed ? "PASSED" : "FAILED") << std::endl;
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,197 @@
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <librnp/default_packets/simplecommandpacket.h>
+#include <librnp/rnp_networkmanager.h>
+#include <librnp/rnp_routingtable.h>
+#include <librnp/udpinterface.h>
+#include "testCheck.h"
+
+static constexpr uint8_t nodeA = 10;
+static constexpr uint8_t nodeB = 11;
+static constexpr uint8_t udpID = 2;
+static constexpr uint8_t testService = 10;
+static constexpr size_t packetCount = 50;
+static constexpr size_t batchSize = 32;
+
+// Update a node until a condition holds, datagrams over loopback may take a
+// moment to arrive
+template <typename F>
+static bool updateUntil(RnpNetworkManager &netman, F condition) {
+    for (size_t i = 0; i < 100000 && !condition(); i++) {
+        netman.update();
+    }
+    return condition();
+}
+
+int main() {
+    bool passed = true;
+
+    // Address parsing
+    sockaddr_in parsed{};
+    passed &= check(UdpInterface::parseAddress("127.0.0.1:7777", parsed) &&
+                        parsed.sin_port == htons(7777),
+                    "valid address not parsed");
+    passed &= check(!UdpInterface::parseAddress("127.0.0.1", parsed) &&
+                        !UdpInterface::parseAddress("127.0.0.1:", parsed) &&
+                        !UdpInterface::parseAddress("1.2.3.4:70000", parsed) &&
+                        !UdpInterface::parseAddress("localhost:1", parsed),
+                    "malformed address parsed");
+
+    // Two nodes linked over 127.0.0.1
+    RnpNetworkManager netmanA(nodeA, NODETYPE::LEAF, false, 256, 64);
+    RnpNetworkManager netmanB(nodeB, NODETYPE::LEAF, false, 256, 64);
+    UdpInterface udpA(udpID, "127.0.0.1:0", "udpA", batchSize);
+    UdpInterface udpB(udpID, "127.0.0.1:0", "udpB", batchSize);
+    udpA.setup();
+    udpB.setup();
+    passed &= check(udpA.getInfo()->state && udpB.getInfo()->state &&
+                        udpA.getPort() != 0 && udpB.getPort() != 0,
+                    "sockets not bound");
+
+    netmanA.addInterface(&udpA);
+    netmanB.addInterface(&udpB);
+    netmanA.setRoutingBudget(0);
+    netmanB.setRoutingBudget(0);
+
+    const std::string addressA = "127.0.0.1:" + std::to_string(udpA.getPort());
+    const std::string addressB = "127.0.0.1:" + std::to_string(udpB.getPort());
+
+    // A knows the route to B, B learns the route back from received packets
+    RoutingTable table;
+    table.setRoute(nodeB, Route{udpID, 1, addressB});
+    netmanA.setRoutingTable(table);
+    netmanB.enableAutoRouteGen(true);
+
+    // B echoes every packet back to its source
+    size_t receivedB = 0;
+    std::string lastSender;
+    netmanB.registerService(testService, [&](packetptr_t packet_ptr) {
+        receivedB++;
+        lastSender = packet_ptr->header.lladdress.str();
+
+        SimpleCommandPacket reply(*packet_ptr);
+        RnpHeader::generateResponseHeader(packet_ptr->header, reply.header);
+        netmanB.sendPacket(reply);
+    });
+
+    size_t receivedA = 0;
+    int32_t argSum = 0;
+    netmanA.registerService(testService, [&](packetptr_t packet_ptr) {
+        SimpleCommandPacket reply(*packet_ptr);
+        receivedA++;
+        argSum += reply.arg;
+    });
+
+    // Queue a burst of packets, which are transmitted when A is flushed
+    int32_t expectedSum = 0;
+    for (size_t i = 0; i < packetCount; i++) {
+        SimpleCommandPacket packet(1, static_cast<int32_t>(i));
+        packet.header.source = nodeA;
+        packet.header.destination = nodeB;
+        packet.header.source_service = testService;
+        packet.header.destination_service = testService;
+        netmanA.sendPacket(packet);
+        expectedSum += static_cast<int32_t>(i);
+    }
+    netmanA.update();
+
+    const UdpInterfaceInfo *infoA =
+        static_cast<const UdpInterfaceInfo *>(udpA.getInfo());
+    const UdpInterfaceInfo *infoB =
+        static_cast<const UdpInterfaceInfo *>(udpB.getInfo());
+    passed &= check(infoA->txBatches ==
+                        (packetCount + batchSize - 1) / batchSize,
+                    "burst not sent in full batches");
+
+    passed &= check(
+        updateUntil(netmanB, [&] { return receivedB == packetCount; }),
+        "packets not received by B");
+    passed &= check(infoB->rxBatches < packetCount,
+                    "packets not received in batches");
+    passed &= check(lastSender == addressA, "sender address not recorded");
+
+    passed &= check(
+        updateUntil(netmanA, [&] { return receivedA == packetCount; }),
+        "replies not received by A");
+    passed &= check(argSum == expectedSum, "reply contents mismatch");
+
+    // Packets larger than the MTU, or to a malformed address, are dropped
+    UdpInterface small(3, "127.0.0.1:0", "small", 4, 12);
+    small.setup();
+    small.setDefaultPeer(addressB);
+    SimpleCommandPacket packet(1, 2);
+    small.sendPacket(packet);
+    packet.header.lladdress = "not an address";
+    small.sendPacket(packet);
+    small.flush();
+    const UdpInterfaceInfo *infoSmall =
+        static_cast<const UdpInterfaceInfo *>(small.getInfo());
+    passed &= check(infoSmall->txDropped == 2 && infoSmall->txBatches == 0,
+                    "invalid packets not dropped");
+
+    // A full packet buffer drops the rest of the batch, and every packet is
+    // accounted for
+    {
+        RnpNetworkManager netmanFull(nodeB, NODETYPE::LEAF, false, 4);
+        UdpInterface udpFull(udpID, "127.0.0.1:0", "full", batchSize);
+        udpFull.setup();
+        netmanFull.addInterface(&udpFull);
+        netmanFull.setRoutingBudget(0);
+        size_t delivered = 0;
+        netmanFull.registerService(testService,
+                                   [&delivered](packetptr_t) { delivered++; });
+
+        udpA.setDefaultPeer("127.0.0.1:" + std::to_string(udpFull.getPort()));
+        for (size_t i = 0; i < 20; i++) {
+            SimpleCommandPacket burst(1, 0);
+            burst.header.source = nodeA;
+            burst.header.destination = nodeB;
+            burst.header.destination_service = testService;
+            udpA.sendPacket(burst);
+        }
+        udpA.flush();
+
+        const UdpInterfaceInfo *infoFull =
+            static_cast<const UdpInterfaceInfo *>(udpFull.getInfo());
+        const auto accounted = [&] {
+            return delivered + infoFull->rxDropped +
+                   netmanFull.getStats().dropped(DROP_REASON::BUFFER_FULL);
+        };
+        passed &= check(updateUntil(netmanFull, [&] {
+                            return accounted() == 20;
+                        }) && infoFull->rxDropped > 0,
+                        "packets lost from a batch without being counted");
+        netmanFull.removeInterface(&udpFull);
+    }
+
+    // Senders on many ports do not grow the address caches without bound
+    {
+        const size_t baseline = RnpLinkAddress::internedCount();
+        SimpleCommandPacket probe(1, 0);
+        std::vector<uint8_t> bytes;
+        probe.serialize(bytes);
+
+        sockaddr_in target{};
+        UdpInterface::parseAddress(addressB, target);
+        for (size_t i = 0; i < 600; i++) {
+            // A fresh socket, so each datagram has its own source port
+            const int fd = ::socket(AF_INET, SOCK_DGRAM, 0);
+            ::sendto(fd, bytes.data(), bytes.size(), 0,
+                     reinterpret_cast<const sockaddr *>(&target),
+                     sizeof(target));
+            ::close(fd);
+            netmanB.update();
+        }
+        passed &= check(RnpLinkAddress::internedCount() <= baseline + 512,
+                        "sender addresses not bounded");
+    }
+
+    std::cout << (passed ? "PASSED" : "FAILED") << std::endl;
+    return passed ? 0 : 1;
+}